@@ -19,6 +19,7 @@
 
 #if CZICHECK_XERCESC_AVAILABLE
 #include <xercesc/util/PlatformUtils.hpp>
+#include "checkers/checkerXmlMetadataXsdSchema.h"
 XERCES_CPP_NAMESPACE_USE
 #endif
 
@@ -90,6 +91,7 @@ int main(int argc, char** argv)
     }
 
 #if CZICHECK_XERCESC_AVAILABLE
+    ReleaseZenCompleteXsdGrammarPool();
     XMLPlatformUtils::Terminate();
 #endif
 #if CZICHECK_WIN32_ENVIRONMENT
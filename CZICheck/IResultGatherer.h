@@ -6,11 +6,13 @@
 
 #include <cstdint>
 #include <string>
+#include <variant>
+#include <vector>
 #include "checks.h"
 
 /// This interface defines methods for reporting findings. It is to be used with the checkers, which
 /// perform various checks on a CZI document.
-/// Call sequence (per checker) must be: StartCheck(check) -> zero or more ReportFinding(..) -> FinishCheck(check).
+/// Call sequence (per checker) must be: StartCheck(check) -> zero or more ReportFinding(..) or ReportStatistics(..) -> FinishCheck(check).
 /// Preconditions:
 /// - Only one checker interacts with the gatherer at a time (no concurrent calls).
 /// - The `finding.check` value passed to ReportFinding must match the currently active checker.
@@ -62,6 +64,33 @@ public:
         std::string details;
     };
 
+    /// The value of a cell in a statistics table - either a string, an integer or a floating point number.
+    using StatisticsValue = std::variant<std::string, std::int64_t, double>;
+
+    /// Represents a table of statistics emitted by a checker. Statistics are supplementary information
+    /// (e.g. counters or timings gathered while running a check) and do not contribute to the result of a check.
+    /// - `check`: identifies the checker emitting the statistics (must match the active checker).
+    /// - `name`: a short human-readable caption of the table.
+    /// - `columns`: the column headers.
+    /// - `rows`: the rows of the table, each row is expected to have as many cells as there are columns.
+    struct StatisticsTable
+    {
+        /// Checker that emitted the statistics; must match the currently active checker when reporting.
+        explicit StatisticsTable(CZIChecks check) :check(check) {}
+
+        /// Checker identifier associated with this table.
+        CZIChecks   check;
+
+        /// Short human-readable caption of the table.
+        std::string name;
+
+        /// The column headers.
+        std::vector<std::string> columns;
+
+        /// The rows of the table.
+        std::vector<std::vector<StatisticsValue>> rows;
+    };
+
     /// Begins reporting for the specified checker. Must be called before any findings
     /// for this checker and must not be invoked while another checker is active.
     virtual void StartCheck(CZIChecks check) = 0;
@@ -71,6 +100,10 @@ public:
     /// enabling fail-fast behavior when needed.
     [[nodiscard]] virtual ReportFindingResult ReportFinding(const Finding& finding) = 0;
 
+    /// Reports a table of statistics for the currently active checker. Statistics are only
+    /// to be reported if this was requested (c.f. 'CheckerCreateInfo::collectStatistics').
+    virtual void ReportStatistics(const StatisticsTable& statistics) = 0;
+
     /// Marks the end of reporting for the specified checker. Must be called exactly once
     /// after all findings for that checker have been reported.
     virtual void FinishCheck(CZIChecks check) = 0;
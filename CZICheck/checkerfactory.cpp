@@ -9,6 +9,7 @@
 #include "checkerfactory.h"
 #include "checkers/checkerSubBlkDirPositions.h"
 #include "checkers/checkerSubBlkSegmentsValid.h"
+#include "checkers/checkerAttachmentDirPositions.h"
 #include "checkers/checkerConsistentCoordinates.h"
 #include "checkers/checkerDuplicateCoordinates.h"
 #include "checkers/checkerBenabled.h"
@@ -21,6 +22,16 @@
 #include "checkers/checkerOverlappingScenes.h"
 #include "checkers/checkerSubBlkBitmapValid.h"
 #include "checkers/checkerTopographyApplianceValidation.h"
+#include "checkers/checkerSubBlkPixelContent.h"
+#include "checkers/checkerComponentBitCountContent.h"
+#include "checkers/checkerDuplicateSubBlockContent.h"
+#include "checkers/checkerPyramidContent.h"
+#include "checkers/checkerTileOverlap.h"
+#include "checkers/checkerConsistentMIndex.h"
+#include "checkers/checkerSegmentExtents.h"
+#include "checkers/checkerFileLayout.h"
+#include "checkers/checkerPyramidCompleteness.h"
+#include "checkers/checkerSubBlockSizeDistribution.h"
 
 using namespace std;
 
@@ -88,6 +99,7 @@ static const classEntry classesList[] =
     MakeEntry<CCheckConsistentCoordinates>(),
     MakeEntry<CCheckSubBlkDirPositions>(),
     MakeEntry<CCheckSubBlkSegmentsValid>(true), // we make this "opt-in" because "CCheckSubBlkBitmapValid" includes the same check (and is more extensive)
+    MakeEntry<CCheckAttachmentDirPositions>(true),  // opt-in because it reads the attachment-directory and the attachment-segment headers from the file
     MakeEntry<CCheckDuplicateCoordinates>(),
     MakeEntry<CCheckBenabled>(),
     MakeEntry<CCheckSamePixeltypePerChannel>(),
@@ -101,6 +113,16 @@ static const classEntry classesList[] =
 #endif
     MakeEntry<CCheckOverlappingScenesOnLayer0>(),
     MakeEntry<CCheckSubBlkBitmapValid>(),
+    MakeEntry<CCheckSubBlkPixelContent>(true),  // opt-in because it requires reading and decoding all data
+    MakeEntry<CCheckComponentBitCountContent>(true),  // opt-in because it requires decoding (a sample of) the data
+    MakeEntry<CCheckDuplicateSubBlockContent>(true),  // opt-in because it requires reading all data
+    MakeEntry<CCheckPyramidContent>(true),  // opt-in because it requires decoding (a sample of) the data
+    MakeEntry<CCheckTileOverlap>(true),  // opt-in because overlapping tiles are common in mosaics, and the threshold is application specific
+    MakeEntry<CCheckConsistentMIndex>(true),  // opt-in because gaps in the M-indices are not forbidden by the specification
+    MakeEntry<CCheckSegmentExtents>(true),  // opt-in because it requires reading the header of every segment
+    MakeEntry<CCheckFileLayout>(true),  // opt-in because it is an analysis of the read performance, not of the validity of the document
+    MakeEntry<CCheckPyramidCompleteness>(true),  // opt-in because a pyramid is not required by the specification
+    MakeEntry<CCheckSubBlockSizeDistribution>(true),  // opt-in because suitable tile sizes are application specific
 };
 
 /*static*/std::unique_ptr<IChecker> CCheckerFactory::CreateChecker(
@@ -10,6 +10,9 @@
 #include "resultgatherer.h"
 #include "checks.h"
 #include "IChecker.h"
+#include "subblockmanifest.h"
+#include "memorygovernor.h"
+#include "metadataindex.h"
 
 /// Additional information passed to a checked (i.e. besides the CZI-reader object).
 /// Those pieces of information may be checker specific (i.e. only useful for specific
@@ -27,6 +30,42 @@ struct CheckerCreateInfo
     /// The size of the CZI-file in bytes. A value of 0 means "file size is unknown" (and this could happen
     /// if we allow for other streams than files).
     std::uint64_t totalFileSize{ 0 };
+
+    /// The stream the CZI-reader is operating on. This gives checkers access to the raw content of the file,
+    /// e.g. in order to inspect a segment without having to load it as a whole. May be null.
+    std::shared_ptr<libCZI::IStream> stream;
+
+    /// Whether checkers should gather statistics (e.g. counters and timings) and report them
+    /// with 'IResultGathererReport::ReportStatistics'.
+    bool collectStatistics{ false };
+
+    /// If non-null, checkers reading the subblock data add the hash of the data to this manifest (and the
+    /// manifest compares it against the reference manifest, if one is given).
+    std::shared_ptr<CSubBlockManifest> manifest;
+
+    /// The maximum "decode amplification" (i.e. the sum of the tile areas divided by the area covered by them) of
+    /// the tiles within a scene and a plane, above which the checker 'tileoverlap' reports a warning.
+    double maxDecodeAmplification{ 1.5 };
+
+    /// The minimum tile size (the larger of width and height in pixels), below which the checker 'subblksizes'
+    /// considers a subblock to be "tiny".
+    std::uint32_t minTileSize{ 128 };
+
+    /// The maximum tile size (the larger of width and height in pixels), above which the checker 'subblksizes'
+    /// reports a subblock.
+    std::uint32_t maxTileSize{ 16384 };
+
+    /// The directory for temporary files (e.g. of the external sort used by the checker 'subblkcoordsunique'). If
+    /// empty, the system's directory for temporary files is used.
+    std::wstring tempDirectory;
+
+    /// The memory governor, which large allocations (e.g. decode buffers or snapshots of the subblock-directory)
+    /// are to be reserved with. May be null, in which case there is no limit.
+    std::shared_ptr<CMemoryGovernor> memoryGovernor;
+
+    /// The cache for the index over the XML-metadata, so that the metadata-segment is read and parsed only once
+    /// for all checkers examining the XML-metadata. May be null, in which case each checker creates the index itself.
+    std::shared_ptr<CMetadataIndexCache> metadataIndexCache;
 };
 
 /// Factory for creating checker instances.
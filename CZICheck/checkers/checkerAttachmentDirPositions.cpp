@@ -0,0 +1,232 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "checkerAttachmentDirPositions.h"
+#include <algorithm>
+#include <exception>
+#include <sstream>
+#include <memory>
+#include <string>
+
+using namespace libCZI;
+using namespace std;
+
+namespace
+{
+    // The headers of attachment-segments are read with a single read-operation as long as the range to be read
+    //  does not exceed this size - so that the (usually small) gaps between adjacent attachment-segments are read
+    //  along, instead of issuing a separate read-operation for each segment.
+    constexpr uint64_t kMaxBatchedReadSize = 64 * 1024;
+}
+
+/*static*/const char* CCheckAttachmentDirPositions::kDisplayName = "Attachment-Segments in AttachmentDirectory within file and valid";
+/*static*/const char* CCheckAttachmentDirPositions::kShortName = "attachmentsegmentsvalid";
+
+CCheckAttachmentDirPositions::CCheckAttachmentDirPositions(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    IResultGathererReport& result_gatherer,
+    const CheckerCreateInfo& additional_info) :
+    CCheckerBase(reader, result_gatherer, additional_info)
+{
+}
+
+void CCheckAttachmentDirPositions::RunCheck()
+{
+    this->result_gatherer_.StartCheck(CCheckAttachmentDirPositions::kCheckType);
+
+    this->RunCheckDefaultExceptionHandling([this]()
+        {
+            if (!this->additional_info_.stream)
+            {
+                return;
+            }
+
+            uint64_t attachment_directory_position;
+            vector<CSegmentReader::AttachmentEntry> entries;
+            try
+            {
+                attachment_directory_position = static_cast<uint64_t>(CSegmentReader::ReadFileHeaderInfo(this->additional_info_.stream.get()).attachmentDirectoryPosition);
+                if (attachment_directory_position == 0)
+                {
+                    // there is no attachment-directory in this file
+                    return;
+                }
+
+                if (this->additional_info_.totalFileSize > 0 && attachment_directory_position >= this->additional_info_.totalFileSize)
+                {
+                    ostringstream string_stream;
+                    string_stream << "position of the attachment-directory (=" << attachment_directory_position << ") is beyond filesize (=" << this->additional_info_.totalFileSize << ")";
+                    this->ReportFatal(string_stream.str(), string());
+                    return;
+                }
+
+                entries = CSegmentReader::ReadAttachmentDirectory(this->additional_info_.stream.get(), attachment_directory_position, this->additional_info_.totalFileSize);
+            }
+            catch (exception& ex)
+            {
+                this->ReportFatal("The attachment-directory is invalid", ex.what());
+                return;
+            }
+
+            this->CheckAgainstReader(entries);
+            this->CheckAttachmentSegments(entries);
+        });
+
+    this->result_gatherer_.FinishCheck(CCheckAttachmentDirPositions::kCheckType);
+}
+
+void CCheckAttachmentDirPositions::CheckAgainstReader(const std::vector<CSegmentReader::AttachmentEntry>& entries)
+{
+    vector<AttachmentInfo> attachments_from_reader;
+    this->reader_->EnumerateAttachments(
+        [&](int, const AttachmentInfo& info)->bool
+        {
+            attachments_from_reader.emplace_back(info);
+            return true;
+        });
+
+    if (attachments_from_reader.size() != entries.size())
+    {
+        IResultGatherer::Finding finding(CCheckAttachmentDirPositions::kCheckType);
+        finding.severity = IResultGatherer::Severity::Warning;
+        ostringstream string_stream;
+        string_stream << "the attachment-directory contains " << entries.size() << " entries, but the reader reports " << attachments_from_reader.size() << " attachments";
+        finding.information = string_stream.str();
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+    }
+
+    const size_t count = min(attachments_from_reader.size(), entries.size());
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto& entry = entries[i];
+        const auto& info = attachments_from_reader[i];
+        if (entry.name != info.name ||
+            entry.contentFileType != string(info.contentFileType) ||
+            !CCheckAttachmentDirPositions::IsSameGuid(entry.contentGuid, info.contentGuid))
+        {
+            IResultGatherer::Finding finding(CCheckAttachmentDirPositions::kCheckType);
+            finding.severity = IResultGatherer::Severity::Warning;
+            ostringstream string_stream;
+            string_stream << "entry #" << i << " of the attachment-directory differs from the attachment reported by the reader";
+            finding.information = string_stream.str();
+            string_stream = ostringstream();
+            string_stream << "attachment-directory: name=\"" << entry.name << "\", type=\"" << entry.contentFileType << "\"; reader: name=\"" << info.name << "\", type=\"" << info.contentFileType << "\"";
+            finding.details = string_stream.str();
+            this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        }
+    }
+}
+
+void CCheckAttachmentDirPositions::CheckAttachmentSegments(const std::vector<CSegmentReader::AttachmentEntry>& entries)
+{
+    const uint64_t total_file_size = this->additional_info_.totalFileSize;
+    vector<AttachmentToExamine> attachments;
+    attachments.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const auto& entry = entries[i];
+        if (entry.filePart != 0)
+        {
+            continue;
+        }
+
+        if (entry.filePosition < 0 || (total_file_size > 0 && static_cast<uint64_t>(entry.filePosition) >= total_file_size))
+        {
+            ostringstream string_stream;
+            string_stream << "position of attachment #" << i << " (=" << entry.filePosition << ") is beyond filesize (=" << total_file_size << ")";
+            this->ReportFatal(string_stream.str(), string());
+            continue;
+        }
+
+        if (total_file_size > 0 && static_cast<uint64_t>(entry.filePosition) + CSegmentReader::kAttachmentSegmentHeaderReadSize > total_file_size)
+        {
+            ostringstream string_stream;
+            string_stream << "the attachment-segment of attachment #" << i << " (at position " << entry.filePosition << ") is truncated";
+            this->ReportFatal(string_stream.str(), string());
+            continue;
+        }
+
+        attachments.emplace_back(AttachmentToExamine{ static_cast<int>(i), static_cast<uint64_t>(entry.filePosition) });
+    }
+
+    // visit the attachment-segments in the order of their file-position (the order in the attachment-directory is arbitrary)
+    sort(
+        attachments.begin(),
+        attachments.end(),
+        [](const AttachmentToExamine& a, const AttachmentToExamine& b)->bool
+        {
+            return a.filePosition < b.filePosition || (a.filePosition == b.filePosition && a.index < b.index);
+        });
+
+    vector<uint64_t> positions;
+    positions.reserve(attachments.size());
+    for (const auto& attachment : attachments)
+    {
+        positions.emplace_back(attachment.filePosition);
+    }
+
+    CSegmentReader::ReadBatched(
+        this->additional_info_.stream.get(),
+        positions,
+        CSegmentReader::kAttachmentSegmentHeaderReadSize,
+        kMaxBatchedReadSize,
+        [&](size_t i, const uint8_t* header, const char* error_message)
+        {
+            const auto& attachment = attachments[i];
+            if (header == nullptr)
+            {
+                ostringstream string_stream;
+                string_stream << "the attachment-segment of attachment #" << attachment.index << " (at position " << attachment.filePosition << ") could not be read";
+                this->ReportFatal(string_stream.str(), error_message);
+                return;
+            }
+
+            this->CheckAttachmentSegment(entries[attachment.index], attachment.index, header);
+        });
+}
+
+void CCheckAttachmentDirPositions::CheckAttachmentSegment(const CSegmentReader::AttachmentEntry& entry, int index, const std::uint8_t* header)
+{
+    CSegmentReader::AttachmentSegmentInfo segment_info;
+    try
+    {
+        segment_info = CSegmentReader::ParseAttachmentSegmentInfo(header, entry.filePosition, this->additional_info_.totalFileSize);
+    }
+    catch (exception& ex)
+    {
+        ostringstream string_stream;
+        string_stream << "the attachment-segment of attachment #" << index << " is invalid";
+        this->ReportFatal(string_stream.str(), ex.what());
+        return;
+    }
+
+    if (segment_info.entry.name != entry.name ||
+        segment_info.entry.contentFileType != entry.contentFileType ||
+        !CCheckAttachmentDirPositions::IsSameGuid(segment_info.entry.contentGuid, entry.contentGuid))
+    {
+        IResultGatherer::Finding finding(CCheckAttachmentDirPositions::kCheckType);
+        finding.severity = IResultGatherer::Severity::Warning;
+        ostringstream string_stream;
+        string_stream << "the entry in the attachment-segment of attachment #" << index << " differs from the entry in the attachment-directory";
+        finding.information = string_stream.str();
+        string_stream = ostringstream();
+        string_stream << "attachment-directory: name=\"" << entry.name << "\", type=\"" << entry.contentFileType << "\"; attachment-segment: name=\"" << segment_info.entry.name << "\", type=\"" << segment_info.entry.contentFileType << "\"";
+        finding.details = string_stream.str();
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+    }
+}
+
+void CCheckAttachmentDirPositions::ReportFatal(const std::string& information, const std::string& details)
+{
+    IResultGatherer::Finding finding(CCheckAttachmentDirPositions::kCheckType);
+    finding.severity = IResultGatherer::Severity::Fatal;
+    finding.information = information;
+    finding.details = details;
+    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+}
+
+/*static*/bool CCheckAttachmentDirPositions::IsSameGuid(const libCZI::GUID& a, const libCZI::GUID& b)
+{
+    return a.Data1 == b.Data1 && a.Data2 == b.Data2 && a.Data3 == b.Data3 && equal(a.Data4, a.Data4 + 8, b.Data4);
+}
@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "checkerbase.h"
+#include "../segmentreader.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// This checker checks whether the attachment's file-positions (retrieved from the attachment-directory)
+/// are within the file, and whether there is a valid attachment-segment at this location. Only the
+/// header of the attachment-segments is read (i.e. not the attachment's data) - it is checked that the
+/// segment-id is correct and that the sizes given in the header are consistent (and within the file).
+/// In addition, the entries in the attachment-directory are compared with the attachments reported by
+/// the reader, and with the entry contained in the attachment-segment.
+/// The attachment-segments are visited in the order of their file-position, and the headers of
+/// attachment-segments which are close to each other are read with a single read-operation.
+/// Pathologies:
+/// - if the stream is not available, then this test does nothing
+/// - if the filesize is unknown, then the positions are only checked by trying to read the segments
+/// - attachments located in a different file-part are not checked
+class CCheckAttachmentDirPositions : public IChecker, CCheckerBase
+{
+private:
+    /// An attachment-segment to be examined.
+    struct AttachmentToExamine
+    {
+        int index;                  ///< The index of the attachment (in the attachment-directory).
+        std::uint64_t filePosition; ///< The file-position of the attachment-segment.
+    };
+public:
+    static const CZIChecks kCheckType = CZIChecks::AttachmentDirectoryPositionsWithinRange;
+    static const char* kDisplayName;
+    static const char* kShortName;
+
+    CCheckAttachmentDirPositions(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        IResultGathererReport& result_gatherer,
+        const CheckerCreateInfo& additional_info);
+    void RunCheck() override;
+private:
+    void CheckAgainstReader(const std::vector<CSegmentReader::AttachmentEntry>& entries);
+    void CheckAttachmentSegments(const std::vector<CSegmentReader::AttachmentEntry>& entries);
+    void CheckAttachmentSegment(const CSegmentReader::AttachmentEntry& entry, int index, const std::uint8_t* header);
+    void ReportFatal(const std::string& information, const std::string& details);
+    static bool IsSameGuid(const libCZI::GUID& a, const libCZI::GUID& b);
+};
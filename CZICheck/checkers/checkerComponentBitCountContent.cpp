@@ -0,0 +1,264 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "checkerComponentBitCountContent.h"
+#include <exception>
+#include <sstream>
+#include <memory>
+
+using namespace libCZI;
+using namespace std;
+
+/*static*/const char* CCheckComponentBitCountContent::kDisplayName = "check that the pixel values fit the ComponentBitCount given in metadata";
+/*static*/const char* CCheckComponentBitCountContent::kShortName = "componentbitcountcontent";
+
+namespace
+{
+    /// The maximum number of subblocks per channel which are decoded. If a channel has more subblocks,
+    /// then a sample of this size is examined.
+    constexpr size_t kMaxNumberOfSubBlocksPerChannel = 64;
+}
+
+CCheckComponentBitCountContent::CCheckComponentBitCountContent(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    IResultGathererReport& result_gatherer,
+    const CheckerCreateInfo& additional_info) :
+    CCheckerBase(reader, result_gatherer, additional_info)
+{
+}
+
+void CCheckComponentBitCountContent::RunCheck()
+{
+    this->result_gatherer_.StartCheck(CCheckComponentBitCountContent::kCheckType);
+
+    this->RunCheckDefaultExceptionHandling([this]()
+        {
+            this->GetComponentBitCountsFromMetadata();
+            if (!this->channels_.empty())
+            {
+                this->DetermineSubBlocksToExamine();
+                this->ExamineSubBlocks();
+                this->ReportFindings();
+            }
+        });
+
+    if (this->additional_info_.collectStatistics)
+    {
+        this->ReportStatistics();
+    }
+
+    this->result_gatherer_.FinishCheck(CCheckComponentBitCountContent::kCheckType);
+}
+
+void CCheckComponentBitCountContent::GetComponentBitCountsFromMetadata()
+{
+    // Problems with the metadata (e.g. no metadata present, or invalid XML) are not reported here - this is the business
+    //  of the checker 'basicxmlmetadata'. If we cannot get the ComponentBitCount information, then there is nothing to check.
+    shared_ptr<IDimensionChannelsInfo> dimensions_channels_info;
+    try
+    {
+        const auto metadata_segment = this->reader_->ReadMetadataSegment();
+        if (metadata_segment)
+        {
+            const auto czi_metadata = metadata_segment->CreateMetaFromMetadataSegment();
+            if (czi_metadata && czi_metadata->IsXmlValid())
+            {
+                dimensions_channels_info = czi_metadata->GetDocumentInfo()->GetDimensionChannelsInfo();
+            }
+        }
+    }
+    catch (exception&)
+    {
+    }
+
+    if (!dimensions_channels_info)
+    {
+        return;
+    }
+
+    for (int channel_index = 0; channel_index < dimensions_channels_info->GetChannelCount(); channel_index++)
+    {
+        int component_bit_count;
+        if (dimensions_channels_info->GetChannel(channel_index)->TryGetComponentBitCount(&component_bit_count) &&
+            component_bit_count > 0)
+        {
+            this->channels_[channel_index].componentBitCount = component_bit_count;
+        }
+    }
+}
+
+void CCheckComponentBitCountContent::DetermineSubBlocksToExamine()
+{
+    this->reader_->EnumerateSubBlocks(
+        [this](int index, const SubBlockInfo& info)->bool
+        {
+            const auto channel = this->channels_.find(CCheckComponentBitCountContent::GetChannelIndex(info));
+            if (channel == this->channels_.end())
+            {
+                return true;
+            }
+
+            // the check is only meaningful for integer pixel types, and if the ComponentBitCount is less than the number of bits
+            //  of the pixel type (note that a ComponentBitCount which is invalid for the pixel type is reported by 'basicxmlmetadata')
+            if (!CPixelContentAnalyzer::IsFloatingPointPixelType(info.pixelType) &&
+                CCheckComponentBitCountContent::GetNumberOfBitsUsed(CPixelContentAnalyzer::GetMaximumComponentValue(info.pixelType)) > channel->second.componentBitCount)
+            {
+                channel->second.subBlocks.push_back(index);
+            }
+
+            return true;
+        });
+
+    // If there are more subblocks in a channel than we want to examine, then we take a stratified sample - the subblocks
+    //  of the channel (in the order of the subblock-directory) are divided into strata of equal size, and the subblock
+    //  in the middle of each stratum is chosen.
+    for (auto& channel : this->channels_)
+    {
+        auto& channel_info = channel.second;
+        const size_t count = channel_info.subBlocks.size();
+        if (count <= kMaxNumberOfSubBlocksPerChannel)
+        {
+            channel_info.subBlocksToExamine = channel_info.subBlocks;
+        }
+        else
+        {
+            channel_info.subBlocksToExamine.reserve(kMaxNumberOfSubBlocksPerChannel);
+            for (size_t i = 0; i < kMaxNumberOfSubBlocksPerChannel; ++i)
+            {
+                const size_t stratum_start = i * count / kMaxNumberOfSubBlocksPerChannel;
+                const size_t stratum_end = (i + 1) * count / kMaxNumberOfSubBlocksPerChannel;
+                channel_info.subBlocksToExamine.push_back(channel_info.subBlocks[(stratum_start + stratum_end) / 2]);
+            }
+        }
+    }
+}
+
+void CCheckComponentBitCountContent::ExamineSubBlocks()
+{
+    vector<bool> subblocks_to_examine;
+    for (const auto& channel : this->channels_)
+    {
+        for (const int index : channel.second.subBlocksToExamine)
+        {
+            if (static_cast<size_t>(index) >= subblocks_to_examine.size())
+            {
+                subblocks_to_examine.resize(static_cast<size_t>(index) + 1, false);
+            }
+
+            subblocks_to_examine[index] = true;
+        }
+    }
+
+    if (subblocks_to_examine.empty())
+    {
+        return;
+    }
+
+    CPixelContentAnalyzer::EnumerateSubBlocks(
+        this->reader_,
+        this->additional_info_,
+        [&](int index, const DirectorySubBlockInfo& info)->bool
+        {
+            if (static_cast<size_t>(index) >= subblocks_to_examine.size() || !subblocks_to_examine[index])
+            {
+                return false;
+            }
+
+            // once we know that a channel exceeds the ComponentBitCount, there is no need to examine more of its subblocks
+            const auto& channel_info = this->channels_.at(CCheckComponentBitCountContent::GetChannelIndex(info));
+            return CCheckComponentBitCountContent::GetNumberOfBitsUsed(channel_info.maximum) <= channel_info.componentBitCount;
+        },
+        [this](int index, const DirectorySubBlockInfo& info, CMemoryGovernor::Reservation& reservation)->bool
+        {
+            return this->ReserveMemoryForSubBlock(CCheckComponentBitCountContent::kCheckType, index, info, reservation);
+        },
+        [this](int index, const SubBlockInfo& info, PixelType pixel_type, const PixelContentStatistics& statistics)->void
+        {
+            if (CPixelContentAnalyzer::IsFloatingPointPixelType(pixel_type) || !statistics.HasFiniteValues())
+            {
+                return;
+            }
+
+            auto& channel_info = this->channels_.at(CCheckComponentBitCountContent::GetChannelIndex(info));
+            ++channel_info.subBlocksExamined;
+            if (statistics.maximum > channel_info.maximum)
+            {
+                channel_info.maximum = statistics.maximum;
+                channel_info.subBlockWithMaximum = index;
+            }
+        });
+}
+
+void CCheckComponentBitCountContent::ReportFindings()
+{
+    for (const auto& channel : this->channels_)
+    {
+        const auto& channel_info = channel.second;
+        const int bits_used = CCheckComponentBitCountContent::GetNumberOfBitsUsed(channel_info.maximum);
+        if (bits_used > channel_info.componentBitCount)
+        {
+            IResultGatherer::Finding finding(CCheckComponentBitCountContent::kCheckType);
+            finding.severity = IResultGatherer::Severity::Warning;
+            stringstream ss;
+            ss << "channel " << channel.first << ": the pixel values use " << bits_used << " bits, whereas the ComponentBitCount in metadata is " << channel_info.componentBitCount;
+            finding.information = ss.str();
+            stringstream ss_details;
+            ss_details << "maximum value " << static_cast<uint64_t>(channel_info.maximum) << " found in subblock #" << channel_info.subBlockWithMaximum
+                << " (" << channel_info.subBlocksExamined << " of " << channel_info.subBlocks.size() << " subblocks examined)";
+            finding.details = ss_details.str();
+            this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        }
+    }
+}
+
+void CCheckComponentBitCountContent::ReportStatistics()
+{
+    IResultGatherer::StatisticsTable table(CCheckComponentBitCountContent::kCheckType);
+    table.name = "bits used per channel";
+    table.columns = { "channel", "ComponentBitCount", "subblocks", "subblocks examined", "maximum value", "bits used" };
+    for (const auto& channel : this->channels_)
+    {
+        const auto& channel_info = channel.second;
+        table.rows.push_back({
+            static_cast<int64_t>(channel.first),
+            static_cast<int64_t>(channel_info.componentBitCount),
+            static_cast<int64_t>(channel_info.subBlocks.size()),
+            channel_info.subBlocksExamined,
+            static_cast<int64_t>(max(channel_info.maximum, 0.0)),
+            static_cast<int64_t>(CCheckComponentBitCountContent::GetNumberOfBitsUsed(channel_info.maximum)) });
+    }
+
+    this->result_gatherer_.ReportStatistics(table);
+}
+
+/*static*/int CCheckComponentBitCountContent::GetChannelIndex(const libCZI::SubBlockInfo& info)
+{
+    // if there is no C-index, then we consider the subblock to be in channel 0
+    int c;
+    if (!info.coordinate.TryGetPosition(DimensionIndex::C, &c))
+    {
+        c = 0;
+    }
+
+    return c;
+}
+
+/*static*/int CCheckComponentBitCountContent::GetNumberOfBitsUsed(double maximum)
+{
+    // the maximum of an integer pixel type is an integer (and at most 2^32-1), so it can be represented exactly
+    if (!(maximum >= 1))
+    {
+        return 0;
+    }
+
+    uint64_t value = static_cast<uint64_t>(maximum);
+    int bits = 0;
+    while (value != 0)
+    {
+        ++bits;
+        value >>= 1;
+    }
+
+    return bits;
+}
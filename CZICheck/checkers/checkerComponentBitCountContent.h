@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "checkerbase.h"
+#include "pixelcontent.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+/// This checker compares the pixel values with the "ComponentBitCount" given in the metadata for a
+/// channel (which states how many bits of an integer pixel type are actually used, e.g. 12 bits
+/// with a Gray16 pixel type). The subblocks of a channel (or a sample of them, if there are many)
+/// are decoded, and the highest bit used is determined from the maximum of the pixel values. It is
+/// reported if the data of a channel uses more bits than stated in the metadata.
+class CCheckComponentBitCountContent : public IChecker, CCheckerBase
+{
+private:
+    /// The information gathered for a channel.
+    struct ChannelInfo
+    {
+        int componentBitCount{ 0 };             ///< The ComponentBitCount as given in metadata.
+        std::vector<int> subBlocks;             ///< The indices of the subblocks of this channel.
+        std::vector<int> subBlocksToExamine;    ///< The indices of the subblocks to examine (i.e. the sample).
+        std::int64_t subBlocksExamined{ 0 };    ///< The number of subblocks which have been examined successfully.
+        double maximum{ -1 };                   ///< The maximum of the pixel values examined (-1 if no subblock was examined).
+        int subBlockWithMaximum{ -1 };          ///< The index of the subblock containing the maximum.
+    };
+
+    std::map<int, ChannelInfo> channels_;
+public:
+    static const CZIChecks kCheckType = CZIChecks::ComponentBitCountFitsPixelContent;
+    static const char* kDisplayName;
+    static const char* kShortName;
+
+    CCheckComponentBitCountContent(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        IResultGathererReport& result_gatherer,
+        const CheckerCreateInfo& additional_info);
+    void RunCheck() override;
+private:
+    void GetComponentBitCountsFromMetadata();
+    void DetermineSubBlocksToExamine();
+    void ExamineSubBlocks();
+    void ReportFindings();
+    void ReportStatistics();
+
+    static int GetChannelIndex(const libCZI::SubBlockInfo& info);
+    static int GetNumberOfBitsUsed(double maximum);
+};
@@ -3,9 +3,14 @@
 // SPDX-License-Identifier: MIT
 
 #include "checkerConsecutivePlaneIndices.h"
+#include "indexoccupancy.h"
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <utility>
 
 using namespace libCZI;
 using namespace std;
@@ -13,6 +18,12 @@ using namespace std;
 /*static*/const char* CCheckConsecutivePlaneIndices::kDisplayName = "Check that planes have consecutive indices";
 /*static*/const char* CCheckConsecutivePlaneIndices::kShortName = "consecutiveplaneindices";
 
+namespace
+{
+    /// The maximum number of ranges of missing indices listed in the details of a finding.
+    constexpr size_t kMaxNumberOfRangesInDetails = 20;
+}
+
 
 CCheckConsecutivePlaneIndices::CCheckConsecutivePlaneIndices(
     const std::shared_ptr<libCZI::ICZIReader>& reader,
@@ -37,59 +48,62 @@ void CCheckConsecutivePlaneIndices::CheckForConsecutiveIndices()
 {
     const auto statistics = this->reader_->GetStatistics();
 
-    // This is a map with key "dimension" and value "a bitfield", where we will construct
-    //  a bitfield with the size as reported by the statistics. Statistics gives the min and 
-    //  the max value for the index, and we create a bitfield of size "max-min".
-    map<DimensionIndex, vector<bool>> per_dimension_occupancy;
+    // This is an array (indexed by the dimension) of the occupancy of the indices, and of the range of the
+    //  indices as reported by the statistics (which gives the min and the max value for the index). We
+    //  also keep a list of the valid dimensions, so that in the loop over all subblocks below we do not have
+    //  to query the statistics again.
+    array<CIndexOccupancy, kNumberOfDimensions> per_dimension_occupancy;
+    array<pair<int64_t, int64_t>, kNumberOfDimensions> per_dimension_range;
+    vector<DimensionIndex> dimensions;
 
     statistics.dimBounds.EnumValidDimensions(
         [&](DimensionIndex dim, int start, int size)->bool
         {
-            // TODO(JBL): we could/should check for pathological cases like "the size is really large, larger than the number of subblocks",
-            //             in which case we can immediately conclude that there has to be a gap
-            per_dimension_occupancy.emplace(dim, vector<bool>(size));
+            per_dimension_occupancy[GetDimensionArrayIndex(dim)] = CIndexOccupancy(start);
+            per_dimension_range[GetDimensionArrayIndex(dim)] = make_pair(static_cast<int64_t>(start), static_cast<int64_t>(start) + size - 1);
+            dimensions.push_back(dim);
             return true;
         });
 
     // now, just run through the list of subblocks, and "tick away" the reported index in the
-    //  bitfield corresponding to the dimension
+    //  occupancy corresponding to the dimension
     this->reader_->EnumerateSubBlocks(
         [&](int index, const SubBlockInfo& info)->bool
         {
-            info.coordinate.EnumValidDimensions(
-                [&](DimensionIndex dim, int value)->bool
+            for (const auto dim : dimensions)
+            {
+                int value;
+                const auto& range = per_dimension_range[GetDimensionArrayIndex(dim)];
+                // values outside the bounds should not happen (as the bounds are from the statistics), but we are defensive here
+                if (info.coordinate.TryGetPosition(dim, &value) && value >= range.first && value <= range.second)
                 {
-                    // note: we have to subtract the "startIndex" (i.e. the reported minimum for the respective dimension)
-                    int startIndex;
-                    statistics.dimBounds.TryGetInterval(dim, &startIndex, nullptr);
-
-                    // note: I'd think we can rightfully assume that the dimension is found in the map, and that the 
-                    //        index (value - startIndex) is within range. More wary fellows might be more defensive and
-                    //        prepare themselves for this assumption to not hold...
-                    per_dimension_occupancy[dim][value - startIndex] = true;
-                    return true;
-                });
+                    per_dimension_occupancy[GetDimensionArrayIndex(dim)].Add(value);
+                }
+            }
 
             return true;
         });
 
-    // ok, now we can simply check the bitfields, if we find a "false" in there, this means, that there is gap, the
-    //  indices are not consecutive
-    for (const auto& occupancy : per_dimension_occupancy)
+    // ok, now we can simply check the occupancy, if we find a gap, this means that the indices are not consecutive
+    for (const auto dim : dimensions)
     {
-        if (find(occupancy.second.cbegin(), occupancy.second.cend(), false) != occupancy.second.cend())
+        const auto& range = per_dimension_range[GetDimensionArrayIndex(dim)];
+        const auto missing_ranges = per_dimension_occupancy[GetDimensionArrayIndex(dim)].GetMissingRanges(static_cast<int>(range.first), static_cast<int>(range.second));
+        if (!missing_ranges.empty())
         {
             IResultGatherer::Finding finding(CCheckConsecutivePlaneIndices::kCheckType);
             finding.severity = IResultGatherer::Severity::Warning;
             stringstream ss;
-            ss << "The indices for dimension '" << Utils::DimensionToChar(occupancy.first) << "' are not consecutive";
+            ss << "The indices for dimension '" << Utils::DimensionToChar(dim) << "' are not consecutive";
             finding.information = ss.str();
 
-            // TODO(JBL): we could report the indices missing, maybe as "finding.details" - however, I'd think the "details"-field 
-            //             is currently not being outputted, probably we'd want a commandline-options letting us choose whether we
-            //             want to see "details" or not.
-
+            finding.details = "missing indices: " + CIndexOccupancy::FormatRanges(missing_ranges, kMaxNumberOfRangesInDetails);
             this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
         }
     }
 }
+
+/*static*/size_t CCheckConsecutivePlaneIndices::GetDimensionArrayIndex(libCZI::DimensionIndex dim)
+{
+    return static_cast<size_t>(dim) - static_cast<size_t>(DimensionIndex::MinDim);
+}
@@ -4,7 +4,7 @@
 
 #pragma once
 
-#include <vector>
+#include <cstddef>
 #include <memory>
 #include "checkerbase.h"
 
@@ -22,5 +22,8 @@ public:
         const CheckerCreateInfo& additional_info);
     void RunCheck() override;
 private:
+    static constexpr int kNumberOfDimensions = static_cast<int>(libCZI::DimensionIndex::MaxDim) - static_cast<int>(libCZI::DimensionIndex::MinDim) + 1;
+
     void CheckForConsecutiveIndices();
+    static std::size_t GetDimensionArrayIndex(libCZI::DimensionIndex dim);
 };
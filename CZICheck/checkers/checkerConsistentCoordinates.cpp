@@ -4,8 +4,8 @@
 
 #include "checkerConsistentCoordinates.h"
 #include <memory>
+#include <sstream>
 #include <string>
-#include <vector>
 
 using namespace libCZI;
 using namespace std;
@@ -27,46 +27,40 @@ void CCheckConsistentCoordinates::RunCheck()
 
     this->RunCheckDefaultExceptionHandling([this]()
         {
-            vector<SubBlockInfo> subBlockInfos;
-            subBlockInfos.reserve(this->reader_->GetStatistics().subBlockCount);
-
-            this->reader_->EnumerateSubBlocks(
-                [&](int index, const SubBlockInfo& info)->bool
-                {
-                    subBlockInfos.emplace_back(info);
-                    return true;
-                });
-
-            this->CheckForSameDimensions(subBlockInfos);
+            this->CheckForSameDimensions();
         });
 
     this->result_gatherer_.FinishCheck(CCheckConsistentCoordinates::kCheckType);
 }
 
-void CCheckConsistentCoordinates::CheckForSameDimensions(const std::vector<libCZI::SubBlockInfo>& subblocks) const
+void CCheckConsistentCoordinates::CheckForSameDimensions() const
 {
-    if (subblocks.size() <= 1)
-    {
-        return;
-    }
-
-    const auto& expected_dimensions = subblocks.front().coordinate;
-
-    for (size_t i = 1; i < subblocks.size(); ++i)
-    {
-        const auto& info = subblocks[i];
-        if (!Utils::HasSameDimensions(&info.coordinate, &expected_dimensions))
+    // the subblocks are checked while enumerating them - only the coordinate of the first subblock needs to be kept,
+    //  so the memory used does not depend on the number of subblocks
+    CDimCoordinate expected_dimensions;
+    size_t subblock_number = 0;
+    this->reader_->EnumerateSubBlocks(
+        [&](int index, const SubBlockInfo& info)->bool
         {
-            IResultGatherer::Finding finding(CCheckConsistentCoordinates::kCheckType);
-            finding.check = CZIChecks::ConsistentSubBlockCoordinates;
-            finding.severity = IResultGatherer::Severity::Fatal;
-            stringstream ss;
-            ss << "subblock #" << i << " has dimensions \"" << GetDimensionsAsInformalString(&info.coordinate)
-                << "\", whereas \"" << GetDimensionsAsInformalString(&expected_dimensions) << "\" was expected.";
-            finding.information = ss.str();
-            this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
-        }
-    }
+            if (subblock_number == 0)
+            {
+                expected_dimensions = info.coordinate;
+            }
+            else if (!Utils::HasSameDimensions(&info.coordinate, &expected_dimensions))
+            {
+                IResultGatherer::Finding finding(CCheckConsistentCoordinates::kCheckType);
+                finding.check = CZIChecks::ConsistentSubBlockCoordinates;
+                finding.severity = IResultGatherer::Severity::Fatal;
+                stringstream ss;
+                ss << "subblock #" << subblock_number << " has dimensions \"" << GetDimensionsAsInformalString(&info.coordinate)
+                    << "\", whereas \"" << GetDimensionsAsInformalString(&expected_dimensions) << "\" was expected.";
+                finding.information = ss.str();
+                this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+            }
+
+            ++subblock_number;
+            return true;
+        });
 }
 
 /*static*/std::string CCheckConsistentCoordinates::GetDimensionsAsInformalString(const libCZI::IDimCoordinate* coordinate)
@@ -6,7 +6,6 @@
 
 #include "checkerbase.h"
 #include <memory>
-#include <vector>
 #include <string>
 
 class CCheckConsistentCoordinates : public IChecker, CCheckerBase
@@ -23,6 +22,6 @@ public:
     void RunCheck() override;
 
 private:
-    void CheckForSameDimensions(const std::vector<libCZI::SubBlockInfo>& subblocks) const;
+    void CheckForSameDimensions() const;
     static std::string GetDimensionsAsInformalString(const libCZI::IDimCoordinate* coordinate);
 };
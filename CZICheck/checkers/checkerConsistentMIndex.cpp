@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "checkerConsistentMIndex.h"
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+#include <memory>
+
+using namespace libCZI;
+using namespace std;
+
+/*static*/const char* CCheckConsistentMIndex::kDisplayName = "check that the M-indices within a plane are consecutive and start at 0";
+/*static*/const char* CCheckConsistentMIndex::kShortName = "consistentmindex";
+
+namespace
+{
+    /// The maximum number of ranges (of missing or of duplicate M-indices) listed in the details of a finding.
+    constexpr size_t kMaxNumberOfItemsInDetails = 20;
+}
+
+CCheckConsistentMIndex::CCheckConsistentMIndex(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    IResultGathererReport& result_gatherer,
+    const CheckerCreateInfo& additional_info) :
+    CCheckerBase(reader, result_gatherer, additional_info)
+{
+}
+
+void CCheckConsistentMIndex::RunCheck()
+{
+    this->result_gatherer_.StartCheck(CCheckConsistentMIndex::kCheckType);
+
+    this->RunCheckDefaultExceptionHandling([this]()
+        {
+            auto buckets = this->GatherMIndices();
+            for (const auto& bucket : buckets)
+            {
+                this->CheckBucket(bucket);
+            }
+        });
+
+    this->result_gatherer_.FinishCheck(CCheckConsistentMIndex::kCheckType);
+}
+
+std::vector<CCheckConsistentMIndex::Bucket> CCheckConsistentMIndex::GatherMIndices()
+{
+    vector<Bucket> buckets;
+    unordered_map<CLayer0Planes::PlaneKey, vector<pair<int, size_t>>, CLayer0Planes::PlaneKeyHash> bucket_indices_for_plane;
+
+    // subblocks without an M-index are not considered here - this is the business of the checker 'minallsubblks'
+    this->reader_->EnumerateSubBlocks(
+        [&](int index, const SubBlockInfo& info)->bool
+        {
+            if (!CLayer0Planes::IsLayer0(info) || !info.IsMindexValid())
+            {
+                return true;
+            }
+
+            int scene_index;
+            if (!info.coordinate.TryGetPosition(DimensionIndex::S, &scene_index))
+            {
+                scene_index = CLayer0Planes::kNoSceneIndex;
+            }
+
+            // there are usually very few scenes per plane, so a linear search is fine here
+            const CLayer0Planes::PlaneKey key(info.coordinate);
+            auto& buckets_of_plane = bucket_indices_for_plane[key];
+            auto it = find_if(buckets_of_plane.begin(), buckets_of_plane.end(), [=](const pair<int, size_t>& p)->bool {return p.first == scene_index; });
+            if (it == buckets_of_plane.end())
+            {
+                buckets_of_plane.emplace_back(scene_index, buckets.size());
+                buckets.emplace_back(Bucket{ key, scene_index, CIndexOccupancy(), CIndexOccupancy() });
+                it = prev(buckets_of_plane.end());
+            }
+
+            auto& bucket = buckets[it->second];
+            if (!bucket.occupancy.Add(info.mIndex))
+            {
+                bucket.duplicates.Add(info.mIndex);
+            }
+            return true;
+        });
+
+    // report in the order of the planes (as enumerated by "Utils::EnumAllCoordinates"), and then by scene
+    sort(buckets.begin(), buckets.end(),
+        [](const Bucket& a, const Bucket& b)->bool
+        {
+            if (a.plane.IsBefore(b.plane))
+            {
+                return true;
+            }
+
+            if (b.plane.IsBefore(a.plane))
+            {
+                return false;
+            }
+
+            return a.sceneIndex < b.sceneIndex;
+        });
+
+    return buckets;
+}
+
+void CCheckConsistentMIndex::CheckBucket(const Bucket& bucket)
+{
+    const auto missing_ranges = bucket.occupancy.GetMissingRanges(bucket.occupancy.GetMinimum(), bucket.occupancy.GetMaximum());
+    const bool has_duplicates = bucket.duplicates.GetCount() > 0;
+    const bool starts_at_zero = bucket.occupancy.GetMinimum() == 0;
+    if (missing_ranges.empty() && !has_duplicates && starts_at_zero)
+    {
+        return;
+    }
+
+    const auto plane_coordinate = bucket.plane.ToCoordinate();
+    IResultGatherer::Finding finding(CCheckConsistentMIndex::kCheckType);
+    finding.severity = IResultGatherer::Severity::Warning;
+    stringstream ss;
+    ss << "the M-indices in plane " << Utils::DimCoordinateToString(&plane_coordinate);
+    if (bucket.sceneIndex != CLayer0Planes::kNoSceneIndex)
+    {
+        ss << " of scene " << bucket.sceneIndex;
+    }
+
+    ss << " are not consistent:";
+    const char* separator = " ";
+    if (!starts_at_zero)
+    {
+        ss << separator << "they start at " << bucket.occupancy.GetMinimum();
+        separator = ", ";
+    }
+
+    if (!missing_ranges.empty())
+    {
+        ss << separator << "there are gaps";
+        separator = ", ";
+    }
+
+    if (has_duplicates)
+    {
+        ss << separator << "there are duplicates";
+    }
+
+    finding.information = ss.str();
+
+    stringstream ss_details;
+    ss_details << bucket.occupancy.GetCount() << " subblocks, M-indices from " << bucket.occupancy.GetMinimum() << " to " << bucket.occupancy.GetMaximum();
+    if (!missing_ranges.empty())
+    {
+        ss_details << "; missing: " << CIndexOccupancy::FormatRanges(missing_ranges, kMaxNumberOfItemsInDetails);
+    }
+
+    if (has_duplicates)
+    {
+        ss_details << "; used more than once: " << CIndexOccupancy::FormatRanges(bucket.duplicates.GetRanges(), kMaxNumberOfItemsInDetails);
+    }
+
+    finding.details = ss_details.str();
+    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+}
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "checkerbase.h"
+#include "indexoccupancy.h"
+#include "layer0planes.h"
+
+/// This checker examines the M-indices of the subblocks on pyramid-layer 0 within each plane and scene. Readers
+/// operating on tiles often assume that the M-indices within a plane are dense and start at zero - so gaps,
+/// duplicates and a start different from zero are reported.
+/// The subblock-directory is enumerated once, and the M-indices are recorded in a bitfield for each plane and
+/// scene (see CIndexOccupancy - if the M-indices are sparse, they are recorded as intervals instead, so the memory
+/// usage is proportional to the number of distinct M-indices).
+class CCheckConsistentMIndex : public IChecker, CCheckerBase
+{
+private:
+    /// The M-indices of a plane and scene.
+    struct Bucket
+    {
+        CLayer0Planes::PlaneKey plane;
+        int sceneIndex;
+        CIndexOccupancy occupancy;
+        CIndexOccupancy duplicates;     ///< The M-indices used more than once.
+    };
+public:
+    static const CZIChecks kCheckType = CZIChecks::ConsistentMIndex;
+    static const char* kDisplayName;
+    static const char* kShortName;
+
+    CCheckConsistentMIndex(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        IResultGathererReport& result_gatherer,
+        const CheckerCreateInfo& additional_info);
+    void RunCheck() override;
+private:
+    std::vector<Bucket> GatherMIndices();
+    void CheckBucket(const Bucket& bucket);
+};
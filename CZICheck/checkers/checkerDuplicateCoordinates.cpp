@@ -3,8 +3,16 @@
 // SPDX-License-Identifier: MIT
 
 #include "checkerDuplicateCoordinates.h"
+#include "externalsorter.h"
+#include "../xxhash64.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <utility>
 #include <vector>
 #include <memory>
 #include <string>
@@ -12,6 +20,13 @@
 using namespace libCZI;
 using namespace std;
 
+namespace
+{
+    /// The minimum number of subblocks kept in memory by the external sort (if the memory governor grants less,
+    /// we wait for more memory to become available).
+    constexpr size_t kMinimumNumberOfSubBlocksInMemory = 1024;
+}
+
 /*static*/const char* CCheckDuplicateCoordinates::kDisplayName = "check subblock's coordinates being unique";
 /*static*/const char* CCheckDuplicateCoordinates::kShortName = "subblkcoordsunique";
 
@@ -29,178 +44,228 @@ void CCheckDuplicateCoordinates::RunCheck()
 
     this->RunCheckDefaultExceptionHandling([this]()
         {
-            vector<SubBlockInfo> subblock_infos;
-            subblock_infos.reserve(this->reader_->GetStatistics().subBlockCount);
-
-            this->reader_->EnumerateSubBlocks(
-                [&](int index, const SubBlockInfo& info)->bool
-                {
-                    subblock_infos.emplace_back(info);
-                    return true;
-                });
-
-
-            this->CheckForDuplicates(subblock_infos);
+            this->CheckForDuplicates();
         });
 
     this->result_gatherer_.FinishCheck(CCheckDuplicateCoordinates::kCheckType);
 }
 
-void CCheckDuplicateCoordinates::CheckForDuplicates(vector<SubBlockInfo>& subblock_infos)
+void CCheckDuplicateCoordinates::CheckForDuplicates()
 {
-    vector<int> indices_sorted;
-    indices_sorted.reserve(subblock_infos.size());
-    for (int i = 0; i < subblock_infos.size(); ++i)
+    // we calculate a hash for each subblock (from all the criteria which are compared for equality exactly, i.e.
+    //  everything except the zoom) and sort the subblocks by this hash - so, duplicates are guaranteed to end up in the
+    //  same run of equal hashes, and only within such a run the subblocks need to be compared. The sorting is done
+    //  with an external sort - if the memory governor does not grant the memory for holding all the subblocks, the
+    //  sorter spills to temporary files. The duplicates found are sorted (by index) with an external sort as well, and
+    //  the memory reserved is split between the two sorters.
+    size_t max_subblocks_in_memory = numeric_limits<size_t>::max();
+    size_t max_duplicates_in_memory = numeric_limits<size_t>::max();
+    CMemoryGovernor::Reservation reservation;
+    if (this->additional_info_.memoryGovernor)
     {
-        indices_sorted.emplace_back(i);
+        const auto& memory_governor = this->additional_info_.memoryGovernor;
+        const char* consumer = CZIChecksToString(CCheckDuplicateCoordinates::kCheckType);
+        const uint64_t size_required = static_cast<uint64_t>(max(this->reader_->GetStatistics().subBlockCount, 1)) * (sizeof(PackedSubBlock) + sizeof(DuplicatePair));
+        const uint64_t minimum_size = min(static_cast<uint64_t>(kMinimumNumberOfSubBlocksInMemory) * (sizeof(PackedSubBlock) + sizeof(DuplicatePair)), size_required);
+        uint64_t size_reserved = memory_governor->ReserveUpTo(consumer, size_required, minimum_size, reservation);
+        if (size_reserved == 0)
+        {
+            // if not even the minimum is available at this point, we wait for it
+            if (!memory_governor->Reserve(consumer, minimum_size, reservation))
+            {
+                IResultGatherer::Finding finding(CCheckDuplicateCoordinates::kCheckType);
+                finding.severity = IResultGatherer::Severity::Warning;
+                finding.information = "The check was not run because the memory budget is too small";
+                stringstream ss;
+                ss << "memory required (minimum): " << CMemoryGovernor::FormatSize(minimum_size)
+                    << ", memory budget: " << CMemoryGovernor::FormatSize(memory_governor->GetBudget());
+                finding.details = ss.str();
+                this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+                return;
+            }
+
+            size_reserved = minimum_size;
+        }
+
+        const uint64_t number_of_items = size_reserved / (sizeof(PackedSubBlock) + sizeof(DuplicatePair));
+        max_subblocks_in_memory = static_cast<size_t>(max<uint64_t>(number_of_items, 1));
+        max_duplicates_in_memory = static_cast<size_t>(max<uint64_t>(number_of_items, 1));
     }
 
-    struct Comparer
+    try
+    {
+        this->FindAndReportDuplicates(max_subblocks_in_memory, max_duplicates_in_memory);
+    }
+    catch (ExternalSorterException& ex)
     {
-    private:
-        const vector<SubBlockInfo>& subBlockInfos;
-    public:
-        explicit Comparer(const vector<SubBlockInfo>& subBlockInfos) : subBlockInfos(subBlockInfos) {}
+        // the temporary files for the external sort could not be created (or written or read) - the check could
+        //  not be completed then (findings reported so far remain valid)
+        IResultGatherer::Finding finding(CCheckDuplicateCoordinates::kCheckType);
+        finding.severity = IResultGatherer::Severity::Warning;
+        finding.information = "The check could not be completed because the temporary files for sorting the subblocks could not be used";
+        stringstream ss;
+        ss << ex.what() << " (the directory for temporary files can be given with the option '--temp-dir')";
+        finding.details = ss.str();
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+    }
+}
+
+void CCheckDuplicateCoordinates::FindAndReportDuplicates(size_t max_subblocks_in_memory, size_t max_duplicates_in_memory)
+{
+    CExternalSorter<PackedSubBlock> sorter(max_subblocks_in_memory, this->additional_info_.tempDirectory);
 
-        bool operator() (int a, int b) const
+    this->reader_->EnumerateSubBlocks(
+        [&](int index, const SubBlockInfo& info)->bool
         {
-            return Compare(subBlockInfos[a], subBlockInfos[b]);
-        }
-    private:
-        /// Compares two const SubBlockInfo objects to determine their relative ordering. The value
-        /// returned indicates whether the first element is considered to go before the second in
-        /// _strict weak ordering_ semantic.
-        /// \param  a The first element to be compared.
-        /// \param  b The second element to be compared.
-        /// \returns True if the first element is considered to go before the second.
-        static bool Compare(const SubBlockInfo& a, const SubBlockInfo& b)
+            sorter.Add(Pack(index, info));
+            return true;
+        });
+
+    // within a run of equal hashes (where the indices are in ascending order), every subblock is compared to the
+    //  "representatives" of the run, i.e. the subblocks which were found not to be a duplicate of an earlier subblock -
+    //  if it is equal to one of them, it is a duplicate of this one, otherwise it becomes a representative itself. So,
+    //  only the representatives (usually just one) are kept in memory, and not the whole run.
+    CExternalSorter<DuplicatePair> duplicates(max_duplicates_in_memory, this->additional_info_.tempDirectory);
+    vector<PackedSubBlock> representatives;
+    sorter.Enumerate(
+        [&](const PackedSubBlock& subblock)->bool
         {
-            // first criterion : the zoom (or the pyramid layer)
-            if (a.logicalRect.w == a.physicalSize.w && a.logicalRect.h == a.physicalSize.h &&
-                b.logicalRect.w == b.physicalSize.w && b.logicalRect.h == b.physicalSize.h)
+            if (!representatives.empty() && representatives.front().hash != subblock.hash)
             {
-                if (a.GetZoom() > b.GetZoom())
-                {
-                    return true;
-                }
-                else if (a.GetZoom() < b.GetZoom())
-                {
-                    return false;
-                }
+                representatives.clear();
             }
 
-            const int r = Utils::Compare(&a.coordinate, &b.coordinate);
-            if (r > 0)
+            const auto representative = find_if(
+                representatives.cbegin(),
+                representatives.cend(),
+                [&](const PackedSubBlock& other)->bool { return AreDuplicates(other, subblock); });
+            if (representative != representatives.cend())
             {
-                return true;
+                duplicates.Add(DuplicatePair{ *representative, subblock.index });
             }
-            else if (r < 0)
+            else
             {
-                return false;
+                representatives.push_back(subblock);
             }
 
-            if (a.IsMindexValid() && b.IsMindexValid())
-            {
-                if (a.mIndex > b.mIndex)
-                {
-                    return true;
-                }
-                else if (a.mIndex < b.mIndex)
-                {
-                    return false;
-                }
-            }
-            else if (a.IsMindexValid() && !b.IsMindexValid())
-            {
-                return true;
-            }
+            return true;
+        });
 
-            return false;
+    duplicates.Enumerate(
+        [&](const DuplicatePair& duplicate)->bool
+        {
+            IResultGatherer::Finding finding(CCheckDuplicateCoordinates::kCheckType);
+            finding.severity = IResultGatherer::Severity::Fatal;
+            stringstream ss;
+            ss << "duplicate subblock #" << duplicate.first.index << " and # " << duplicate.second << " : \"" << GetSubblockAsString(duplicate.first) << "\"";
+            finding.information = ss.str();
+            this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+            return true;
+        });
+}
+
+/*static*/CCheckDuplicateCoordinates::PackedSubBlock CCheckDuplicateCoordinates::Pack(int index, const libCZI::SubBlockInfo& subblock_info)
+{
+    PackedSubBlock packed{};
+    packed.index = index;
+    for (int i = static_cast<int>(DimensionIndex::MinDim); i <= static_cast<int>(DimensionIndex::MaxDim); ++i)
+    {
+        int value;
+        if (subblock_info.coordinate.TryGetPosition(static_cast<DimensionIndex>(i), &value))
+        {
+            packed.validDimensions |= 1u << i;
+            packed.dimensions[i] = value;
         }
-    };
+    }
 
-    const Comparer comparer(subblock_infos);
-    sort(indices_sorted.begin(), indices_sorted.end(), comparer);
+    packed.isMIndexValid = subblock_info.IsMindexValid() ? 1 : 0;
+    packed.mIndex = packed.isMIndexValid != 0 ? subblock_info.mIndex : 0;
+    packed.x = subblock_info.logicalRect.x;
+    packed.y = subblock_info.logicalRect.y;
+    packed.zoom = subblock_info.GetZoom();
+    packed.hash = CalculateHash(packed);
+    return packed;
+}
 
-    struct EqualityComparer
+/*static*/std::uint64_t CCheckDuplicateCoordinates::CalculateHash(const PackedSubBlock& subblock)
+{
+    // the key is composed of fixed-width fields: a bitfield of the valid dimensions and the values of all dimensions,
+    //  followed by the M-index (if valid) or the position (if there is no valid M-index) - this mirrors what
+    //  'AreDuplicates' compares exactly
+    int32_t key[static_cast<int>(DimensionIndex::MaxDim) + 4] = {};
+    size_t key_size = 1;
+    key[0] = static_cast<int32_t>(subblock.validDimensions);
+    for (int i = static_cast<int>(DimensionIndex::MinDim); i <= static_cast<int>(DimensionIndex::MaxDim); ++i)
     {
-    private:
-        const vector<SubBlockInfo>& subBlockInfos;
-    public:
-        explicit EqualityComparer(const vector<SubBlockInfo>& subblock_infos) : subBlockInfos(subblock_infos) {}
+        key[key_size++] = subblock.dimensions[i];
+    }
 
-        bool operator() (int a, int b) const
-        {
-            return Compare(subBlockInfos[a], subBlockInfos[b]);
-        }
-    private:
-        [[nodiscard]] bool Compare(const SubBlockInfo& a, const SubBlockInfo& b) const
-        {
-            int r = Utils::Compare(&a.coordinate, &b.coordinate);
-            if (r == 0)
-            {
-                if (a.IsMindexValid() && b.IsMindexValid())
-                {
-                    if (a.mIndex != b.mIndex)
-                    {
-                        return false;
-                    }
-                    else
-                    {
-                        // if both contain M-index, and if their M-index is equal, then we have a problem
-                        return true;
-                    }
-                }
-                else if (a.IsMindexValid() != b.IsMindexValid())
-                {
-                    // if one has a valid m-index and the other not - let's consider them as "not equal"
-                    return false;
-                }
-
-                // if we get here - both do not have an m-index
-
-                // if they are not at the same position - consider them different
-                if (a.logicalRect.x != b.logicalRect.x || a.logicalRect.y != b.logicalRect.y)
-                {
-                    return false;
-                }
-
-                // if the subblocks are on a different pyramid-layer - then consider them not equal
-                if (abs(a.GetZoom() - b.GetZoom()) > 1.0 / 1024)
-                {
-                    // this condition is rather makeshift
-                    return false;
-                }
-
-                return true;
-            }
+    if (subblock.isMIndexValid != 0)
+    {
+        key[key_size++] = subblock.mIndex;
+    }
+    else
+    {
+        key[key_size++] = subblock.x;
+        key[key_size++] = subblock.y;
+    }
 
-            return false;
-        }
-    };
+    return CXxHash64::Calculate(key, key_size * sizeof(int32_t));
+}
+
+/*static*/bool CCheckDuplicateCoordinates::AreDuplicates(const PackedSubBlock& a, const PackedSubBlock& b)
+{
+    // the values of invalid dimensions are zero, so comparing all of them gives the same result as comparing the coordinates
+    if (a.validDimensions != b.validDimensions || !equal(begin(a.dimensions), end(a.dimensions), begin(b.dimensions)))
+    {
+        return false;
+    }
 
-    const EqualityComparer equality_comparer(subblock_infos);
+    if (a.isMIndexValid != 0 && b.isMIndexValid != 0)
+    {
+        // if both contain M-index, and if their M-index is equal, then we have a problem
+        return a.mIndex == b.mIndex;
+    }
+    else if (a.isMIndexValid != b.isMIndexValid)
+    {
+        // if one has a valid m-index and the other not - let's consider them as "not equal"
+        return false;
+    }
 
-    const auto it = std::adjacent_find(indices_sorted.begin(), indices_sorted.end(), equality_comparer);
-    if (it != indices_sorted.end())
+    // if we get here - both do not have an m-index
+
+    // if they are not at the same position - consider them different
+    if (a.x != b.x || a.y != b.y)
     {
-        IResultGatherer::Finding finding(CCheckDuplicateCoordinates::kCheckType);
-        finding.severity = IResultGatherer::Severity::Fatal;
-        stringstream ss;
-        ss << "duplicate subblock #" << *it << " and # " << *(it + 1) << " : \"" << GetSubblockAsString(subblock_infos[*it]) << "\"";
-        finding.information = ss.str();
-        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        return false;
     }
+
+    // if the subblocks are on a different pyramid-layer - then consider them not equal
+    if (abs(a.zoom - b.zoom) > 1.0 / 1024)
+    {
+        // this condition is rather makeshift
+        return false;
+    }
+
+    return true;
 }
 
-/*static*/std::string CCheckDuplicateCoordinates::GetSubblockAsString(const SubBlockInfo& subblock_info)
+/*static*/std::string CCheckDuplicateCoordinates::GetSubblockAsString(const PackedSubBlock& subblock)
 {
-    auto coordinate_as_string = Utils::DimCoordinateToString(&subblock_info.coordinate);
+    CDimCoordinate coordinate;
+    for (int i = static_cast<int>(DimensionIndex::MinDim); i <= static_cast<int>(DimensionIndex::MaxDim); ++i)
+    {
+        if ((subblock.validDimensions & (1u << i)) != 0)
+        {
+            coordinate.Set(static_cast<DimensionIndex>(i), subblock.dimensions[i]);
+        }
+    }
+
     stringstream ss;
-    ss << coordinate_as_string;
-    if (subblock_info.IsMindexValid())
+    ss << Utils::DimCoordinateToString(&coordinate);
+    if (subblock.isMIndexValid != 0)
     {
-        ss << " M=" << subblock_info.mIndex;
+        ss << " M=" << subblock.mIndex;
     }
 
     return ss.str();
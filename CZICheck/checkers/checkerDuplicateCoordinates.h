@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <string>
@@ -22,6 +24,49 @@ public:
         const CheckerCreateInfo& additionalInfo);
     void RunCheck() override;
 private:
-    void CheckForDuplicates(std::vector<libCZI::SubBlockInfo>& subblock_infos);
-    static std::string GetSubblockAsString(const libCZI::SubBlockInfo& subblock_info);
+    /// The information about a subblock which is relevant for this check, in a fixed-width representation - so that
+    /// it can be written to a temporary file (when the external sort spills to disk).
+    struct PackedSubBlock
+    {
+        std::uint64_t hash;         ///< The hash (as calculated by 'CalculateHash').
+        std::int32_t index;         ///< The index of the subblock.
+        std::uint32_t validDimensions;  ///< Bitfield of the valid dimensions (bit i is for the dimension-index i).
+        std::int32_t dimensions[static_cast<int>(libCZI::DimensionIndex::MaxDim) + 1];  ///< The values of the dimensions.
+        std::int32_t mIndex;        ///< The M-index (only valid if 'isMIndexValid' is true).
+        std::int32_t x;             ///< The x-position of the logical rectangle.
+        std::int32_t y;             ///< The y-position of the logical rectangle.
+        std::uint8_t isMIndexValid; ///< Whether the M-index is valid.
+        double zoom;                ///< The zoom of the subblock.
+
+        bool operator<(const PackedSubBlock& other) const
+        {
+            return this->hash < other.hash || (this->hash == other.hash && this->index < other.index);
+        }
+    };
+
+    /// A pair of duplicate subblocks (in a fixed-width representation, so that it can be sorted with the external sort).
+    struct DuplicatePair
+    {
+        PackedSubBlock first;       ///< The subblock with the lower index.
+        std::int32_t second;        ///< The index of the subblock which is a duplicate of the first one.
+
+        bool operator<(const DuplicatePair& other) const
+        {
+            return this->first.index < other.first.index || (this->first.index == other.first.index && this->second < other.second);
+        }
+    };
+
+    void CheckForDuplicates();
+    void FindAndReportDuplicates(std::size_t max_subblocks_in_memory, std::size_t max_duplicates_in_memory);
+    static PackedSubBlock Pack(int index, const libCZI::SubBlockInfo& subblock_info);
+    static std::string GetSubblockAsString(const PackedSubBlock& subblock);
+
+    /// Calculates a hash of the subblock's coordinate, M-index and position. Subblocks which are considered duplicates
+    /// (by 'AreDuplicates') are guaranteed to have the same hash.
+    static std::uint64_t CalculateHash(const PackedSubBlock& subblock);
+
+    /// Determines whether the two subblocks are duplicates, i.e. have the same coordinate and (if present) the same
+    /// M-index. If both do not have an M-index, then they are duplicates if they are at the same position and on the
+    /// same pyramid-layer.
+    static bool AreDuplicates(const PackedSubBlock& a, const PackedSubBlock& b);
 };
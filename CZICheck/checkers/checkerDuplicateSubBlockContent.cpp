@@ -0,0 +1,277 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "checkerDuplicateSubBlockContent.h"
+#include "../segmentreader.h"
+#include "../xxhash64.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <sstream>
+#include <unordered_map>
+#include <memory>
+
+using namespace libCZI;
+using namespace std;
+
+/*static*/const char* CCheckDuplicateSubBlockContent::kDisplayName = "check subblocks for identical content";
+/*static*/const char* CCheckDuplicateSubBlockContent::kShortName = "subblkcontentunique";
+
+namespace
+{
+    /// The maximum number of subblocks listed in the information of a finding.
+    constexpr size_t kMaxNumberOfSubBlocksInFinding = 20;
+}
+
+CCheckDuplicateSubBlockContent::CCheckDuplicateSubBlockContent(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    IResultGathererReport& result_gatherer,
+    const CheckerCreateInfo& additional_info) :
+    CCheckerBase(reader, result_gatherer, additional_info)
+{
+}
+
+void CCheckDuplicateSubBlockContent::RunCheck()
+{
+    this->result_gatherer_.StartCheck(CCheckDuplicateSubBlockContent::kCheckType);
+
+    this->RunCheckDefaultExceptionHandling([this]()
+        {
+            // subblocks which cannot be read are skipped here - reporting those is the business of the
+            //  checkers 'subblksegmentsvalid' and 'subblkbitmapvalid'
+            vector<SubBlockItem> items;
+            for (auto& item : this->GetSubBlocksInFileOrder())
+            {
+                if (this->TryHashSubBlockData(item) && item.dataSize > 0)
+                {
+                    items.emplace_back(item);
+                }
+            }
+
+            for (const auto& group : this->GetGroupsWithIdenticalContent(items))
+            {
+                this->ReportGroup(items, group);
+            }
+        });
+
+    this->result_gatherer_.FinishCheck(CCheckDuplicateSubBlockContent::kCheckType);
+}
+
+std::vector<CCheckDuplicateSubBlockContent::SubBlockItem> CCheckDuplicateSubBlockContent::GetSubBlocksInFileOrder()
+{
+    vector<SubBlockItem> items;
+    items.reserve(this->reader_->GetStatistics().subBlockCount);
+    this->reader_->EnumerateSubBlocksEx(
+        [&](int index, const DirectorySubBlockInfo& info)->bool
+        {
+            SubBlockItem item;
+            item.index = index;
+            item.info = info;
+            items.emplace_back(item);
+            return true;
+        });
+
+    // reading the subblocks in the order of their file position gives (mostly) sequential I/O
+    sort(items.begin(), items.end(),
+        [](const SubBlockItem& a, const SubBlockItem& b)->bool
+        {
+            return a.info.filePosition < b.info.filePosition;
+        });
+
+    return items;
+}
+
+bool CCheckDuplicateSubBlockContent::TryHashSubBlockData(SubBlockItem& item)
+{
+    // without a stream, the subblock is read as a whole - so the memory for it is reserved with the memory governor
+    CMemoryGovernor::Reservation reservation;
+    if (!this->additional_info_.stream &&
+        !this->ReserveMemoryForSubBlock(CCheckDuplicateSubBlockContent::kCheckType, item.index, item.info, reservation))
+    {
+        return false;
+    }
+
+    try
+    {
+        if (this->additional_info_.stream)
+        {
+            // the location of the data is determined from the segment's header (irrespective of the compression mode),
+            //  and the data is hashed chunk by chunk - so the memory usage is independent of the size of the subblock
+            const auto segment_info = CSegmentReader::ReadSubBlockSegmentInfo(this->additional_info_.stream.get(), item.info.filePosition, this->additional_info_.totalFileSize);
+            CXxHash64 hash;
+            CSegmentReader::ReadInChunks(
+                this->additional_info_.stream.get(),
+                segment_info.dataOffset,
+                segment_info.dataSize,
+                CSegmentReader::kDefaultChunkSize,
+                [&](uint64_t, const void* data, size_t size)->bool
+                {
+                    hash.Update(data, size);
+                    return true;
+                });
+            item.dataOffset = segment_info.dataOffset;
+            item.dataSize = segment_info.dataSize;
+            item.hash = hash.GetDigest();
+        }
+        else
+        {
+            const auto sub_block = this->reader_->ReadSubBlock(item.index);
+            const void* data = nullptr;
+            size_t size = 0;
+            sub_block->DangerousGetRawData(ISubBlock::MemBlkType::Data, data, size);
+            item.dataSize = size;
+            item.hash = CXxHash64::Calculate(data, size);
+        }
+    }
+    catch (exception&)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+std::vector<std::vector<int>> CCheckDuplicateSubBlockContent::GetGroupsWithIdenticalContent(const std::vector<SubBlockItem>& items)
+{
+    // first, group the subblocks by their hash - those are the candidates for identical content
+    unordered_map<uint64_t, vector<int>> candidates;
+    for (int i = 0; i < static_cast<int>(items.size()); ++i)
+    {
+        candidates[items[i].hash].push_back(i);
+    }
+
+    // then, confirm the candidates by comparing the data byte by byte - a group of candidates may split
+    //  up into multiple groups (or none) if there are hash collisions
+    vector<vector<int>> groups;
+    for (const auto& candidate : candidates)
+    {
+        vector<int> remaining = candidate.second;
+        while (remaining.size() > 1)
+        {
+            vector<int> group{ remaining.front() };
+            vector<int> not_equal;
+            for (size_t i = 1; i < remaining.size(); ++i)
+            {
+                if (this->IsDataEqual(items[remaining.front()], items[remaining[i]]))
+                {
+                    group.push_back(remaining[i]);
+                }
+                else
+                {
+                    not_equal.push_back(remaining[i]);
+                }
+            }
+
+            if (group.size() > 1)
+            {
+                // within a group, the subblocks are sorted by their index
+                sort(group.begin(), group.end(), [&](int a, int b)->bool {return items[a].index < items[b].index; });
+                groups.emplace_back(std::move(group));
+            }
+
+            remaining = std::move(not_equal);
+        }
+    }
+
+    // report the groups in the order of the subblock index of their first member
+    sort(groups.begin(), groups.end(), [&](const vector<int>& a, const vector<int>& b)->bool {return items[a.front()].index < items[b.front()].index; });
+    return groups;
+}
+
+bool CCheckDuplicateSubBlockContent::IsDataEqual(const SubBlockItem& a, const SubBlockItem& b)
+{
+    if (a.dataSize != b.dataSize || a.hash != b.hash)
+    {
+        return false;
+    }
+
+    // without a stream, both subblocks are read as a whole and held at the same time - so the memory for both is reserved
+    CMemoryGovernor::Reservation reservation_a;
+    CMemoryGovernor::Reservation reservation_b;
+    if (!this->additional_info_.stream &&
+        (!this->ReserveMemoryForSubBlock(CCheckDuplicateSubBlockContent::kCheckType, a.index, a.info, reservation_a) ||
+         !this->ReserveMemoryForSubBlock(CCheckDuplicateSubBlockContent::kCheckType, b.index, b.info, reservation_b)))
+    {
+        return false;
+    }
+
+    try
+    {
+        if (this->additional_info_.stream)
+        {
+            vector<uint8_t> buffer_a(static_cast<size_t>(min<uint64_t>(a.dataSize, CSegmentReader::kDefaultChunkSize)));
+            vector<uint8_t> buffer_b(buffer_a.size());
+            for (uint64_t offset = 0; offset < a.dataSize; offset += buffer_a.size())
+            {
+                const size_t size = static_cast<size_t>(min<uint64_t>(a.dataSize - offset, buffer_a.size()));
+                CSegmentReader::ReadExactly(this->additional_info_.stream.get(), a.dataOffset + offset, buffer_a.data(), size);
+                CSegmentReader::ReadExactly(this->additional_info_.stream.get(), b.dataOffset + offset, buffer_b.data(), size);
+                if (memcmp(buffer_a.data(), buffer_b.data(), size) != 0)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        const auto sub_block_a = this->reader_->ReadSubBlock(a.index);
+        const auto sub_block_b = this->reader_->ReadSubBlock(b.index);
+        const void* data_a = nullptr;
+        const void* data_b = nullptr;
+        size_t size_a = 0;
+        size_t size_b = 0;
+        sub_block_a->DangerousGetRawData(ISubBlock::MemBlkType::Data, data_a, size_a);
+        sub_block_b->DangerousGetRawData(ISubBlock::MemBlkType::Data, data_b, size_b);
+        return size_a == size_b && memcmp(data_a, data_b, size_a) == 0;
+    }
+    catch (exception&)
+    {
+        return false;
+    }
+}
+
+void CCheckDuplicateSubBlockContent::ReportGroup(const std::vector<SubBlockItem>& items, const std::vector<int>& group)
+{
+    IResultGatherer::Finding finding(CCheckDuplicateSubBlockContent::kCheckType);
+    finding.severity = IResultGatherer::Severity::Warning;
+    stringstream ss;
+    ss << "subblocks ";
+    for (size_t i = 0; i < group.size() && i < kMaxNumberOfSubBlocksInFinding; ++i)
+    {
+        ss << (i > 0 ? ", #" : "#") << items[group[i]].index;
+    }
+
+    if (group.size() > kMaxNumberOfSubBlocksInFinding)
+    {
+        ss << ", ... (" << group.size() - kMaxNumberOfSubBlocksInFinding << " more)";
+    }
+
+    ss << " have identical content (" << items[group.front()].dataSize << " bytes)";
+    finding.information = ss.str();
+
+    stringstream ss_details;
+    for (size_t i = 0; i < group.size() && i < kMaxNumberOfSubBlocksInFinding; ++i)
+    {
+        const auto& item = items[group[i]];
+        ss_details << (i > 0 ? "; #" : "#") << item.index << ": \"" << GetSubblockAsString(item.info) << "\"";
+    }
+
+    finding.details = ss_details.str();
+    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+}
+
+/*static*/std::string CCheckDuplicateSubBlockContent::GetSubblockAsString(const libCZI::SubBlockInfo& subblock_info)
+{
+    stringstream ss;
+    ss << Utils::DimCoordinateToString(&subblock_info.coordinate);
+    if (subblock_info.IsMindexValid())
+    {
+        ss << " M=" << subblock_info.mIndex;
+    }
+
+    ss << " X=" << subblock_info.logicalRect.x << " Y=" << subblock_info.logicalRect.y
+        << " W=" << subblock_info.logicalRect.w << " H=" << subblock_info.logicalRect.h;
+    return ss.str();
+}
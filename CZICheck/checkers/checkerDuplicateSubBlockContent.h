@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <string>
+#include "checkerbase.h"
+
+/// This checker looks for subblocks with identical content (i.e. identical data, as stored in the file), which
+/// is an indication that the same tile was written more than once (e.g. with different coordinates or M-index).
+/// The data of all subblocks is hashed (reading the subblocks in the order of their position in the file), and
+/// subblocks with identical hashes are then compared byte by byte.
+class CCheckDuplicateSubBlockContent : public IChecker, CCheckerBase
+{
+private:
+    /// Information about a subblock and the location of its data.
+    struct SubBlockItem
+    {
+        int index{ 0 };
+        libCZI::DirectorySubBlockInfo info;
+        std::uint64_t dataOffset{ 0 };  ///< The file position of the subblock's data (only valid if reading from the stream).
+        std::uint64_t dataSize{ 0 };    ///< The size of the subblock's data in bytes.
+        std::uint64_t hash{ 0 };        ///< The hash of the subblock's data.
+    };
+public:
+    static const CZIChecks kCheckType = CZIChecks::DuplicateSubBlockContent;
+    static const char* kDisplayName;
+    static const char* kShortName;
+
+    CCheckDuplicateSubBlockContent(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        IResultGathererReport& result_gatherer,
+        const CheckerCreateInfo& additional_info);
+    void RunCheck() override;
+private:
+    std::vector<SubBlockItem> GetSubBlocksInFileOrder();
+    bool TryHashSubBlockData(SubBlockItem& item);
+    std::vector<std::vector<int>> GetGroupsWithIdenticalContent(const std::vector<SubBlockItem>& items);
+    bool IsDataEqual(const SubBlockItem& a, const SubBlockItem& b);
+    void ReportGroup(const std::vector<SubBlockItem>& items, const std::vector<int>& group);
+    static std::string GetSubblockAsString(const libCZI::SubBlockInfo& subblock_info);
+};
@@ -0,0 +1,270 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "checkerFileLayout.h"
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <memory>
+#include <unordered_map>
+
+using namespace libCZI;
+using namespace std;
+
+/*static*/const char* CCheckFileLayout::kDisplayName = "analyze the file-layout of the subblocks (locality of the data of a plane)";
+/*static*/const char* CCheckFileLayout::kShortName = "filelayout";
+
+namespace
+{
+    /// Groups with less subblocks than this are not considered when looking for fragmented groups.
+    constexpr int64_t kMinSubBlocksForFragmentation = 8;
+
+    /// Groups with a fragmentation score above this value are reported.
+    constexpr double kMaxFragmentationScore = 0.5;
+
+    /// The maximum number of fragmented groups listed in the details of the finding.
+    constexpr size_t kMaxGroupsInDetails = 10;
+
+    /// The key identifying a group of subblocks - the plane, the scene and the pyramid-layer.
+    struct GroupKey
+    {
+        CLayer0Planes::PlaneKey plane;
+        int sceneIndex;
+        int minification;
+
+        bool operator==(const GroupKey& other) const
+        {
+            return this->plane == other.plane && this->sceneIndex == other.sceneIndex && this->minification == other.minification;
+        }
+    };
+
+    struct GroupKeyHash
+    {
+        size_t operator()(const GroupKey& key) const
+        {
+            size_t value = CLayer0Planes::PlaneKeyHash()(key.plane);
+            value ^= std::hash<int>()(key.sceneIndex) + 0x9e3779b9 + (value << 6) + (value >> 2);
+            value ^= std::hash<int>()(key.minification) + 0x9e3779b9 + (value << 6) + (value >> 2);
+            return value;
+        }
+    };
+}
+
+CCheckFileLayout::CCheckFileLayout(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    IResultGathererReport& result_gatherer,
+    const CheckerCreateInfo& additional_info) :
+    CCheckerBase(reader, result_gatherer, additional_info)
+{
+}
+
+void CCheckFileLayout::RunCheck()
+{
+    this->result_gatherer_.StartCheck(CCheckFileLayout::kCheckType);
+
+    this->RunCheckDefaultExceptionHandling([this]()
+        {
+            const auto subblocks = this->GatherSubBlocks();
+            this->AnalyzeLayout(subblocks);
+            this->ReportFragmentedGroups();
+        });
+
+    if (this->additional_info_.collectStatistics)
+    {
+        this->ReportStatistics();
+    }
+
+    this->result_gatherer_.FinishCheck(CCheckFileLayout::kCheckType);
+}
+
+std::vector<CCheckFileLayout::SubBlockLocation> CCheckFileLayout::GatherSubBlocks()
+{
+    vector<SubBlockLocation> subblocks;
+    unordered_map<GroupKey, uint32_t, GroupKeyHash> group_for_key;
+    this->reader_->EnumerateSubBlocksEx(
+        [&](int, const DirectorySubBlockInfo& info)->bool
+        {
+            int scene_index;
+            if (!info.coordinate.TryGetPosition(DimensionIndex::S, &scene_index))
+            {
+                scene_index = CLayer0Planes::kNoSceneIndex;
+            }
+
+            const int minification = CLayer0Planes::GetMinification(info);
+            GroupKey key{ CLayer0Planes::PlaneKey(info.coordinate), scene_index, minification };
+            auto it = group_for_key.find(key);
+            if (it == group_for_key.end())
+            {
+                it = group_for_key.emplace(key, static_cast<uint32_t>(this->groups_.size())).first;
+                GroupLayout group;
+                group.coordinate = key.plane.ToCoordinate();
+                group.sceneIndex = scene_index;
+                group.minification = minification;
+                group.firstPosition = info.filePosition;
+                this->groups_.emplace_back(group);
+            }
+
+            subblocks.emplace_back(SubBlockLocation{ info.filePosition, it->second });
+            return true;
+        });
+
+    return subblocks;
+}
+
+void CCheckFileLayout::AnalyzeLayout(const std::vector<SubBlockLocation>& subblocks)
+{
+    // determine the file order of the subblocks (and the rank of each subblock in the file order)
+    vector<uint32_t> file_order(subblocks.size());
+    iota(file_order.begin(), file_order.end(), 0);
+    sort(
+        file_order.begin(),
+        file_order.end(),
+        [&](uint32_t a, uint32_t b)->bool
+        {
+            return subblocks[a].filePosition < subblocks[b].filePosition || (subblocks[a].filePosition == subblocks[b].filePosition && a < b);
+        });
+    vector<uint32_t> rank(subblocks.size());
+    for (size_t i = 0; i < file_order.size(); ++i)
+    {
+        rank[file_order[i]] = static_cast<uint32_t>(i);
+    }
+
+    // in file order - a new fragment starts whenever the preceding subblock belongs to a different group, and the
+    //  extent of a subblock reaches up to the next subblock (or to the end of the file for the last one)
+    for (size_t i = 0; i < file_order.size(); ++i)
+    {
+        const auto& subblock = subblocks[file_order[i]];
+        auto& group = this->groups_[subblock.group];
+        uint64_t end_position;
+        if (i + 1 < file_order.size())
+        {
+            end_position = subblocks[file_order[i + 1]].filePosition;
+        }
+        else
+        {
+            end_position = max(subblock.filePosition, this->additional_info_.totalFileSize);
+        }
+
+        if (i == 0 || subblocks[file_order[i - 1]].group != subblock.group)
+        {
+            ++group.fragments;
+        }
+
+        ++group.subBlocks;
+        group.firstPosition = min(group.firstPosition, subblock.filePosition);
+        group.endPosition = max(group.endPosition, end_position);
+        group.dataSize += end_position - subblock.filePosition;
+    }
+
+    // in directory order - a seek is required whenever the next subblock of a group does not immediately follow
+    //  the previous one in the file
+    vector<int64_t> last_rank(this->groups_.size(), -1);
+    for (size_t i = 0; i < subblocks.size(); ++i)
+    {
+        const uint32_t group_index = subblocks[i].group;
+        if (last_rank[group_index] < 0 || static_cast<int64_t>(rank[i]) != last_rank[group_index] + 1)
+        {
+            ++this->groups_[group_index].directoryOrderSeeks;
+        }
+
+        last_rank[group_index] = rank[i];
+    }
+}
+
+void CCheckFileLayout::ReportFragmentedGroups()
+{
+    vector<size_t> fragmented_groups;
+    int64_t seeks = 0;
+    for (size_t i = 0; i < this->groups_.size(); ++i)
+    {
+        const auto& group = this->groups_[i];
+        if (group.subBlocks >= kMinSubBlocksForFragmentation && group.GetFragmentationScore() > kMaxFragmentationScore)
+        {
+            fragmented_groups.push_back(i);
+            seeks += group.fragments;
+        }
+    }
+
+    if (fragmented_groups.empty())
+    {
+        return;
+    }
+
+    // the most fragmented groups are listed first
+    stable_sort(
+        fragmented_groups.begin(),
+        fragmented_groups.end(),
+        [this](size_t a, size_t b)->bool
+        {
+            return this->groups_[a].GetFragmentationScore() > this->groups_[b].GetFragmentationScore();
+        });
+
+    IResultGatherer::Finding finding(CCheckFileLayout::kCheckType);
+    finding.severity = IResultGatherer::Severity::Warning;
+    stringstream ss;
+    ss << fragmented_groups.size() << " of " << this->groups_.size() << " planes (per scene and pyramid-layer) are fragmented in the file, reading them requires "
+        << seeks << " seeks";
+    finding.information = ss.str();
+    ss = stringstream();
+    for (size_t i = 0; i < min(fragmented_groups.size(), kMaxGroupsInDetails); ++i)
+    {
+        const auto& group = this->groups_[fragmented_groups[i]];
+        if (i > 0)
+        {
+            ss << "; ";
+        }
+
+        ss << CCheckFileLayout::GroupToString(group) << ": " << group.subBlocks << " subblocks in " << group.fragments << " fragments (score "
+            << fixed << setprecision(2) << group.GetFragmentationScore() << "), " << group.directoryOrderSeeks << " seeks in directory order, "
+            << "span " << group.endPosition - group.firstPosition << " bytes for " << group.dataSize << " bytes of data";
+    }
+
+    if (fragmented_groups.size() > kMaxGroupsInDetails)
+    {
+        ss << "; ...";
+    }
+
+    finding.details = ss.str();
+    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+}
+
+void CCheckFileLayout::ReportStatistics()
+{
+    IResultGatherer::StatisticsTable table(CCheckFileLayout::kCheckType);
+    table.name = "file layout per plane";
+    table.columns = { "plane", "scene", "minification", "subblocks", "fragments", "seeks in directory order", "span", "data size", "fragmentation score" };
+    for (const auto& group : this->groups_)
+    {
+        table.rows.push_back({
+            Utils::DimCoordinateToString(&group.coordinate),
+            group.sceneIndex == CLayer0Planes::kNoSceneIndex ? string("none") : to_string(group.sceneIndex),
+            static_cast<int64_t>(group.minification),
+            group.subBlocks,
+            group.fragments,
+            group.directoryOrderSeeks,
+            static_cast<int64_t>(group.endPosition - group.firstPosition),
+            static_cast<int64_t>(group.dataSize),
+            group.GetFragmentationScore() });
+    }
+
+    this->result_gatherer_.ReportStatistics(table);
+}
+
+/*static*/std::string CCheckFileLayout::GroupToString(const GroupLayout& group)
+{
+    stringstream ss;
+    ss << "plane " << Utils::DimCoordinateToString(&group.coordinate);
+    if (group.sceneIndex != CLayer0Planes::kNoSceneIndex)
+    {
+        ss << " scene " << group.sceneIndex;
+    }
+
+    if (group.minification > 1)
+    {
+        ss << " minification " << group.minification;
+    }
+
+    return ss.str();
+}
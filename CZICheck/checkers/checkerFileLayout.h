@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "checkerbase.h"
+#include "layer0planes.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// This checker analyzes how the subblocks are laid out in the file, which determines how efficiently a plane can be
+/// read (e.g. by a viewer). Only the subblock-directory is used - the subblocks are grouped by plane, scene and
+/// pyramid-layer, and the file-positions of the subblocks are sorted. The extent of a subblock is taken to be the
+/// range up to the next subblock in the file. For each group, it is then determined:
+/// - the number of fragments, i.e. the number of contiguous runs of the group's subblocks in the file - which is the
+///   number of seeks required to read the group in file order,
+/// - the number of seeks required to read the group in the order of the subblock-directory,
+/// - the span of the group in the file compared to the size of its data.
+/// A fragmentation score (0 meaning "contiguous", 1 meaning "every subblock is a fragment of its own") is derived from
+/// the number of fragments, and a warning is reported if groups with a high fragmentation score are found.
+class CCheckFileLayout : public IChecker, CCheckerBase
+{
+private:
+    /// The layout of the subblocks of a plane (within a scene and a pyramid-layer).
+    struct GroupLayout
+    {
+        libCZI::CDimCoordinate coordinate;  ///< The plane coordinate (i.e. without the S-index).
+        int sceneIndex{ 0 };                ///< The scene index (or CLayer0Planes::kNoSceneIndex).
+        int minification{ 1 };              ///< The minification factor of the pyramid-layer (1 for pyramid-layer 0).
+        std::int64_t subBlocks{ 0 };        ///< The number of subblocks.
+        std::int64_t fragments{ 0 };        ///< The number of contiguous runs of subblocks in the file.
+        std::int64_t directoryOrderSeeks{ 0 };  ///< The number of seeks when reading in the order of the subblock-directory.
+        std::uint64_t firstPosition{ 0 };   ///< The file-position of the first subblock.
+        std::uint64_t endPosition{ 0 };     ///< The end of the last subblock.
+        std::uint64_t dataSize{ 0 };        ///< The sum of the extents of the subblocks.
+
+        /// Gets the fragmentation score, 0 meaning "contiguous", 1 meaning "every subblock is a fragment of its own".
+        [[nodiscard]] double GetFragmentationScore() const
+        {
+            return this->subBlocks > 1 ? static_cast<double>(this->fragments - 1) / static_cast<double>(this->subBlocks - 1) : 0.0;
+        }
+    };
+
+    /// A subblock with its file-position and the index of the group it belongs to.
+    struct SubBlockLocation
+    {
+        std::uint64_t filePosition;
+        std::uint32_t group;
+    };
+
+    std::vector<GroupLayout> groups_;
+public:
+    static const CZIChecks kCheckType = CZIChecks::FileLayoutLocality;
+    static const char* kDisplayName;
+    static const char* kShortName;
+
+    CCheckFileLayout(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        IResultGathererReport& result_gatherer,
+        const CheckerCreateInfo& additional_info);
+    void RunCheck() override;
+private:
+    std::vector<SubBlockLocation> GatherSubBlocks();
+    void AnalyzeLayout(const std::vector<SubBlockLocation>& subblocks);
+    void ReportFragmentedGroups();
+    void ReportStatistics();
+    static std::string GroupToString(const GroupLayout& group);
+};
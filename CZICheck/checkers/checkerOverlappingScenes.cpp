@@ -3,11 +3,13 @@
 // SPDX-License-Identifier: MIT
 
 #include "checkerOverlappingScenes.h"
+#include "rectangleoverlap.h"
 
 #include <algorithm>
 #include <vector>
 #include <memory>
 #include <map>
+#include <set>
 
 using namespace libCZI;
 using namespace std;
@@ -49,7 +51,7 @@ void CCheckOverlappingScenesOnLayer0::RunCheck()
                 {
                     // if there are overlaps found from checking the bounding-rectangles, we next check respective
                     // case more detailed - i.e. by checking the subblocks in question itself
-                    this->CheckForOverlappingSubblocksInDifferentScenes(subblock_statistics, overlapping_scenes);
+                    this->CheckForOverlappingSubblocksInDifferentScenes(overlapping_scenes);
                 }
             }
         });
@@ -86,62 +88,51 @@ void CCheckOverlappingScenesOnLayer0::RunCheck()
     return overlapping_scenes_found;
 }
 
-void CCheckOverlappingScenesOnLayer0::CheckForOverlappingSubblocksInDifferentScenes(
-    const libCZI::SubBlockStatistics& statistics,
-    const std::vector<ScenePair>& overlapping_scene_pairs)
+void CCheckOverlappingScenesOnLayer0::CheckForOverlappingSubblocksInDifferentScenes(const std::vector<ScenePair>& overlapping_scene_pairs)
 {
-    // copy the "dimension bounds" from the statistics, and clear the "S-dimension" in it
-    CDimBounds bounds_to_enumerate_planes(&statistics.dimBounds);
-    bounds_to_enumerate_planes.Clear(DimensionIndex::S);
-
-    // so, now enumerate all "plane-coordinates" within the "dim-bounds" of the document
-    Utils::EnumAllCoordinates(
-        bounds_to_enumerate_planes,
-        [&](std::uint64_t no, const libCZI::CDimCoordinate& coordinate)->bool
-        {
-            // and now, for each plane, iterate for every scene-pair (for which there is an overlap of
-            //  the bounding-rectangles)
-            for (const auto& pair : overlapping_scene_pairs)
-            {
-                this->CheckForOverlappingSubblocksInPlaneAndBetweenTwoScenes(&coordinate, pair);
-            }
+    set<int> scenes_of_interest;
+    for (const auto& pair : overlapping_scene_pairs)
+    {
+        scenes_of_interest.insert(pair.sceneIndex1);
+        scenes_of_interest.insert(pair.sceneIndex2);
+    }
 
-            return true;
+    // group the layer-0 subblocks of the scenes in question by plane (with one pass over the subblock-directory) - so
+    //  we only visit planes which actually exist (instead of enumerating all "plane-coordinates" within the "dim-bounds")
+    const auto planes = CLayer0Planes::Gather(
+        this->reader_,
+        [&](int scene_index)->bool
+        {
+            return scenes_of_interest.find(scene_index) != scenes_of_interest.end();
         });
+
+    // and now, for each plane, iterate for every scene-pair (for which there is an overlap of
+    //  the bounding-rectangles)
+    for (const auto& plane : planes)
+    {
+        for (const auto& pair : overlapping_scene_pairs)
+        {
+            this->CheckForOverlappingSubblocksInPlaneAndBetweenTwoScenes(plane, pair);
+        }
+    }
 }
 
-void CCheckOverlappingScenesOnLayer0::CheckForOverlappingSubblocksInPlaneAndBetweenTwoScenes(const IDimCoordinate* plane_coordinate, const ScenePair& pair)
+void CCheckOverlappingScenesOnLayer0::CheckForOverlappingSubblocksInPlaneAndBetweenTwoScenes(const CLayer0Planes::Plane& plane, const ScenePair& pair)
 {
-    std::vector<int> subblocks_of_plane_in_first_scene;
-    std::vector<int> subblocks_of_plane_in_second_scene;
-
-    // now, enumerate all subblocks within the specified plane, and then store the subblock-indices in to
-    //  vectors - one for the subblocks in the scene "pair.sceneIndex1" and one for "pair.sceneIndex2"
-    this->reader_->EnumSubset(
-        plane_coordinate,
-        nullptr,
-        true,
-        [&](int index, const SubBlockInfo& info)->bool
-        {
-            int s;
-            if (info.coordinate.TryGetPosition(DimensionIndex::S, &s))
-            {
-                if (s == pair.sceneIndex1)
-                {
-                    subblocks_of_plane_in_first_scene.emplace_back(index);
-                }
-                else if (s == pair.sceneIndex2)
-                {
-                    subblocks_of_plane_in_second_scene.emplace_back(index);
-                }
-            }
+    const auto first_scene = plane.subBlocksPerScene.find(pair.sceneIndex1);
+    const auto second_scene = plane.subBlocksPerScene.find(pair.sceneIndex2);
+    if (first_scene == plane.subBlocksPerScene.end() || second_scene == plane.subBlocksPerScene.end())
+    {
+        return;
+    }
 
-            return true;
-        });
+    const auto& subblocks_of_plane_in_first_scene = first_scene->second;
+    const auto& subblocks_of_plane_in_second_scene = second_scene->second;
+    const IDimCoordinate* plane_coordinate = &plane.coordinate;
 
     // and, now check whether there is an overlap of subblocks in the one list with the other
     vector< SubBlockPair> overlapping_pairs;
-    bool are_overlapping = this->AreOverlapping(
+    bool are_overlapping = CCheckOverlappingScenesOnLayer0::AreOverlapping(
         subblocks_of_plane_in_first_scene,
         subblocks_of_plane_in_second_scene,
         [&](int sbBlkIndexFirstScene, int sbBlkIndexSecondScene) -> bool
@@ -152,6 +143,16 @@ void CCheckOverlappingScenesOnLayer0::CheckForOverlappingSubblocksInPlaneAndBetw
 
     if (are_overlapping)
     {
+        // the pairs are reported in the order of the subblock indices (of the first scene, then of the second scene)
+        sort(
+            overlapping_pairs.begin(),
+            overlapping_pairs.end(),
+            [](const SubBlockPair& a, const SubBlockPair& b)->bool
+            {
+                return a.subBlockInFirstScene < b.subBlockInFirstScene ||
+                    (a.subBlockInFirstScene == b.subBlockInFirstScene && a.subBlockInSecondScene < b.subBlockInSecondScene);
+            });
+
         IResultGatherer::Finding finding(CCheckOverlappingScenesOnLayer0::kCheckType);
         finding.severity = IResultGatherer::Severity::Warning;
         stringstream ss;
@@ -177,36 +178,27 @@ void CCheckOverlappingScenesOnLayer0::CheckForOverlappingSubblocksInPlaneAndBetw
     }
 }
 
-bool CCheckOverlappingScenesOnLayer0::AreOverlapping(
-    const std::vector<int>& subblocks_of_plane_in_first_scene, 
-    const std::vector<int>& subblocks_of_plane_in_second_scene, 
-    const std::function<bool(int, int)>& report_overlapping_subblocks) const
+/*static*/bool CCheckOverlappingScenesOnLayer0::AreOverlapping(
+    const std::vector<CRectangleOverlap::Rectangle>& subblocks_of_plane_in_first_scene,
+    const std::vector<CRectangleOverlap::Rectangle>& subblocks_of_plane_in_second_scene,
+    const std::function<bool(int, int)>& report_overlapping_subblocks)
 {
     bool overlapping_subblocks_found = false;
 
     // now, check if any subblock in "subBlocksOfPlaneInFirstScene" is overlapping with any subblock in "subBlocksOfPlaneInSecondScene"
-    for (const auto subblock_index_first_scene : subblocks_of_plane_in_first_scene)
-    {
-        SubBlockInfo subblockInfo1;
-        this->reader_->TryGetSubBlockInfo(subblock_index_first_scene, &subblockInfo1);
-
-        for (const auto subblockIndexSecondScene : subblocks_of_plane_in_second_scene)
+    CRectangleOverlap::EnumOverlappingPairs(
+        subblocks_of_plane_in_first_scene,
+        subblocks_of_plane_in_second_scene,
+        [&](int subblock_index_first_scene, int subblock_index_second_scene, const IntRect&)->bool
         {
-            SubBlockInfo subblock_info2;
-            this->reader_->TryGetSubBlockInfo(subblockIndexSecondScene, &subblock_info2);
-            if (subblockInfo1.logicalRect.IntersectsWith(subblock_info2.logicalRect))
+            overlapping_subblocks_found = true;
+            if (report_overlapping_subblocks)
             {
-                overlapping_subblocks_found = true;
-                if (report_overlapping_subblocks)
-                {
-                    if (!report_overlapping_subblocks(subblock_index_first_scene, subblockIndexSecondScene))
-                    {
-                        break;
-                    }
-                }
+                return report_overlapping_subblocks(subblock_index_first_scene, subblock_index_second_scene);
             }
-        }
-    }
+
+            return false;
+        });
 
     return overlapping_subblocks_found;
 }
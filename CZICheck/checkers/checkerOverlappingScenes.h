@@ -8,6 +8,8 @@
 #include <memory>
 #include <map>
 #include "checkerbase.h"
+#include "layer0planes.h"
+#include "rectangleoverlap.h"
 
 /// This checker is about checking whether scenes are overlapping (on pyramid-layer 0).
 class CCheckOverlappingScenesOnLayer0 : public IChecker, CCheckerBase
@@ -51,22 +53,20 @@ private:
     /// specifies which scene-bounding-rectangles overlap, and subblocks in those scenes are
     /// checked here.
     ///
-    /// \param  statistics                The statistics of the document.
     /// \param  overlapping_scene_pairs   Vector with pairs of scene-indices which are to be checked.
-    void CheckForOverlappingSubblocksInDifferentScenes(
-        const libCZI::SubBlockStatistics& statistics,
-        const std::vector<ScenePair>& overlapping_scene_pairs);
+    void CheckForOverlappingSubblocksInDifferentScenes(const std::vector<ScenePair>& overlapping_scene_pairs);
 
     /// Check for overlapping subblocks within the specified plane and within the specified scenes.
     /// This method will also report a finding (in case it detected an overlap).
     ///
-    /// \param  plane_coordinate The plane coordinate.
-    /// \param  pair             The pair of scene indices to check.
-    void CheckForOverlappingSubblocksInPlaneAndBetweenTwoScenes(const libCZI::IDimCoordinate* plane_coordinate, const ScenePair& pair);
+    /// \param  plane   The plane (with its layer-0 subblocks grouped by scene).
+    /// \param  pair    The pair of scene indices to check.
+    void CheckForOverlappingSubblocksInPlaneAndBetweenTwoScenes(const CLayer0Planes::Plane& plane, const ScenePair& pair);
 
-    /// Determine if any pair of subblocks from the two vectors (containing subblock indices)
+    /// Determine if any pair of subblocks from the two vectors (containing subblock indices and their logical rectangles)
     /// are overlapping. If an overlapping pair is found, the pair is reported to the specified
-    /// functor. If the functor returns false, the search is immediately cancelled.
+    /// functor. If the functor returns false, the search is immediately cancelled. The pairs are
+    /// not reported in a specific order.
     ///
     /// \param  subblocks_of_plane_in_first_scene    The subblocks in first scene (to be checked for overlap with the other set of subblocks).
     /// \param  subblocks_of_plane_in_second_scene   The subblocks in second scene (to be checked for overlap with the other set of subblocks).
@@ -74,8 +74,8 @@ private:
     ///                                              value decides whether the search is continued or cancelled.
     ///
     /// \returns    True if at least one overlapping pair was found; false otherwise.
-    bool AreOverlapping(
-        const std::vector<int>& subblocks_of_plane_in_first_scene, 
-        const std::vector<int>& subblocks_of_plane_in_second_scene,
-        const std::function<bool(int, int)>& report_overlapping_subblocks) const;
+    static bool AreOverlapping(
+        const std::vector<CRectangleOverlap::Rectangle>& subblocks_of_plane_in_first_scene,
+        const std::vector<CRectangleOverlap::Rectangle>& subblocks_of_plane_in_second_scene,
+        const std::function<bool(int, int)>& report_overlapping_subblocks);
 };
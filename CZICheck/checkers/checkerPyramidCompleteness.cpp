@@ -0,0 +1,268 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "checkerPyramidCompleteness.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <memory>
+#include <set>
+
+using namespace libCZI;
+using namespace std;
+
+/*static*/const char* CCheckPyramidCompleteness::kDisplayName = "check that large scenes have a complete pyramid";
+/*static*/const char* CCheckPyramidCompleteness::kShortName = "pyramidcompleteness";
+
+namespace
+{
+    /// The maximum extent (width or height in pixels) of the coarsest pyramid-layer of a scene. If the coarsest
+    /// pyramid-layer is larger, the pyramid is considered insufficient for a zoomed-out view.
+    constexpr int kMaxExtentOfCoarsestLayer = 4096;
+
+    /// The fraction of the area of pyramid-layer 0 which may be left uncovered by a pyramid-layer (to allow for
+    /// rounding at the borders).
+    constexpr double kMaxUncoveredFraction = 0.01;
+}
+
+CCheckPyramidCompleteness::CCheckPyramidCompleteness(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    IResultGathererReport& result_gatherer,
+    const CheckerCreateInfo& additional_info) :
+    CCheckerBase(reader, result_gatherer, additional_info)
+{
+}
+
+void CCheckPyramidCompleteness::RunCheck()
+{
+    this->result_gatherer_.StartCheck(CCheckPyramidCompleteness::kCheckType);
+
+    this->RunCheckDefaultExceptionHandling([this]()
+        {
+            const auto subblock_statistics = this->reader_->GetStatistics();
+            for (const auto& scene : this->GatherScenes())
+            {
+                this->SummarizeScene(scene.first, scene.second);
+                this->CheckLayerCoverage(scene.first);
+
+                IntRect extent = subblock_statistics.boundingBoxLayer0Only;
+                const auto bounding_boxes = subblock_statistics.sceneBoundingBoxes.find(scene.first);
+                if (bounding_boxes != subblock_statistics.sceneBoundingBoxes.end())
+                {
+                    extent = bounding_boxes->second.boundingBoxLayer0;
+                }
+
+                this->CheckCoarsestLayer(scene.first, extent);
+            }
+        });
+
+    if (this->additional_info_.collectStatistics)
+    {
+        this->ReportStatistics();
+    }
+
+    this->result_gatherer_.FinishCheck(CCheckPyramidCompleteness::kCheckType);
+}
+
+std::map<int, CCheckPyramidCompleteness::Scene> CCheckPyramidCompleteness::GatherScenes()
+{
+    map<int, Scene> scenes;
+    this->reader_->EnumerateSubBlocks(
+        [&](int index, const SubBlockInfo& info)->bool
+        {
+            int scene_index;
+            if (!info.coordinate.TryGetPosition(DimensionIndex::S, &scene_index))
+            {
+                scene_index = CLayer0Planes::kNoSceneIndex;
+            }
+
+            auto& scene = scenes[scene_index];
+            CLayer0Planes::PlaneKey key(info.coordinate);
+            auto it = scene.planeIndex.find(key);
+            if (it == scene.planeIndex.end())
+            {
+                it = scene.planeIndex.emplace(key, scene.planes.size()).first;
+                scene.planes.emplace_back(PlaneOfScene{ key.ToCoordinate(), {} });
+            }
+
+            auto& layer = scene.planes[it->second].layers[CLayer0Planes::GetMinification(info)];
+            layer.subBlocks.emplace_back(CRectangleOverlap::Rectangle{ index, info.logicalRect });
+            uint8_t bytes_per_pixel;
+            if (Utils::TryGetBytesPerPixel(info.pixelType, bytes_per_pixel))
+            {
+                layer.decodedSize += static_cast<uint64_t>(info.physicalSize.w) * info.physicalSize.h * bytes_per_pixel;
+            }
+
+            return true;
+        });
+
+    return scenes;
+}
+
+void CCheckPyramidCompleteness::SummarizeScene(int scene_index, const Scene& scene)
+{
+    auto& summaries = this->layer_summaries_[scene_index];
+    set<int> minifications;
+    for (const auto& plane : scene.planes)
+    {
+        for (const auto& layer : plane.layers)
+        {
+            minifications.insert(layer.first);
+        }
+    }
+
+    for (const auto& plane : scene.planes)
+    {
+        const auto layer0 = plane.layers.find(1);
+        const uint64_t layer0_area = layer0 != plane.layers.end() ? CRectangleOverlap::CalculateCoverage(layer0->second.subBlocks).coveredArea : 0;
+        for (const int minification : minifications)
+        {
+            auto& summary = summaries[minification];
+            const auto layer = plane.layers.find(minification);
+            double uncovered_fraction = 0;
+            if (layer != plane.layers.end())
+            {
+                ++summary.planes;
+                summary.subBlocks += static_cast<int64_t>(layer->second.subBlocks.size());
+                if (layer->second.decodedSize > summary.maxDecodedSize)
+                {
+                    summary.maxDecodedSize = layer->second.decodedSize;
+                    summary.subBlocksOfMaxDecodedSize = static_cast<int64_t>(layer->second.subBlocks.size());
+                }
+
+                if (minification > 1 && layer0_area > 0)
+                {
+                    // the area of layer 0 not covered by this layer is the area covered by the union of both layers,
+                    //  minus the area covered by this layer
+                    vector<CRectangleOverlap::Rectangle> both_layers(layer0->second.subBlocks);
+                    both_layers.insert(both_layers.end(), layer->second.subBlocks.begin(), layer->second.subBlocks.end());
+                    const uint64_t uncovered_area =
+                        CRectangleOverlap::CalculateCoverage(both_layers).coveredArea - CRectangleOverlap::CalculateCoverage(layer->second.subBlocks).coveredArea;
+                    uncovered_fraction = static_cast<double>(uncovered_area) / static_cast<double>(layer0_area);
+                }
+            }
+            else if (layer0_area > 0)
+            {
+                // the layer is present in other planes of this scene, but not in this one
+                uncovered_fraction = 1;
+            }
+
+            if (uncovered_fraction > kMaxUncoveredFraction)
+            {
+                ++summary.incompletePlanes;
+                if (uncovered_fraction > summary.maxUncoveredFraction)
+                {
+                    summary.maxUncoveredFraction = uncovered_fraction;
+                    summary.worstPlane = plane.coordinate;
+                }
+            }
+        }
+    }
+}
+
+void CCheckPyramidCompleteness::CheckLayerCoverage(int scene_index)
+{
+    const auto& summaries = this->layer_summaries_[scene_index];
+    const auto layer0 = summaries.find(1);
+    if (layer0 == summaries.end())
+    {
+        return;
+    }
+
+    for (const auto& layer : summaries)
+    {
+        const auto& summary = layer.second;
+        if (layer.first == 1 || summary.incompletePlanes == 0)
+        {
+            continue;
+        }
+
+        IResultGatherer::Finding finding(CCheckPyramidCompleteness::kCheckType);
+        finding.severity = IResultGatherer::Severity::Warning;
+        stringstream ss;
+        ss << "the pyramid-layer with minification " << layer.first << " of " << CCheckPyramidCompleteness::GetSceneAsString(scene_index)
+            << " does not cover the extent of pyramid-layer 0 in " << summary.incompletePlanes << " of " << layer0->second.planes << " planes";
+        finding.information = ss.str();
+        ss = stringstream();
+        ss << "up to " << fixed << setprecision(1) << 100.0 * summary.maxUncoveredFraction << "% of the area of pyramid-layer 0 is not covered (in plane "
+            << Utils::DimCoordinateToString(&summary.worstPlane) << ")";
+        finding.details = ss.str();
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+    }
+}
+
+void CCheckPyramidCompleteness::CheckCoarsestLayer(int scene_index, const libCZI::IntRect& extent)
+{
+    const auto& summaries = this->layer_summaries_[scene_index];
+    if (summaries.empty() || !extent.IsValid())
+    {
+        return;
+    }
+
+    const int coarsest_minification = summaries.rbegin()->first;
+    const auto& coarsest_layer = summaries.rbegin()->second;
+    const int coarsest_width = extent.w / coarsest_minification;
+    const int coarsest_height = extent.h / coarsest_minification;
+    if (max(coarsest_width, coarsest_height) <= kMaxExtentOfCoarsestLayer)
+    {
+        return;
+    }
+
+    IResultGatherer::Finding finding(CCheckPyramidCompleteness::kCheckType);
+    finding.severity = IResultGatherer::Severity::Warning;
+    stringstream ss;
+    ss << CCheckPyramidCompleteness::GetSceneAsString(scene_index) << " (" << extent.w << "x" << extent.h << " pixels) ";
+    if (coarsest_minification == 1)
+    {
+        ss << "has no pyramid";
+    }
+    else
+    {
+        ss << "has no pyramid-layer small enough for an overview, the coarsest pyramid-layer has minification "
+            << coarsest_minification << " (" << coarsest_width << "x" << coarsest_height << " pixels)";
+    }
+
+    finding.information = ss.str();
+    ss = stringstream();
+    ss << "a full-extent thumbnail requires decoding " << coarsest_layer.subBlocksOfMaxDecodedSize << " subblocks with "
+        << coarsest_layer.maxDecodedSize << " bytes (per plane), the coarsest pyramid-layer should not be larger than "
+        << kMaxExtentOfCoarsestLayer << " pixels";
+    finding.details = ss.str();
+    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+}
+
+void CCheckPyramidCompleteness::ReportStatistics()
+{
+    IResultGatherer::StatisticsTable table(CCheckPyramidCompleteness::kCheckType);
+    table.name = "pyramid-layers per scene";
+    table.columns = { "scene", "minification", "planes", "subblocks", "incomplete planes", "decoded size per plane" };
+    for (const auto& scene : this->layer_summaries_)
+    {
+        for (const auto& layer : scene.second)
+        {
+            const auto& summary = layer.second;
+            table.rows.push_back({
+                scene.first == CLayer0Planes::kNoSceneIndex ? string("none") : to_string(scene.first),
+                static_cast<int64_t>(layer.first),
+                summary.planes,
+                summary.subBlocks,
+                summary.incompletePlanes,
+                static_cast<int64_t>(summary.maxDecodedSize) });
+        }
+    }
+
+    this->result_gatherer_.ReportStatistics(table);
+}
+
+/*static*/std::string CCheckPyramidCompleteness::GetSceneAsString(int scene_index)
+{
+    if (scene_index == CLayer0Planes::kNoSceneIndex)
+    {
+        return "the document (no scene)";
+    }
+
+    stringstream ss;
+    ss << "scene " << scene_index;
+    return ss.str();
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "checkerbase.h"
+#include "layer0planes.h"
+#include "rectangleoverlap.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// This checker examines the pyramid of each scene. When a large scene has no pyramid (or a pyramid-layer with missing
+/// tiles), viewers have to fall back to decoding pyramid-layer 0 for a zoomed-out view. The subblocks are grouped by
+/// scene, plane and pyramid-layer (as given by the ratio of the logical size to the physical size), and for every plane
+/// it is checked that each pyramid-layer covers the extent of pyramid-layer 0. In addition, it is checked whether the
+/// coarsest pyramid-layer of a scene is small enough to serve as an overview - if not, a warning is reported, giving an
+/// estimate of how many bytes have to be decoded for a full-extent thumbnail.
+class CCheckPyramidCompleteness : public IChecker, CCheckerBase
+{
+private:
+    /// The subblocks of a pyramid-layer within a plane.
+    struct LayerOfPlane
+    {
+        std::vector<CRectangleOverlap::Rectangle> subBlocks;  ///< The subblocks (with their logical rectangle).
+        std::uint64_t decodedSize{ 0 };                       ///< The size of the decoded data of all subblocks in bytes.
+    };
+
+    /// The pyramid-layers of a plane (within a scene), with the minification factor as key.
+    struct PlaneOfScene
+    {
+        libCZI::CDimCoordinate coordinate;
+        std::map<int, LayerOfPlane> layers;
+    };
+
+    /// The planes of a scene.
+    struct Scene
+    {
+        std::unordered_map<CLayer0Planes::PlaneKey, std::size_t, CLayer0Planes::PlaneKeyHash> planeIndex;
+        std::vector<PlaneOfScene> planes;
+    };
+
+    /// Summary of a pyramid-layer of a scene, accumulated over all planes.
+    struct LayerSummary
+    {
+        std::int64_t planes{ 0 };               ///< The number of planes in which the layer is present.
+        std::int64_t subBlocks{ 0 };            ///< The number of subblocks.
+        std::int64_t incompletePlanes{ 0 };     ///< The number of planes in which the layer does not cover pyramid-layer 0.
+        double maxUncoveredFraction{ 0 };       ///< The largest fraction of the layer-0 area not covered (in a plane).
+        libCZI::CDimCoordinate worstPlane;      ///< The plane with the largest fraction not covered.
+        std::uint64_t maxDecodedSize{ 0 };      ///< The largest size of the decoded data of the layer (in a plane).
+        std::int64_t subBlocksOfMaxDecodedSize{ 0 };   ///< The number of subblocks in the plane with the largest size of the decoded data.
+    };
+
+    std::map<int, std::map<int, LayerSummary>> layer_summaries_;
+public:
+    static const CZIChecks kCheckType = CZIChecks::PyramidCompleteness;
+    static const char* kDisplayName;
+    static const char* kShortName;
+
+    CCheckPyramidCompleteness(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        IResultGathererReport& result_gatherer,
+        const CheckerCreateInfo& additional_info);
+    void RunCheck() override;
+private:
+    std::map<int, Scene> GatherScenes();
+    void SummarizeScene(int scene_index, const Scene& scene);
+    void CheckLayerCoverage(int scene_index);
+    void CheckCoarsestLayer(int scene_index, const libCZI::IntRect& extent);
+    void ReportStatistics();
+    static std::string GetSceneAsString(int scene_index);
+};
@@ -0,0 +1,406 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "checkerPyramidContent.h"
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <memory>
+
+using namespace libCZI;
+using namespace std;
+
+/*static*/const char* CCheckPyramidContent::kDisplayName = "check that pyramid subblocks are consistent with pyramid-layer 0";
+/*static*/const char* CCheckPyramidContent::kShortName = "pyramidcontent";
+
+namespace
+{
+    /// The maximum number of pyramid subblocks which are examined. If there are more pyramid subblocks,
+    /// then a sample of this size is examined.
+    constexpr size_t kMaxNumberOfPyramidSubBlocksToExamine = 32;
+
+    /// The minimum PSNR (in dB) of a pyramid subblock compared to the downscaled layer-0 content. Since the
+    /// filter used for creating the pyramid is not known (and is usually not a box filter), the threshold
+    /// is chosen rather low, so that only significant differences are reported.
+    constexpr double kMinimumPsnr = 30;
+
+    /// The accumulated differences between the downscaled layer-0 content and the pyramid subblock.
+    struct DifferenceAccumulator
+    {
+        double sumOfSquaredDifferences{ 0 };
+        uint64_t valueCount{ 0 };
+        double maximumAbsoluteValue{ 0 };  ///< The maximum absolute value of the downscaled layer-0 content (used as peak value for floating point data).
+    };
+
+    /// The layer-0 content of the region covered by a pyramid subblock, downscaled to the size of the pyramid subblock
+    /// with a box filter - for each pixel of the pyramid subblock, the sum of the layer-0 pixel values falling into it
+    /// and the number of those layer-0 pixels are accumulated.
+    struct Layer0Accumulator
+    {
+        vector<double> sums;        ///< The sums, "width x height x components" values.
+        vector<uint32_t> counts;    ///< The number of layer-0 pixels, "width x height" values.
+    };
+
+    /// Gets the mapping of the coordinates of a line of the specified source size to the coordinates of a line of the
+    /// specified destination size for downscaling with a box filter - source pixel i falls into destination pixel
+    /// mapping[i]. The source size must not be less than the destination size, so that no destination pixel is empty.
+    vector<uint32_t> GetBoxFilterMapping(uint32_t source_size, uint32_t destination_size)
+    {
+        vector<uint32_t> mapping(source_size);
+        for (uint32_t i = 0; i < source_size; ++i)
+        {
+            mapping[i] = static_cast<uint32_t>(static_cast<uint64_t>(i) * destination_size / source_size);
+        }
+
+        return mapping;
+    }
+
+    /// Adds the pixels of a layer-0 subblock to the accumulator. Only the part of the subblock within the region
+    /// (given relative to the subblock) is added.
+    template <typename T>
+    void AccumulateLayer0SubBlock(
+        const uint8_t* layer0,
+        uint32_t layer0_stride,
+        const IntRect& region,
+        int32_t offset_x,
+        int32_t offset_y,
+        const vector<uint32_t>& column_mapping,
+        const vector<uint32_t>& row_mapping,
+        uint32_t destination_width,
+        int components,
+        Layer0Accumulator& accumulator)
+    {
+        for (int32_t y = region.y; y < region.y + region.h; ++y)
+        {
+            const T* source = reinterpret_cast<const T*>(layer0 + static_cast<size_t>(y) * layer0_stride);
+            const size_t destination_row_offset = static_cast<size_t>(row_mapping[y + offset_y]) * destination_width;
+            for (int32_t x = region.x; x < region.x + region.w; ++x)
+            {
+                const size_t destination_pixel = destination_row_offset + column_mapping[x + offset_x];
+                double* sums = accumulator.sums.data() + destination_pixel * components;
+                const T* source_pixel = source + static_cast<size_t>(x) * components;
+                for (int c = 0; c < components; ++c)
+                {
+                    sums[c] += static_cast<double>(source_pixel[c]);
+                }
+
+                ++accumulator.counts[destination_pixel];
+            }
+        }
+    }
+
+    /// Compares the accumulated (i.e. downscaled) layer-0 content with the pyramid subblock. Pixels of the pyramid
+    /// subblock which are not covered by layer 0 are skipped.
+    template <typename T>
+    void CompareWithPyramidSubBlock(
+        const Layer0Accumulator& layer0,
+        const uint8_t* pyramid,
+        uint32_t pyramid_stride,
+        uint32_t width,
+        uint32_t height,
+        int components,
+        DifferenceAccumulator& accumulator)
+    {
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            const T* pyramid_row = reinterpret_cast<const T*>(pyramid + static_cast<size_t>(y) * pyramid_stride);
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const size_t pixel = static_cast<size_t>(y) * width + x;
+                const uint32_t count = layer0.counts[pixel];
+                if (count == 0)
+                {
+                    continue;
+                }
+
+                for (int c = 0; c < components; ++c)
+                {
+                    const double mean = layer0.sums[pixel * components + c] / count;
+                    const double difference = mean - static_cast<double>(pyramid_row[static_cast<size_t>(x) * components + c]);
+                    accumulator.sumOfSquaredDifferences += difference * difference;
+                    accumulator.maximumAbsoluteValue = max(accumulator.maximumAbsoluteValue, abs(mean));
+                }
+
+                accumulator.valueCount += components;
+            }
+        }
+    }
+
+    int GetNumberOfComponents(PixelType pixel_type)
+    {
+        switch (pixel_type)  // NOLINT(clang-diagnostic-switch-enum)
+        {
+        case PixelType::Bgr24:
+        case PixelType::Bgr48:
+            return 3;
+        case PixelType::Bgra32:
+            return 4;
+        default:
+            return 1;
+        }
+    }
+}
+
+CCheckPyramidContent::CCheckPyramidContent(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    IResultGathererReport& result_gatherer,
+    const CheckerCreateInfo& additional_info) :
+    CCheckerBase(reader, result_gatherer, additional_info)
+{
+}
+
+void CCheckPyramidContent::RunCheck()
+{
+    this->result_gatherer_.StartCheck(CCheckPyramidContent::kCheckType);
+
+    this->RunCheckDefaultExceptionHandling([this]()
+        {
+            for (const int index : this->GetPyramidSubBlocksToExamine())
+            {
+                SubBlockInfo info;
+                if (!this->reader_->TryGetSubBlockInfo(index, &info))
+                {
+                    continue;
+                }
+
+                const auto result = this->CompareWithLayer0(index, info);
+                if (result.compared && result.psnr < kMinimumPsnr)
+                {
+                    IResultGatherer::Finding finding(CCheckPyramidContent::kCheckType);
+                    finding.severity = IResultGatherer::Severity::Warning;
+                    stringstream ss;
+                    ss << "pyramid subblock #" << index << " differs from the content of pyramid-layer 0 (PSNR: " << fixed << setprecision(1) << result.psnr << " dB)";
+                    finding.information = ss.str();
+                    stringstream ss_details;
+                    ss_details << "\"" << Utils::DimCoordinateToString(&info.coordinate) << "\", logical rect: (" << info.logicalRect.x << "," << info.logicalRect.y << ","
+                        << info.logicalRect.w << "," << info.logicalRect.h << "), physical size: " << info.physicalSize.w << "x" << info.physicalSize.h
+                        << ", minimum PSNR expected: " << kMinimumPsnr << " dB";
+                    finding.details = ss_details.str();
+                    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+                }
+            }
+        });
+
+    this->result_gatherer_.FinishCheck(CCheckPyramidContent::kCheckType);
+}
+
+std::vector<int> CCheckPyramidContent::GetPyramidSubBlocksToExamine()
+{
+    vector<int> pyramid_subblocks;
+    this->reader_->EnumerateSubBlocks(
+        [&](int index, const SubBlockInfo& info)->bool
+        {
+            // a pyramid subblock is identified by its logical size being different from its physical size (and we
+            //  expect the logical size to be larger)
+            if ((info.logicalRect.w != static_cast<int32_t>(info.physicalSize.w) || info.logicalRect.h != static_cast<int32_t>(info.physicalSize.h)) &&
+                info.physicalSize.w > 0 && info.physicalSize.h > 0 &&
+                info.logicalRect.w >= static_cast<int32_t>(info.physicalSize.w) && info.logicalRect.h >= static_cast<int32_t>(info.physicalSize.h) &&
+                CCheckPyramidContent::IsPixelTypeSupported(info.pixelType))
+            {
+                pyramid_subblocks.push_back(index);
+            }
+
+            return true;
+        });
+
+    if (pyramid_subblocks.size() <= kMaxNumberOfPyramidSubBlocksToExamine)
+    {
+        return pyramid_subblocks;
+    }
+
+    // take a stratified sample - the pyramid subblocks (in the order of the subblock-directory) are divided into
+    //  strata of equal size, and the subblock in the middle of each stratum is chosen
+    vector<int> sample;
+    sample.reserve(kMaxNumberOfPyramidSubBlocksToExamine);
+    const size_t count = pyramid_subblocks.size();
+    for (size_t i = 0; i < kMaxNumberOfPyramidSubBlocksToExamine; ++i)
+    {
+        const size_t stratum_start = i * count / kMaxNumberOfPyramidSubBlocksToExamine;
+        const size_t stratum_end = (i + 1) * count / kMaxNumberOfPyramidSubBlocksToExamine;
+        sample.push_back(pyramid_subblocks[(stratum_start + stratum_end) / 2]);
+    }
+
+    return sample;
+}
+
+std::vector<int> CCheckPyramidContent::GetLayer0SubBlocks(const libCZI::SubBlockInfo& info)
+{
+    int scene_index;
+    const bool has_scene_index = info.coordinate.TryGetPosition(DimensionIndex::S, &scene_index);
+    vector<int> layer0_subblocks;
+    this->reader_->EnumSubset(
+        &info.coordinate,
+        &info.logicalRect,
+        true,
+        [&](int index, const SubBlockInfo& layer0_info)->bool
+        {
+            int layer0_scene_index;
+            if (!has_scene_index || (layer0_info.coordinate.TryGetPosition(DimensionIndex::S, &layer0_scene_index) && layer0_scene_index == scene_index))
+            {
+                layer0_subblocks.push_back(index);
+            }
+
+            return true;
+        });
+
+    return layer0_subblocks;
+}
+
+CCheckPyramidContent::ComparisonResult CCheckPyramidContent::CompareWithLayer0(int index, const libCZI::SubBlockInfo& info)
+{
+    ComparisonResult result;
+
+    // problems with reading or decoding a subblock are not reported here - this is the business of the checker 'subblkbitmapvalid'
+    try
+    {
+        const auto layer0_subblocks = this->GetLayer0SubBlocks(info);
+        if (layer0_subblocks.empty())
+        {
+            return result;
+        }
+
+        const auto pyramid_bitmap = this->reader_->ReadSubBlock(index)->CreateBitmap();
+        if (pyramid_bitmap->GetPixelType() != info.pixelType ||
+            pyramid_bitmap->GetSize().w != info.physicalSize.w ||
+            pyramid_bitmap->GetSize().h != info.physicalSize.h)
+        {
+            return result;
+        }
+
+        // the accumulator is of the size of the pyramid subblock (and not of the region it covers on layer 0), but
+        //  it is still larger than the pyramid subblock itself, so we reserve the memory for it with the memory governor
+        const int components = GetNumberOfComponents(info.pixelType);
+        const size_t pixel_count = static_cast<size_t>(info.physicalSize.w) * info.physicalSize.h;
+        CMemoryGovernor::Reservation reservation;
+        if (this->additional_info_.memoryGovernor &&
+            !this->additional_info_.memoryGovernor->Reserve(CZIChecksToString(CCheckPyramidContent::kCheckType), pixel_count * (components * sizeof(double) + sizeof(uint32_t)), reservation))
+        {
+            return result;
+        }
+
+        Layer0Accumulator layer0;
+        layer0.sums.resize(pixel_count * components);
+        layer0.counts.resize(pixel_count);
+        const auto column_mapping = GetBoxFilterMapping(info.logicalRect.w, info.physicalSize.w);
+        const auto row_mapping = GetBoxFilterMapping(info.logicalRect.h, info.physicalSize.h);
+
+        // every layer-0 subblock is decoded only once, and its pixels are added to the accumulator - where layer-0
+        //  subblocks overlap, all of them contribute (and not only the top-most one as with the tile accessor), which is
+        //  negligible for the purpose of this comparison
+        for (const int layer0_index : layer0_subblocks)
+        {
+            const auto layer0_subblock = this->reader_->ReadSubBlock(layer0_index);
+            const auto& layer0_info = layer0_subblock->GetSubBlockInfo();
+            const auto layer0_bitmap = layer0_subblock->CreateBitmap();
+            if (layer0_bitmap->GetPixelType() != info.pixelType ||
+                static_cast<int32_t>(layer0_bitmap->GetSize().w) != layer0_info.logicalRect.w ||
+                static_cast<int32_t>(layer0_bitmap->GetSize().h) != layer0_info.logicalRect.h)
+            {
+                continue;
+            }
+
+            // the part of the layer-0 subblock within the region covered by the pyramid subblock (relative to the layer-0 subblock)
+            IntRect region = layer0_info.logicalRect.Intersect(info.logicalRect);
+            if (!region.IsValid())
+            {
+                continue;
+            }
+
+            region.x -= layer0_info.logicalRect.x;
+            region.y -= layer0_info.logicalRect.y;
+            const int32_t offset_x = layer0_info.logicalRect.x - info.logicalRect.x;
+            const int32_t offset_y = layer0_info.logicalRect.y - info.logicalRect.y;
+            ScopedBitmapLockerSP layer0_locker{ layer0_bitmap };
+            const auto* layer0_data = static_cast<const uint8_t*>(layer0_locker.ptrDataRoi);
+            switch (info.pixelType)  // NOLINT(clang-diagnostic-switch-enum)
+            {
+            case PixelType::Gray8:
+            case PixelType::Bgr24:
+            case PixelType::Bgra32:
+                AccumulateLayer0SubBlock<uint8_t>(layer0_data, layer0_locker.stride, region, offset_x, offset_y, column_mapping, row_mapping, info.physicalSize.w, components, layer0);
+                break;
+            case PixelType::Gray16:
+            case PixelType::Bgr48:
+                AccumulateLayer0SubBlock<uint16_t>(layer0_data, layer0_locker.stride, region, offset_x, offset_y, column_mapping, row_mapping, info.physicalSize.w, components, layer0);
+                break;
+            case PixelType::Gray32Float:
+                AccumulateLayer0SubBlock<float>(layer0_data, layer0_locker.stride, region, offset_x, offset_y, column_mapping, row_mapping, info.physicalSize.w, components, layer0);
+                break;
+            default:
+                return result;
+            }
+        }
+
+        DifferenceAccumulator accumulator;
+        ScopedBitmapLockerSP pyramid_locker{ pyramid_bitmap };
+        const auto* pyramid = static_cast<const uint8_t*>(pyramid_locker.ptrDataRoi);
+        switch (info.pixelType)  // NOLINT(clang-diagnostic-switch-enum)
+        {
+        case PixelType::Gray8:
+        case PixelType::Bgr24:
+        case PixelType::Bgra32:
+            CompareWithPyramidSubBlock<uint8_t>(layer0, pyramid, pyramid_locker.stride, info.physicalSize.w, info.physicalSize.h, components, accumulator);
+            break;
+        case PixelType::Gray16:
+        case PixelType::Bgr48:
+            CompareWithPyramidSubBlock<uint16_t>(layer0, pyramid, pyramid_locker.stride, info.physicalSize.w, info.physicalSize.h, components, accumulator);
+            break;
+        case PixelType::Gray32Float:
+            CompareWithPyramidSubBlock<float>(layer0, pyramid, pyramid_locker.stride, info.physicalSize.w, info.physicalSize.h, components, accumulator);
+            break;
+        default:
+            return result;
+        }
+
+        if (accumulator.valueCount == 0)
+        {
+            return result;
+        }
+
+        // for integer pixel types, the peak value is the maximum value of the pixel type - for floating point data we
+        //  use the maximum (absolute) value of the layer-0 content
+        double peak;
+        switch (info.pixelType)  // NOLINT(clang-diagnostic-switch-enum)
+        {
+        case PixelType::Gray16:
+        case PixelType::Bgr48:
+            peak = (numeric_limits<uint16_t>::max)();
+            break;
+        case PixelType::Gray32Float:
+            peak = accumulator.maximumAbsoluteValue > 0 ? accumulator.maximumAbsoluteValue : 1;
+            break;
+        default:
+            peak = (numeric_limits<uint8_t>::max)();
+            break;
+        }
+
+        const double mean_squared_error = accumulator.sumOfSquaredDifferences / static_cast<double>(accumulator.valueCount);
+        result.psnr = mean_squared_error > 0 ? 10 * log10(peak * peak / mean_squared_error) : numeric_limits<double>::infinity();
+        result.compared = true;
+    }
+    catch (exception&)
+    {
+        result.compared = false;
+    }
+
+    return result;
+}
+
+/*static*/bool CCheckPyramidContent::IsPixelTypeSupported(libCZI::PixelType pixel_type)
+{
+    switch (pixel_type)  // NOLINT(clang-diagnostic-switch-enum)
+    {
+    case PixelType::Gray8:
+    case PixelType::Gray16:
+    case PixelType::Bgr24:
+    case PixelType::Bgr48:
+    case PixelType::Bgra32:
+    case PixelType::Gray32Float:
+        return true;
+    default:
+        return false;
+    }
+}
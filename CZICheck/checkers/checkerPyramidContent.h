@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <string>
+#include "checkerbase.h"
+
+/// This checker compares the content of pyramid subblocks with the content of pyramid-layer 0. For a sample
+/// of pyramid subblocks (i.e. subblocks where the logical size differs from the physical size), the layer-0
+/// subblocks within the same region are decoded (each of them once), downscaled to the size of the pyramid subblock
+/// (with a box filter), and compared with the pyramid subblock by calculating the PSNR (peak signal-to-noise ratio). If the PSNR
+/// is below a threshold, a warning is reported.
+class CCheckPyramidContent : public IChecker, CCheckerBase
+{
+private:
+    /// The result of comparing a pyramid subblock with layer 0.
+    struct ComparisonResult
+    {
+        bool compared{ false };     ///< Whether the comparison could be carried out.
+        double psnr{ 0 };           ///< The PSNR in dB (infinity if the content is identical).
+    };
+public:
+    static const CZIChecks kCheckType = CZIChecks::PyramidSubBlocksConsistentWithLayer0;
+    static const char* kDisplayName;
+    static const char* kShortName;
+
+    CCheckPyramidContent(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        IResultGathererReport& result_gatherer,
+        const CheckerCreateInfo& additional_info);
+    void RunCheck() override;
+private:
+    std::vector<int> GetPyramidSubBlocksToExamine();
+    ComparisonResult CompareWithLayer0(int index, const libCZI::SubBlockInfo& info);
+    std::vector<int> GetLayer0SubBlocks(const libCZI::SubBlockInfo& info);
+    static bool IsPixelTypeSupported(libCZI::PixelType pixel_type);
+};
@@ -5,6 +5,7 @@
 #include "checkerSamePixeltypePerChannel.h"
 
 #include <algorithm>
+#include <sstream>
 #include <vector>
 #include <memory>
 
@@ -14,6 +15,12 @@ using namespace std;
 /*static*/const char* CCheckSamePixeltypePerChannel::kDisplayName = "check that the subblocks of a channel have the same pixeltype";
 /*static*/const char* CCheckSamePixeltypePerChannel::kShortName = "samepixeltypeperchannel";
 
+namespace
+{
+    /// The maximum number of subblocks (with a pixeltype different from the channel's) listed in the details of a finding.
+    constexpr size_t kMaxNumberOfSubBlocksInDetails = 20;
+}
+
 CCheckSamePixeltypePerChannel::CCheckSamePixeltypePerChannel(
     const std::shared_ptr<libCZI::ICZIReader>& reader,
     IResultGathererReport& result_gatherer,
@@ -36,44 +43,85 @@ void CCheckSamePixeltypePerChannel::RunCheck()
             //  the same pixel type.
             if (statistics.dimBounds.TryGetInterval(DimensionIndex::C, &start_c, &size_c))
             {
-                for (int c = start_c; c < start_c + size_c; ++c)
-                {
-                    this->CheckIfSamePixeltypeInChannel(c);
-                }
+                this->CheckIfSamePixeltypeInChannels(start_c, size_c);
             }
         });
 
     this->result_gatherer_.FinishCheck(CCheckSamePixeltypePerChannel::kCheckType);
 }
 
-void CCheckSamePixeltypePerChannel::CheckIfSamePixeltypeInChannel(int c)
+void CCheckSamePixeltypePerChannel::CheckIfSamePixeltypeInChannels(int start_c, int size_c)
 {
-    CDimCoordinate plane_coordinate({ { DimensionIndex::C, c } });
-    PixelType pixeltype{ PixelType::Invalid };
-    this->reader_->EnumSubset(
-        &plane_coordinate,
-        nullptr,
-        false,
+    // with one pass over all subblocks, we determine the pixeltype of each channel (which is the pixeltype of the
+    //  first subblock of the channel) and gather the subblocks which have a different pixeltype
+    vector<ChannelInfo> channels(size_c);
+    this->reader_->EnumerateSubBlocks(
         [&](int index, const SubBlockInfo& info)->bool
         {
-            if (pixeltype != PixelType::Invalid)
+            int c;
+            if (!info.coordinate.TryGetPosition(DimensionIndex::C, &c) || c < start_c || c >= start_c + size_c)
             {
-                if (info.pixelType != pixeltype)
-                {
-                    IResultGatherer::Finding finding(CCheckSamePixeltypePerChannel::kCheckType);
-                    finding.severity = IResultGatherer::Severity::Warning;
-                    stringstream ss;
-                    ss << "pixeltype of subblock #" << index << " (" << Utils::PixelTypeToInformalString(info.pixelType) <<
-                        ") differs from the pixeltype determined for channel " << c << " (" << Utils::PixelTypeToInformalString(pixeltype) << ")";
-                    finding.information = ss.str();
-                    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
-                }
+                return true;
             }
-            else
+
+            auto& channel = channels[c - start_c];
+            if (channel.pixelType == PixelType::Invalid)
             {
-                pixeltype = info.pixelType;
+                channel.pixelType = info.pixelType;
+            }
+            else if (info.pixelType != channel.pixelType)
+            {
+                if (channel.mismatches.size() < kMaxNumberOfSubBlocksInDetails)
+                {
+                    channel.mismatches.emplace_back(index, info.pixelType);
+                }
+
+                ++channel.mismatchCount;
             }
 
             return true;
         });
+
+    for (int c = start_c; c < start_c + size_c; ++c)
+    {
+        const auto& channel = channels[c - start_c];
+        if (channel.mismatchCount > 0)
+        {
+            this->ReportChannelWithMismatches(c, channel);
+        }
+    }
+}
+
+void CCheckSamePixeltypePerChannel::ReportChannelWithMismatches(int c, const ChannelInfo& channel)
+{
+    IResultGatherer::Finding finding(CCheckSamePixeltypePerChannel::kCheckType);
+    finding.severity = IResultGatherer::Severity::Warning;
+    stringstream ss;
+    if (channel.mismatchCount == 1)
+    {
+        ss << "pixeltype of subblock #" << channel.mismatches.front().first << " (" << Utils::PixelTypeToInformalString(channel.mismatches.front().second) <<
+            ") differs from the pixeltype determined for channel " << c << " (" << Utils::PixelTypeToInformalString(channel.pixelType) << ")";
+    }
+    else
+    {
+        ss << "pixeltype of " << channel.mismatchCount << " subblocks differs from the pixeltype determined for channel " << c <<
+            " (" << Utils::PixelTypeToInformalString(channel.pixelType) << ")";
+    }
+
+    finding.information = ss.str();
+
+    stringstream ss_details;
+    ss_details << "subblocks with a different pixeltype: ";
+    for (size_t i = 0; i < channel.mismatches.size(); ++i)
+    {
+        ss_details << (i > 0 ? ", #" : "#") << channel.mismatches[i].first << " (" << Utils::PixelTypeToInformalString(channel.mismatches[i].second) << ")";
+    }
+
+    if (channel.mismatchCount > channel.mismatches.size())
+    {
+        ss_details << ", ... (" << channel.mismatchCount - channel.mismatches.size() << " more)";
+    }
+
+    finding.details = ss_details.str();
+    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
 }
@@ -5,7 +5,10 @@
 #pragma once
 
 #include "checkerbase.h"
+#include <cstdint>
 #include <memory>
+#include <utility>
+#include <vector>
 
 /// This checker checks whether the pixel types of all subblocks with the same
 /// C-index is the same.
@@ -24,5 +27,14 @@ public:
         const CheckerCreateInfo& additional_info);
     void RunCheck() override;
 private:
-    void CheckIfSamePixeltypeInChannel(int c);
+    /// Information about a channel, gathered while enumerating the subblocks.
+    struct ChannelInfo
+    {
+        libCZI::PixelType pixelType{ libCZI::PixelType::Invalid };    ///< The pixeltype of the channel (i.e. of its first subblock).
+        std::uint64_t mismatchCount{ 0 };                             ///< The number of subblocks with a different pixeltype.
+        std::vector<std::pair<int, libCZI::PixelType>> mismatches;    ///< The first few subblocks (index and pixeltype) with a different pixeltype.
+    };
+
+    void CheckIfSamePixeltypeInChannels(int start_c, int size_c);
+    void ReportChannelWithMismatches(int c, const ChannelInfo& channel);
 };
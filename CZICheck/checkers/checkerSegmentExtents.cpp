@@ -0,0 +1,349 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "checkerSegmentExtents.h"
+#include "../segmentreader.h"
+#include <algorithm>
+#include <exception>
+#include <sstream>
+#include <memory>
+
+using namespace libCZI;
+using namespace std;
+
+namespace
+{
+    // The segment-headers are read with a single read-operation as long as the range to be read does not exceed
+    //  this size.
+    constexpr uint64_t kMaxBatchedReadSize = 64 * 1024;
+
+    /// The maximum number of segments (overlapping with a segment) listed in the details of a finding.
+    constexpr size_t kMaxNumberOfSegmentsInDetails = 20;
+}
+
+/*static*/const char* CCheckSegmentExtents::kDisplayName = "check that the segments are within the file and do not overlap";
+/*static*/const char* CCheckSegmentExtents::kShortName = "segmentextents";
+
+CCheckSegmentExtents::CCheckSegmentExtents(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    IResultGathererReport& result_gatherer,
+    const CheckerCreateInfo& additional_info) :
+    CCheckerBase(reader, result_gatherer, additional_info)
+{
+}
+
+void CCheckSegmentExtents::RunCheck()
+{
+    this->result_gatherer_.StartCheck(CCheckSegmentExtents::kCheckType);
+
+    this->RunCheckDefaultExceptionHandling([this]()
+        {
+            if (!this->additional_info_.stream)
+            {
+                return;
+            }
+
+            auto segments = this->GatherSegments();
+            auto extents = this->DetermineExtents(segments);
+            this->CheckForOverlappingExtents(extents);
+        });
+
+    this->result_gatherer_.FinishCheck(CCheckSegmentExtents::kCheckType);
+}
+
+std::vector<CCheckSegmentExtents::Segment> CCheckSegmentExtents::GatherSegments()
+{
+    vector<Segment> segments;
+    CSegmentReader::FileHeaderInfo file_header_info;
+    try
+    {
+        file_header_info = CSegmentReader::ReadFileHeaderInfo(this->additional_info_.stream.get());
+    }
+    catch (exception& ex)
+    {
+        this->ReportFatal("The file-header is invalid", ex.what());
+        return segments;
+    }
+
+    segments.emplace_back(Segment{ SegmentKind::FileHeader, 0, 0 });
+    if (file_header_info.subBlockDirectoryPosition != 0)
+    {
+        segments.emplace_back(Segment{ SegmentKind::SubBlockDirectory, 0, static_cast<uint64_t>(file_header_info.subBlockDirectoryPosition) });
+    }
+
+    if (file_header_info.metadataPosition != 0)
+    {
+        segments.emplace_back(Segment{ SegmentKind::Metadata, 0, static_cast<uint64_t>(file_header_info.metadataPosition) });
+    }
+
+    this->reader_->EnumerateSubBlocksEx(
+        [&](int index, const DirectorySubBlockInfo& info)->bool
+        {
+            segments.emplace_back(Segment{ SegmentKind::SubBlock, index, info.filePosition });
+            return true;
+        });
+
+    if (file_header_info.attachmentDirectoryPosition != 0)
+    {
+        const uint64_t attachment_directory_position = static_cast<uint64_t>(file_header_info.attachmentDirectoryPosition);
+        segments.emplace_back(Segment{ SegmentKind::AttachmentDirectory, 0, attachment_directory_position });
+        vector<CSegmentReader::AttachmentEntry> entries;
+        try
+        {
+            entries = CSegmentReader::ReadAttachmentDirectory(this->additional_info_.stream.get(), attachment_directory_position, this->additional_info_.totalFileSize);
+        }
+        catch (exception& ex)
+        {
+            IResultGatherer::Finding finding(CCheckSegmentExtents::kCheckType);
+            finding.severity = IResultGatherer::Severity::Warning;
+            finding.information = "The attachment-directory could not be read, the attachment-segments are not checked";
+            finding.details = ex.what();
+            this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        }
+
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            if (entries[i].filePart == 0 && entries[i].filePosition >= 0)
+            {
+                segments.emplace_back(Segment{ SegmentKind::Attachment, static_cast<int>(i), static_cast<uint64_t>(entries[i].filePosition) });
+            }
+        }
+    }
+
+    return segments;
+}
+
+std::vector<CCheckSegmentExtents::Extent> CCheckSegmentExtents::DetermineExtents(std::vector<Segment>& segments)
+{
+    const uint64_t total_file_size = this->additional_info_.totalFileSize;
+    if (total_file_size > 0)
+    {
+        // segments which start beyond the end of the file are reported (and not considered further)
+        auto it = remove_if(
+            segments.begin(),
+            segments.end(),
+            [&](const Segment& segment)->bool
+            {
+                if (segment.position + CSegmentReader::kSegmentHeaderSize > total_file_size)
+                {
+                    ostringstream string_stream;
+                    string_stream << "position of " << CCheckSegmentExtents::SegmentToString(segment) << " (=" << segment.position << ") is beyond filesize (=" << total_file_size << ")";
+                    this->ReportFatal(string_stream.str(), string());
+                    return true;
+                }
+
+                return false;
+            });
+        segments.erase(it, segments.end());
+    }
+
+    // the segment-headers are read in the order of their file-position
+    sort(
+        segments.begin(),
+        segments.end(),
+        [](const Segment& a, const Segment& b)->bool
+        {
+            if (a.position != b.position)
+            {
+                return a.position < b.position;
+            }
+
+            return a.kind < b.kind || (a.kind == b.kind && a.index < b.index);
+        });
+
+    vector<uint64_t> positions;
+    positions.reserve(segments.size());
+    for (const auto& segment : segments)
+    {
+        positions.emplace_back(segment.position);
+    }
+
+    vector<Extent> extents;
+    extents.reserve(segments.size());
+    CSegmentReader::ReadBatched(
+        this->additional_info_.stream.get(),
+        positions,
+        static_cast<size_t>(CSegmentReader::kSegmentHeaderSize),
+        kMaxBatchedReadSize,
+        [&](size_t i, const uint8_t* data, const char* error_message)
+        {
+            const auto& segment = segments[i];
+            if (data == nullptr)
+            {
+                this->ReportFatal("The segment-header of " + CCheckSegmentExtents::SegmentToString(segment) + " could not be read", error_message);
+                return;
+            }
+
+            CSegmentReader::SegmentHeader header;
+            try
+            {
+                header = CSegmentReader::ParseSegmentHeader(data, segment.position);
+            }
+            catch (exception& ex)
+            {
+                this->ReportFatal("The segment-header of " + CCheckSegmentExtents::SegmentToString(segment) + " is invalid", ex.what());
+                return;
+            }
+
+            const char* expected_id = CCheckSegmentExtents::GetExpectedSegmentId(segment.kind);
+            if (header.id != expected_id)
+            {
+                ostringstream string_stream;
+                string_stream << CCheckSegmentExtents::SegmentToString(segment) << " at position " << segment.position << " has id \"" << header.id << "\", expected \"" << expected_id << "\"";
+                this->ReportFatal(string_stream.str(), string());
+                return;
+            }
+
+            if (header.usedSize > header.allocatedSize)
+            {
+                ostringstream string_stream;
+                string_stream << "the used size of " << CCheckSegmentExtents::SegmentToString(segment) << " (=" << header.usedSize << ") exceeds its allocated size (=" << header.allocatedSize << ")";
+                this->ReportFatal(string_stream.str(), string());
+                return;
+            }
+
+            const uint64_t used_end = segment.position + CSegmentReader::kSegmentHeaderSize + static_cast<uint64_t>(header.GetEffectiveUsedSize());
+            if (total_file_size > 0 && used_end > total_file_size)
+            {
+                ostringstream string_stream;
+                string_stream << CCheckSegmentExtents::SegmentToString(segment) << " extends beyond the end of the file";
+                const string information = string_stream.str();
+                string_stream = ostringstream();
+                string_stream << "the segment occupies [" << segment.position << ", " << used_end << "), the filesize is " << total_file_size;
+                this->ReportFatal(information, string_stream.str());
+            }
+
+            extents.emplace_back(Extent{ segment, segment.position + CSegmentReader::kSegmentHeaderSize + static_cast<uint64_t>(header.allocatedSize) });
+        });
+
+    return extents;
+}
+
+void CCheckSegmentExtents::CheckForOverlappingExtents(std::vector<Extent>& extents)
+{
+    // the extents are (already) sorted by their start - we now sweep over them once, keeping track of the extent which
+    //  reaches furthest, and every extent starting before this one ends is overlapping with it. The extents overlapping
+    //  with the same (furthest reaching) extent are reported with one finding - so that e.g. a segment with a corrupt
+    //  (huge) size does not give a finding for every segment following it.
+    const Extent* furthest_extent = nullptr;
+    vector<const Extent*> overlapping_extents;
+    uint64_t overlapping_count = 0;
+    for (const auto& extent : extents)
+    {
+        if (furthest_extent != nullptr && extent.segment.position < furthest_extent->end)
+        {
+            if (overlapping_extents.size() < kMaxNumberOfSegmentsInDetails)
+            {
+                overlapping_extents.push_back(&extent);
+            }
+
+            ++overlapping_count;
+        }
+
+        if (furthest_extent == nullptr || extent.end > furthest_extent->end)
+        {
+            if (overlapping_count > 0)
+            {
+                this->ReportOverlappingExtents(*furthest_extent, overlapping_extents, overlapping_count);
+                overlapping_extents.clear();
+                overlapping_count = 0;
+            }
+
+            furthest_extent = &extent;
+        }
+    }
+
+    if (overlapping_count > 0)
+    {
+        this->ReportOverlappingExtents(*furthest_extent, overlapping_extents, overlapping_count);
+    }
+}
+
+void CCheckSegmentExtents::ReportOverlappingExtents(const Extent& extent, const std::vector<const Extent*>& overlapping_extents, std::uint64_t overlapping_count)
+{
+    ostringstream string_stream;
+    if (overlapping_count == 1)
+    {
+        string_stream << CCheckSegmentExtents::SegmentToString(extent.segment) << " and " << CCheckSegmentExtents::SegmentToString(overlapping_extents.front()->segment) << " are overlapping";
+    }
+    else
+    {
+        string_stream << CCheckSegmentExtents::SegmentToString(extent.segment) << " is overlapping with " << overlapping_count << " segments";
+    }
+
+    const string information = string_stream.str();
+    string_stream = ostringstream();
+    if (overlapping_count == 1)
+    {
+        string_stream << "the segments occupy [" << extent.segment.position << ", " << extent.end << ") and [" << overlapping_extents.front()->segment.position << ", " << overlapping_extents.front()->end << ")";
+    }
+    else
+    {
+        string_stream << "the segment occupies [" << extent.segment.position << ", " << extent.end << "), overlapping: ";
+        for (size_t i = 0; i < overlapping_extents.size(); ++i)
+        {
+            string_stream << (i > 0 ? ", " : "") << CCheckSegmentExtents::SegmentToString(overlapping_extents[i]->segment)
+                << " [" << overlapping_extents[i]->segment.position << ", " << overlapping_extents[i]->end << ")";
+        }
+
+        if (overlapping_count > overlapping_extents.size())
+        {
+            string_stream << ", ... (" << overlapping_count - overlapping_extents.size() << " more)";
+        }
+    }
+
+    this->ReportFatal(information, string_stream.str());
+}
+
+void CCheckSegmentExtents::ReportFatal(const std::string& information, const std::string& details)
+{
+    IResultGatherer::Finding finding(CCheckSegmentExtents::kCheckType);
+    finding.severity = IResultGatherer::Severity::Fatal;
+    finding.information = information;
+    finding.details = details;
+    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+}
+
+/*static*/const char* CCheckSegmentExtents::GetExpectedSegmentId(SegmentKind kind)
+{
+    switch (kind)
+    {
+    case SegmentKind::FileHeader: return "ZISRAWFILE";
+    case SegmentKind::SubBlockDirectory: return "ZISRAWDIRECTORY";
+    case SegmentKind::Metadata: return "ZISRAWMETADATA";
+    case SegmentKind::AttachmentDirectory: return "ZISRAWATTDIR";
+    case SegmentKind::SubBlock: return "ZISRAWSUBBLOCK";
+    case SegmentKind::Attachment: return "ZISRAWATTACH";
+    }
+
+    return "";
+}
+
+/*static*/std::string CCheckSegmentExtents::SegmentToString(const Segment& segment)
+{
+    ostringstream string_stream;
+    switch (segment.kind)
+    {
+    case SegmentKind::FileHeader:
+        string_stream << "the file-header";
+        break;
+    case SegmentKind::SubBlockDirectory:
+        string_stream << "the subblock-directory";
+        break;
+    case SegmentKind::Metadata:
+        string_stream << "the metadata-segment";
+        break;
+    case SegmentKind::AttachmentDirectory:
+        string_stream << "the attachment-directory";
+        break;
+    case SegmentKind::SubBlock:
+        string_stream << "subblock #" << segment.index;
+        break;
+    case SegmentKind::Attachment:
+        string_stream << "attachment #" << segment.index;
+        break;
+    }
+
+    return string_stream.str();
+}
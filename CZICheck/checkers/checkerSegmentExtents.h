@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "checkerbase.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// This checker determines the extent (i.e. the file-position and the allocated size) of all segments referenced
+/// from the file-header and the directories - the file-header itself, the subblock-directory, the metadata-segment,
+/// the attachment-directory, all subblock-segments and all attachment-segments. The file-positions are taken from the
+/// file-header and the directories, and for each segment only its segment-header is read (in the order of the
+/// file-position, with segment-headers close to each other being read with a single read-operation).
+/// The extents are then sorted and visited once, and it is reported if a segment extends beyond the end of the file,
+/// or if segments are overlapping.
+/// Pathologies:
+/// - if the stream is not available, then this test does nothing
+/// - if the filesize is unknown, then only overlapping segments are reported
+/// - attachments located in a different file-part are not checked
+class CCheckSegmentExtents : public IChecker, CCheckerBase
+{
+private:
+    /// Values that represent the kinds of segments.
+    enum class SegmentKind
+    {
+        FileHeader,
+        SubBlockDirectory,
+        Metadata,
+        AttachmentDirectory,
+        SubBlock,
+        Attachment,
+    };
+
+    /// A segment referenced from the file-header or a directory.
+    struct Segment
+    {
+        SegmentKind kind;       ///< The kind of the segment.
+        int index;              ///< The index of the subblock or attachment (only used with SegmentKind::SubBlock and SegmentKind::Attachment).
+        std::uint64_t position; ///< The file-position of the segment.
+    };
+
+    /// The extent of a segment, i.e. the range [start, end) it occupies in the file (including the segment-header).
+    struct Extent
+    {
+        Segment segment;        ///< The segment.
+        std::uint64_t end;      ///< The end of the extent (exclusive), the start being the segment's file-position.
+    };
+public:
+    static const CZIChecks kCheckType = CZIChecks::SegmentExtentsValid;
+    static const char* kDisplayName;
+    static const char* kShortName;
+
+    CCheckSegmentExtents(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        IResultGathererReport& result_gatherer,
+        const CheckerCreateInfo& additional_info);
+    void RunCheck() override;
+private:
+    std::vector<Segment> GatherSegments();
+    std::vector<Extent> DetermineExtents(std::vector<Segment>& segments);
+    void CheckForOverlappingExtents(std::vector<Extent>& extents);
+    void ReportOverlappingExtents(const Extent& extent, const std::vector<const Extent*>& overlapping_extents, std::uint64_t overlapping_count);
+    void ReportFatal(const std::string& information, const std::string& details);
+    static const char* GetExpectedSegmentId(SegmentKind kind);
+    static std::string SegmentToString(const Segment& segment);
+};
@@ -3,7 +3,11 @@
 // SPDX-License-Identifier: MIT
 
 #include "checkerSubBlkBitmapValid.h"
+#include "../segmentreader.h"
+#include "../xxhash64.h"
+#include <chrono>
 #include <exception>
+#include <optional>
 #include <sstream>
 #include <memory>
 
@@ -27,57 +31,216 @@ void CCheckSubBlkBitmapValid::RunCheck()
 
     this->RunCheckDefaultExceptionHandling([this]()
         {
-            this->reader_->EnumerateSubBlocks(
-                [this](int index, const SubBlockInfo& info)->bool
+            this->reader_->EnumerateSubBlocksEx(
+                [this](int index, const DirectorySubBlockInfo& info)->bool
                 {
-                    try
+                    // for uncompressed subblocks, we can validate the content without reading the subblock as a whole (which
+                    //  may be prohibitive for very large subblocks)
+                    if (info.GetCompressionMode() == CompressionMode::UnCompressed && this->additional_info_.stream)
                     {
-                        auto sub_block = this->reader_->ReadSubBlock(index);
-                        const auto compression_mode = sub_block->GetSubBlockInfo().GetCompressionMode();
-                        if (compression_mode != CompressionMode::Invalid)
-                        {
-                            // According to documentation, for a subblock with a compression mode which is *not* supported by
-                            //  libCZI, we'd be getting CompressionMode::Invalid here. So, if we get a valid compression mode,
-                            //  then we can rightfully expect that the subblock can be decoded, or that we can get a bitmap here
-                            try
-                            {
-                                auto bitmap = sub_block->CreateBitmap();
-                            }
-                            catch (exception& exception)
-                            {
-                                IResultGatherer::Finding finding(CCheckSubBlkBitmapValid::kCheckType);
-                                finding.severity = IResultGatherer::Severity::Fatal;
-                                stringstream ss;
-                                ss << "Error decoding subblock #" << index << " with compression \"" << Utils::CompressionModeToInformalString(compression_mode) << "\"";
-                                finding.information = ss.str();
-                                finding.details = exception.what();
-                                this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
-                            }
-                        }
-                        else
-                        {
-                            IResultGatherer::Finding finding(CCheckSubBlkBitmapValid::kCheckType);
-                            finding.severity = IResultGatherer::Severity::Info;
-                            stringstream ss;
-                            ss << "Subblock #" << index << " has a non-standard compression mode (" << sub_block->GetSubBlockInfo().compressionModeRaw << ")";
-                            finding.information = ss.str();
-                            this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
-                        }
+                        this->CheckUncompressedSubBlock(index, info);
                     }
-                    catch (exception& exception)
+                    else
                     {
-                        IResultGatherer::Finding finding(CCheckSubBlkBitmapValid::kCheckType);
-                        finding.severity = IResultGatherer::Severity::Fatal;
-                        stringstream ss;
-                        ss << "Error reading subblock #" << index;
-                        finding.information = ss.str();
-                        finding.details = exception.what();
-                        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+                        this->CheckSubBlockByDecoding(index, info);
                     }
 
                     return true;
                 });
+
+            this->ReportManifestSubBlocksNotInFile(CCheckSubBlkBitmapValid::kCheckType);
             });
 
+    if (this->additional_info_.collectStatistics)
+    {
+        this->result_gatherer_.ReportStatistics(this->decode_statistics_.CreateStatisticsTable(CCheckSubBlkBitmapValid::kCheckType, "decode performance per compression mode"));
+    }
+
     this->result_gatherer_.FinishCheck(CCheckSubBlkBitmapValid::kCheckType);
 }
+
+void CCheckSubBlkBitmapValid::CheckUncompressedSubBlock(int index, const libCZI::DirectorySubBlockInfo& info)
+{
+    CSegmentReader::SubBlockSegmentInfo segment_info;
+    try
+    {
+        segment_info = CSegmentReader::ReadSubBlockSegmentInfo(this->additional_info_.stream.get(), info.filePosition, this->additional_info_.totalFileSize);
+    }
+    catch (exception& exception)
+    {
+        IResultGatherer::Finding finding(CCheckSubBlkBitmapValid::kCheckType);
+        finding.severity = IResultGatherer::Severity::Fatal;
+        stringstream ss;
+        ss << "Error reading subblock #" << index;
+        finding.information = ss.str();
+        finding.details = exception.what();
+        this->decode_statistics_.AddError(info);
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        return;
+    }
+
+    // for an uncompressed bitmap, the data must contain (at least) stride x height bytes, where the stride is
+    //  given as width x bytes-per-pixel
+    string error_text;
+    uint8_t bytes_per_pixel = 0;
+    try
+    {
+        bytes_per_pixel = Utils::GetBytesPerPixel(info.pixelType);
+    }
+    catch (exception&)
+    {
+        stringstream ss;
+        ss << "the pixeltype (" << static_cast<int>(info.pixelType) << ") is invalid";
+        error_text = ss.str();
+    }
+
+    if (bytes_per_pixel > 0)
+    {
+        const uint64_t stride = static_cast<uint64_t>(info.physicalSize.w) * bytes_per_pixel;
+        const uint64_t size_required = stride * info.physicalSize.h;
+        if (static_cast<uint64_t>(segment_info.dataSize) < size_required)
+        {
+            stringstream ss;
+            ss << "the size of the data (=" << segment_info.dataSize << " bytes) is less than the size required for a bitmap of size "
+                << info.physicalSize.w << "x" << info.physicalSize.h << " and pixeltype " << Utils::PixelTypeToInformalString(info.pixelType)
+                << " (=" << size_required << " bytes)";
+            error_text = ss.str();
+        }
+    }
+
+    if (!error_text.empty())
+    {
+        IResultGatherer::Finding finding(CCheckSubBlkBitmapValid::kCheckType);
+        finding.severity = IResultGatherer::Severity::Fatal;
+        stringstream ss;
+        ss << "Error decoding subblock #" << index << " with compression \"" << Utils::CompressionModeToInformalString(CompressionMode::UnCompressed) << "\"";
+        finding.information = ss.str();
+        finding.details = error_text;
+        this->decode_statistics_.AddError(info);
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        return;
+    }
+
+    // now read the pixel data in chunks, so that the memory usage is bounded by the chunk-size (and if a manifest is
+    //  to be created, the hash is calculated on the fly)
+    const bool calculate_hash = this->additional_info_.manifest != nullptr;
+    CXxHash64 hash;
+    try
+    {
+        const auto start_time = chrono::steady_clock::now();
+        CSegmentReader::ReadInChunks(
+            this->additional_info_.stream.get(),
+            segment_info.dataOffset,
+            segment_info.dataSize,
+            CSegmentReader::kDefaultChunkSize,
+            [&](uint64_t, const void* data, size_t size)->bool
+            {
+                if (calculate_hash)
+                {
+                    hash.Update(data, size);
+                }
+
+                return true;
+            });
+
+        // an uncompressed subblock needs no decoding, so we report a decode time of zero
+        this->decode_statistics_.AddTile(info, segment_info.dataSize, segment_info.dataSize, chrono::steady_clock::now() - start_time, chrono::nanoseconds::zero());
+    }
+    catch (exception& exception)
+    {
+        IResultGatherer::Finding finding(CCheckSubBlkBitmapValid::kCheckType);
+        finding.severity = IResultGatherer::Severity::Fatal;
+        stringstream ss;
+        ss << "Error reading subblock #" << index;
+        finding.information = ss.str();
+        finding.details = exception.what();
+        this->decode_statistics_.AddError(info);
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        return;
+    }
+
+    if (calculate_hash)
+    {
+        this->AddSubBlockToManifest(CCheckSubBlkBitmapValid::kCheckType, index, info, segment_info.dataSize, hash.GetDigest());
+    }
+}
+
+void CCheckSubBlkBitmapValid::CheckSubBlockByDecoding(int index, const libCZI::DirectorySubBlockInfo& info)
+{
+    // the memory for the compressed data and the bitmap is reserved with the memory governor - if the subblock is too
+    //  large for the budget, it is skipped (and this is reported)
+    CMemoryGovernor::Reservation reservation;
+    if (!this->ReserveMemoryForSubBlock(CCheckSubBlkBitmapValid::kCheckType, index, info, reservation))
+    {
+        return;
+    }
+
+    optional<uint64_t> hash;
+    size_t compressed_size = 0;
+    try
+    {
+        const auto start_time = chrono::steady_clock::now();
+        auto sub_block = this->reader_->ReadSubBlock(index);
+        const auto read_time = chrono::steady_clock::now() - start_time;
+        const void* compressed_data = nullptr;
+        sub_block->DangerousGetRawData(ISubBlock::MemBlkType::Data, compressed_data, compressed_size);
+        if (this->additional_info_.manifest)
+        {
+            hash = CXxHash64::Calculate(compressed_data, compressed_size);
+        }
+
+        const auto compression_mode = sub_block->GetSubBlockInfo().GetCompressionMode();
+        if (compression_mode != CompressionMode::Invalid)
+        {
+            // According to documentation, for a subblock with a compression mode which is *not* supported by
+            //  libCZI, we'd be getting CompressionMode::Invalid here. So, if we get a valid compression mode,
+            //  then we can rightfully expect that the subblock can be decoded, or that we can get a bitmap here
+            try
+            {
+                const auto decode_start_time = chrono::steady_clock::now();
+                auto bitmap = sub_block->CreateBitmap();
+                const auto decode_time = chrono::steady_clock::now() - decode_start_time;
+                const auto bitmap_size = bitmap->GetSize();
+                const uint64_t decoded_size = static_cast<uint64_t>(bitmap_size.w) * bitmap_size.h * Utils::GetBytesPerPixel(bitmap->GetPixelType());
+                this->decode_statistics_.AddTile(info, compressed_size, decoded_size, read_time, decode_time);
+            }
+            catch (exception& exception)
+            {
+                IResultGatherer::Finding finding(CCheckSubBlkBitmapValid::kCheckType);
+                finding.severity = IResultGatherer::Severity::Fatal;
+                stringstream ss;
+                ss << "Error decoding subblock #" << index << " with compression \"" << Utils::CompressionModeToInformalString(compression_mode) << "\"";
+                finding.information = ss.str();
+                finding.details = exception.what();
+                this->decode_statistics_.AddError(info);
+                this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+            }
+        }
+        else
+        {
+            this->decode_statistics_.AddTile(info, compressed_size, 0, read_time, chrono::nanoseconds::zero());
+            IResultGatherer::Finding finding(CCheckSubBlkBitmapValid::kCheckType);
+            finding.severity = IResultGatherer::Severity::Info;
+            stringstream ss;
+            ss << "Subblock #" << index << " has a non-standard compression mode (" << sub_block->GetSubBlockInfo().compressionModeRaw << ")";
+            finding.information = ss.str();
+            this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        }
+    }
+    catch (exception& exception)
+    {
+        IResultGatherer::Finding finding(CCheckSubBlkBitmapValid::kCheckType);
+        finding.severity = IResultGatherer::Severity::Fatal;
+        stringstream ss;
+        ss << "Error reading subblock #" << index;
+        finding.information = ss.str();
+        finding.details = exception.what();
+        this->decode_statistics_.AddError(info);
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+    }
+
+    if (hash)
+    {
+        this->AddSubBlockToManifest(CCheckSubBlkBitmapValid::kCheckType, index, info, compressed_size, *hash);
+    }
+}
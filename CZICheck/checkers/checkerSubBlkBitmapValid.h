@@ -5,10 +5,14 @@
 #pragma once
 
 #include "checkerbase.h"
+#include "decodestatistics.h"
 #include <memory>
 
 /// This checker reads all the segments pointed to in the subblock-directory
 /// and decodes the subblock-content.
+/// Uncompressed subblocks are not read as a whole - instead, their layout is validated
+/// from the segment-header, and the pixel data is read in chunks of fixed size. So, the
+/// memory usage is independent of the size of the subblock.
 class CCheckSubBlkBitmapValid : public IChecker, CCheckerBase
 {
 public:
@@ -21,4 +25,9 @@ public:
         IResultGathererReport& result_gatherer,
         const CheckerCreateInfo& additional_info);
     void RunCheck() override;
+private:
+    CDecodeStatistics decode_statistics_;
+
+    void CheckUncompressedSubBlock(int index, const libCZI::DirectorySubBlockInfo& info);
+    void CheckSubBlockByDecoding(int index, const libCZI::DirectorySubBlockInfo& info);
 };
@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "checkerSubBlkPixelContent.h"
+#include <sstream>
+#include <memory>
+
+using namespace libCZI;
+using namespace std;
+
+/*static*/const char* CCheckSubBlkPixelContent::kDisplayName = "check the subblock's pixel content for NaN/Inf-values, saturation and constant content";
+/*static*/const char* CCheckSubBlkPixelContent::kShortName = "subblkpixelcontent";
+
+namespace
+{
+    /// The maximum number of subblocks listed in the details of a finding.
+    constexpr size_t kMaxNumberOfSubBlocksInDetails = 20;
+}
+
+CCheckSubBlkPixelContent::CCheckSubBlkPixelContent(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    IResultGathererReport& result_gatherer,
+    const CheckerCreateInfo& additional_info) :
+    CCheckerBase(reader, result_gatherer, additional_info)
+{
+}
+
+void CCheckSubBlkPixelContent::RunCheck()
+{
+    this->result_gatherer_.StartCheck(CCheckSubBlkPixelContent::kCheckType);
+
+    this->RunCheckDefaultExceptionHandling([this]()
+        {
+            CPixelContentAnalyzer::EnumerateSubBlocks(
+                this->reader_,
+                this->additional_info_,
+                nullptr,
+                [this](int index, const DirectorySubBlockInfo& info, CMemoryGovernor::Reservation& reservation)->bool
+                {
+                    return this->ReserveMemoryForSubBlock(CCheckSubBlkPixelContent::kCheckType, index, info, reservation);
+                },
+                [this](int index, const SubBlockInfo& info, PixelType pixel_type, const PixelContentStatistics& statistics)->void
+                {
+                    this->AddSubBlock(index, info, pixel_type, statistics);
+                });
+
+            this->ReportFindings();
+        });
+
+    if (this->additional_info_.collectStatistics)
+    {
+        this->ReportStatistics();
+    }
+
+    this->result_gatherer_.FinishCheck(CCheckSubBlkPixelContent::kCheckType);
+}
+
+void CCheckSubBlkPixelContent::AddSubBlock(int index, const libCZI::SubBlockInfo& info, libCZI::PixelType pixel_type, const PixelContentStatistics& statistics)
+{
+    // if there is no C-index, then we consider the subblock to be in channel 0
+    int c;
+    if (!info.coordinate.TryGetPosition(DimensionIndex::C, &c))
+    {
+        c = 0;
+    }
+
+    auto& channel_info = this->channels_[c];
+    ++channel_info.subBlockCount;
+    channel_info.statistics.Merge(statistics);
+    if (channel_info.pixelType == PixelType::Invalid)
+    {
+        channel_info.pixelType = pixel_type;
+    }
+
+    if (statistics.nanCount > 0 || statistics.infCount > 0)
+    {
+        channel_info.subBlocksWithNonFiniteValues.Add(SubBlockItem{ index, statistics });
+    }
+    else if (statistics.IsConstant())
+    {
+        if (statistics.maximum == CPixelContentAnalyzer::GetMaximumComponentValue(pixel_type))
+        {
+            channel_info.subBlocksSaturated.Add(SubBlockItem{ index, statistics });
+        }
+        else
+        {
+            channel_info.subBlocksConstant.Add(SubBlockItem{ index, statistics });
+        }
+    }
+}
+
+void CCheckSubBlkPixelContent::ReportFindings()
+{
+    for (const auto& channel : this->channels_)
+    {
+        const auto& channel_info = channel.second;
+        if (channel_info.subBlocksWithNonFiniteValues.count > 0)
+        {
+            stringstream ss;
+            ss << "channel " << channel.first << ": " << channel_info.subBlocksWithNonFiniteValues.count << " subblock(s) contain NaN or infinite values";
+            this->ReportSubBlockList(
+                IResultGatherer::Severity::Warning,
+                ss.str(),
+                channel_info.subBlocksWithNonFiniteValues,
+                [](ostream& os, const SubBlockItem& item)->void
+                {
+                    os << "#" << item.index << " (NaN: " << item.statistics.nanCount << ", Inf: " << item.statistics.infCount << ")";
+                });
+        }
+
+        if (channel_info.subBlocksSaturated.count > 0)
+        {
+            stringstream ss;
+            ss << "channel " << channel.first << ": " << channel_info.subBlocksSaturated.count << " subblock(s) are saturated (all values are "
+                << CPixelContentAnalyzer::GetMaximumComponentValue(channel_info.pixelType) << ")";
+            this->ReportSubBlockList(
+                IResultGatherer::Severity::Warning,
+                ss.str(),
+                channel_info.subBlocksSaturated,
+                [](ostream& os, const SubBlockItem& item)->void
+                {
+                    os << "#" << item.index;
+                });
+        }
+
+        if (channel_info.subBlocksConstant.count > 0)
+        {
+            stringstream ss;
+            ss << "channel " << channel.first << ": " << channel_info.subBlocksConstant.count << " subblock(s) have constant content";
+            this->ReportSubBlockList(
+                IResultGatherer::Severity::Info,
+                ss.str(),
+                channel_info.subBlocksConstant,
+                [](ostream& os, const SubBlockItem& item)->void
+                {
+                    os << "#" << item.index << " (value " << item.statistics.minimum << ")";
+                });
+        }
+    }
+}
+
+void CCheckSubBlkPixelContent::ReportSubBlockList(
+    IResultGatherer::Severity severity,
+    const std::string& information,
+    const SubBlockList& list,
+    const std::function<void(std::ostream&, const SubBlockItem&)>& describe_item)
+{
+    IResultGatherer::Finding finding(CCheckSubBlkPixelContent::kCheckType);
+    finding.severity = severity;
+    finding.information = information;
+    stringstream ss;
+    ss << "subblocks: ";
+    for (size_t i = 0; i < list.items.size(); ++i)
+    {
+        if (i > 0)
+        {
+            ss << ", ";
+        }
+
+        describe_item(ss, list.items[i]);
+    }
+
+    if (list.count > list.items.size())
+    {
+        ss << ", ... (" << list.count - list.items.size() << " more)";
+    }
+
+    finding.details = ss.str();
+    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+}
+
+void CCheckSubBlkPixelContent::SubBlockList::Add(const SubBlockItem& item)
+{
+    if (this->items.size() < kMaxNumberOfSubBlocksInDetails)
+    {
+        this->items.push_back(item);
+    }
+
+    ++this->count;
+}
+
+void CCheckSubBlkPixelContent::ReportStatistics()
+{
+    IResultGatherer::StatisticsTable table(CCheckSubBlkPixelContent::kCheckType);
+    table.name = "pixel content per channel";
+    table.columns = { "channel", "pixeltype", "subblocks", "minimum", "maximum", "NaN values", "infinite values", "saturated subblocks", "constant subblocks" };
+    for (const auto& channel : this->channels_)
+    {
+        const auto& channel_info = channel.second;
+        const bool has_finite_values = channel_info.statistics.HasFiniteValues();
+        table.rows.push_back({
+            static_cast<int64_t>(channel.first),
+            string(Utils::PixelTypeToInformalString(channel_info.pixelType)),
+            channel_info.subBlockCount,
+            has_finite_values ? channel_info.statistics.minimum : 0.0,
+            has_finite_values ? channel_info.statistics.maximum : 0.0,
+            static_cast<int64_t>(channel_info.statistics.nanCount),
+            static_cast<int64_t>(channel_info.statistics.infCount),
+            static_cast<int64_t>(channel_info.subBlocksSaturated.count),
+            static_cast<int64_t>(channel_info.subBlocksConstant.count) });
+    }
+
+    this->result_gatherer_.ReportStatistics(table);
+}
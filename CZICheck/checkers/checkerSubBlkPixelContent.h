@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "checkerbase.h"
+#include "pixelcontent.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+/// This checker decodes all subblocks and examines their pixel content. It is checked
+/// for NaN- or infinite values (with floating point pixel types), for subblocks where all
+/// values are at the maximum of the pixel type (i.e. saturated), and for subblocks with
+/// constant content (which may indicate e.g. a camera dropout). The findings are aggregated
+/// per channel.
+class CCheckSubBlkPixelContent : public IChecker, CCheckerBase
+{
+private:
+    /// Information about a subblock which is to be reported.
+    struct SubBlockItem
+    {
+        int index;                          ///< The index of the subblock.
+        PixelContentStatistics statistics;  ///< The statistics of the subblock's pixel content.
+    };
+
+    /// A list of subblocks which are to be reported - only the first few subblocks are kept (for listing them
+    /// in the details of the finding), the others are only counted.
+    struct SubBlockList
+    {
+        std::uint64_t count{ 0 };           ///< The number of subblocks.
+        std::vector<SubBlockItem> items;    ///< The first few subblocks.
+
+        void Add(const SubBlockItem& item);
+    };
+
+    /// The information gathered for a channel.
+    struct ChannelInfo
+    {
+        std::int64_t subBlockCount{ 0 };
+        PixelContentStatistics statistics;
+        libCZI::PixelType pixelType{ libCZI::PixelType::Invalid };
+        SubBlockList subBlocksWithNonFiniteValues;
+        SubBlockList subBlocksSaturated;
+        SubBlockList subBlocksConstant;
+    };
+
+    std::map<int, ChannelInfo> channels_;
+public:
+    static const CZIChecks kCheckType = CZIChecks::SubBlockPixelContentSanity;
+    static const char* kDisplayName;
+    static const char* kShortName;
+
+    CCheckSubBlkPixelContent(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        IResultGathererReport& result_gatherer,
+        const CheckerCreateInfo& additional_info);
+    void RunCheck() override;
+private:
+    void AddSubBlock(int index, const libCZI::SubBlockInfo& info, libCZI::PixelType pixel_type, const PixelContentStatistics& statistics);
+    void ReportFindings();
+    void ReportStatistics();
+    void ReportSubBlockList(
+        IResultGatherer::Severity severity,
+        const std::string& information,
+        const SubBlockList& list,
+        const std::function<void(std::ostream&, const SubBlockItem&)>& describe_item);
+};
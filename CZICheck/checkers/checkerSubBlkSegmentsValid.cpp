@@ -3,9 +3,13 @@
 // SPDX-License-Identifier: MIT
 
 #include "checkerSubBlkSegmentsValid.h"
+#include "../segmentreader.h"
+#include "../xxhash64.h"
 #include <exception>
+#include <optional>
 #include <sstream>
 #include <memory>
+#include <utility>
 
 using namespace libCZI;
 using namespace std;
@@ -27,12 +31,57 @@ void CCheckSubBlkSegmentsValid::RunCheck()
 
     this->RunCheckDefaultExceptionHandling([this]()
         {
-            this->reader_->EnumerateSubBlocks(
-                [this](int index, const SubBlockInfo& info)->bool
+            this->reader_->EnumerateSubBlocksEx(
+                [this](int index, const DirectorySubBlockInfo& info)->bool
                 {
+                        // if a manifest is to be created (or verified), the hash of the subblock's data is calculated
+                        //  while reading it
+                        optional<pair<uint64_t, uint64_t>> data_size_and_hash;
+
+                        // a subblock which is not validated from its segment header is read as a whole, so the memory for
+                        //  it is reserved with the memory governor - if it is too large for the budget, it is skipped (and
+                        //  this is reported)
+                        CMemoryGovernor::Reservation reservation;
+                        if ((info.GetCompressionMode() != CompressionMode::UnCompressed || !this->additional_info_.stream) &&
+                            !this->ReserveMemoryForSubBlock(CCheckSubBlkSegmentsValid::kCheckType, index, info, reservation))
+                        {
+                            return true;
+                        }
+
                         try
                         {
-                            this->reader_->ReadSubBlock(index);
+                            if (info.GetCompressionMode() == CompressionMode::UnCompressed && this->additional_info_.stream)
+                            {
+                                // for uncompressed subblocks, we validate the layout of the segment from its header (instead
+                                //  of reading it as a whole, which may be prohibitive for very large subblocks)
+                                const auto segment_info = CSegmentReader::ReadSubBlockSegmentInfo(this->additional_info_.stream.get(), info.filePosition, this->additional_info_.totalFileSize);
+                                if (this->additional_info_.manifest)
+                                {
+                                    CXxHash64 hash;
+                                    CSegmentReader::ReadInChunks(
+                                        this->additional_info_.stream.get(),
+                                        segment_info.dataOffset,
+                                        segment_info.dataSize,
+                                        CSegmentReader::kDefaultChunkSize,
+                                        [&](uint64_t, const void* data, size_t size)->bool
+                                        {
+                                            hash.Update(data, size);
+                                            return true;
+                                        });
+                                    data_size_and_hash = make_pair(static_cast<uint64_t>(segment_info.dataSize), hash.GetDigest());
+                                }
+                            }
+                            else
+                            {
+                                const auto sub_block = this->reader_->ReadSubBlock(index);
+                                if (this->additional_info_.manifest)
+                                {
+                                    const void* data = nullptr;
+                                    size_t size = 0;
+                                    sub_block->DangerousGetRawData(ISubBlock::MemBlkType::Data, data, size);
+                                    data_size_and_hash = make_pair(static_cast<uint64_t>(size), CXxHash64::Calculate(data, size));
+                                }
+                            }
                         }
                         catch (exception& exception)
                         {
@@ -45,8 +94,15 @@ void CCheckSubBlkSegmentsValid::RunCheck()
                             this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
                         }
 
+                        if (data_size_and_hash)
+                        {
+                            this->AddSubBlockToManifest(CCheckSubBlkSegmentsValid::kCheckType, index, info, data_size_and_hash->first, data_size_and_hash->second);
+                        }
+
                         return true;
                 });
+
+            this->ReportManifestSubBlocksNotInFile(CCheckSubBlkSegmentsValid::kCheckType);
         });
 
     this->result_gatherer_.FinishCheck(CCheckSubBlkSegmentsValid::kCheckType);
@@ -0,0 +1,255 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "checkerSubBlockSizeDistribution.h"
+#include "layer0planes.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <memory>
+
+using namespace libCZI;
+using namespace std;
+
+/*static*/const char* CCheckSubBlockSizeDistribution::kDisplayName = "check the size-distribution of the subblocks (tiny and giant tiles)";
+/*static*/const char* CCheckSubBlockSizeDistribution::kShortName = "subblksizes";
+
+namespace
+{
+    /// The channel index used for subblocks without a C-index.
+    constexpr int kNoChannelIndex = (numeric_limits<int>::min)();
+
+    /// Tiny subblocks are only reported if there are at least this many of them (in a channel and pyramid-layer), and if
+    /// they make up the majority of the subblocks - a few small tiles (e.g. at the border of a mosaic) are normal.
+    constexpr int64_t kMinTinySubBlocksToReport = 1000;
+}
+
+void CCheckSubBlockSizeDistribution::PowerOfTwoHistogram::Add(double value)
+{
+    if (value > 0)
+    {
+        ++this->buckets[static_cast<int>(floor(log2(value)))];
+    }
+}
+
+CCheckSubBlockSizeDistribution::CCheckSubBlockSizeDistribution(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    IResultGathererReport& result_gatherer,
+    const CheckerCreateInfo& additional_info) :
+    CCheckerBase(reader, result_gatherer, additional_info)
+{
+}
+
+void CCheckSubBlockSizeDistribution::RunCheck()
+{
+    this->result_gatherer_.StartCheck(CCheckSubBlockSizeDistribution::kCheckType);
+
+    this->RunCheckDefaultExceptionHandling([this]()
+        {
+            const auto subblocks = this->GatherSubBlocks();
+            this->AddCompressedSizes(subblocks);
+            this->CheckTileSizes();
+        });
+
+    if (this->additional_info_.collectStatistics)
+    {
+        this->ReportStatistics();
+    }
+
+    this->result_gatherer_.FinishCheck(CCheckSubBlockSizeDistribution::kCheckType);
+}
+
+std::vector<CCheckSubBlockSizeDistribution::SubBlockLocation> CCheckSubBlockSizeDistribution::GatherSubBlocks()
+{
+    vector<SubBlockLocation> subblocks;
+    map<pair<int, int>, uint32_t> group_for_key;
+    this->reader_->EnumerateSubBlocksEx(
+        [&](int index, const DirectorySubBlockInfo& info)->bool
+        {
+            int channel_index;
+            if (!info.coordinate.TryGetPosition(DimensionIndex::C, &channel_index))
+            {
+                channel_index = kNoChannelIndex;
+            }
+
+            const int minification = CLayer0Planes::GetMinification(info);
+            auto it = group_for_key.find(make_pair(channel_index, minification));
+            if (it == group_for_key.end())
+            {
+                it = group_for_key.emplace(make_pair(channel_index, minification), static_cast<uint32_t>(this->groups_.size())).first;
+                Group group;
+                group.channelIndex = channel_index;
+                group.minification = minification;
+                this->groups_.emplace_back(group);
+            }
+
+            auto& group = this->groups_[it->second];
+            const uint32_t tile_size = max(info.physicalSize.w, info.physicalSize.h);
+            ++group.subBlocks;
+            group.tileSize.Add(tile_size);
+            if (group.smallestSubBlock.first < 0 || tile_size < max(group.smallestSubBlock.second.w, group.smallestSubBlock.second.h))
+            {
+                group.smallestSubBlock = make_pair(index, info.physicalSize);
+            }
+
+            if (group.largestSubBlock.first < 0 || tile_size > max(group.largestSubBlock.second.w, group.largestSubBlock.second.h))
+            {
+                group.largestSubBlock = make_pair(index, info.physicalSize);
+            }
+
+            if (tile_size < this->additional_info_.minTileSize)
+            {
+                ++group.tinySubBlocks;
+            }
+            else if (tile_size > this->additional_info_.maxTileSize)
+            {
+                ++group.giantSubBlocks;
+            }
+
+            subblocks.emplace_back(SubBlockLocation{ info.filePosition, static_cast<uint64_t>(info.physicalSize.w) * info.physicalSize.h, it->second });
+            return true;
+        });
+
+    return subblocks;
+}
+
+void CCheckSubBlockSizeDistribution::AddCompressedSizes(const std::vector<SubBlockLocation>& subblocks)
+{
+    // the directory does not give the size of a subblock - we estimate it as the distance to the next subblock in
+    //  the file (or to the end of the file for the last one)
+    vector<uint32_t> file_order(subblocks.size());
+    iota(file_order.begin(), file_order.end(), 0);
+    sort(
+        file_order.begin(),
+        file_order.end(),
+        [&](uint32_t a, uint32_t b)->bool
+        {
+            return subblocks[a].filePosition < subblocks[b].filePosition || (subblocks[a].filePosition == subblocks[b].filePosition && a < b);
+        });
+
+    for (size_t i = 0; i < file_order.size(); ++i)
+    {
+        const auto& subblock = subblocks[file_order[i]];
+        uint64_t end_position;
+        if (i + 1 < file_order.size())
+        {
+            end_position = subblocks[file_order[i + 1]].filePosition;
+        }
+        else if (this->additional_info_.totalFileSize > subblock.filePosition)
+        {
+            end_position = this->additional_info_.totalFileSize;
+        }
+        else
+        {
+            // the size of the last subblock cannot be estimated if the filesize is unknown
+            continue;
+        }
+
+        const uint64_t compressed_size = end_position - subblock.filePosition;
+        auto& group = this->groups_[subblock.group];
+        group.compressedSize.Add(static_cast<double>(compressed_size));
+        if (subblock.pixels > 0)
+        {
+            group.bytesPerPixel.Add(static_cast<double>(compressed_size) / static_cast<double>(subblock.pixels));
+        }
+    }
+}
+
+void CCheckSubBlockSizeDistribution::CheckTileSizes()
+{
+    for (const auto& group : this->groups_)
+    {
+        if (group.tinySubBlocks >= kMinTinySubBlocksToReport && 2 * group.tinySubBlocks > group.subBlocks)
+        {
+            IResultGatherer::Finding finding(CCheckSubBlockSizeDistribution::kCheckType);
+            finding.severity = IResultGatherer::Severity::Warning;
+            stringstream ss;
+            ss << "in " << CCheckSubBlockSizeDistribution::GroupToString(group) << " " << group.tinySubBlocks << " of " << group.subBlocks
+                << " subblocks are smaller than " << this->additional_info_.minTileSize << " pixels";
+            finding.information = ss.str();
+            ss = stringstream();
+            ss << "smallest subblock: #" << group.smallestSubBlock.first << " (" << group.smallestSubBlock.second.w << "x" << group.smallestSubBlock.second.h << ")";
+            finding.details = ss.str();
+            this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        }
+
+        if (group.giantSubBlocks > 0)
+        {
+            IResultGatherer::Finding finding(CCheckSubBlockSizeDistribution::kCheckType);
+            finding.severity = IResultGatherer::Severity::Warning;
+            stringstream ss;
+            ss << "in " << CCheckSubBlockSizeDistribution::GroupToString(group) << " " << group.giantSubBlocks << " of " << group.subBlocks
+                << " subblocks are larger than " << this->additional_info_.maxTileSize << " pixels";
+            finding.information = ss.str();
+            ss = stringstream();
+            ss << "largest subblock: #" << group.largestSubBlock.first << " (" << group.largestSubBlock.second.w << "x" << group.largestSubBlock.second.h << ")";
+            finding.details = ss.str();
+            this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        }
+    }
+}
+
+void CCheckSubBlockSizeDistribution::ReportStatistics()
+{
+    this->AddHistogramTable("tile size (larger of width and height)", [](const Group& group)->const PowerOfTwoHistogram& { return group.tileSize; });
+    this->AddHistogramTable("compressed size in bytes (estimated)", [](const Group& group)->const PowerOfTwoHistogram& { return group.compressedSize; });
+    this->AddHistogramTable("compressed bytes per pixel (estimated)", [](const Group& group)->const PowerOfTwoHistogram& { return group.bytesPerPixel; });
+}
+
+void CCheckSubBlockSizeDistribution::AddHistogramTable(const std::string& name, const std::function<const PowerOfTwoHistogram& (const Group&)>& get_histogram)
+{
+    const auto bucket_bound = [](int exponent)->IResultGatherer::StatisticsValue
+        {
+            if (exponent >= 0)
+            {
+                return static_cast<int64_t>(1) << exponent;
+            }
+
+            return ldexp(1.0, exponent);
+        };
+
+    IResultGatherer::StatisticsTable table(CCheckSubBlockSizeDistribution::kCheckType);
+    table.name = name;
+    table.columns = { "channel", "minification", "from", "to", "subblocks" };
+    for (const auto& group : this->groups_)
+    {
+        for (const auto& bucket : get_histogram(group).buckets)
+        {
+            table.rows.push_back({
+                group.channelIndex == kNoChannelIndex ? string("none") : to_string(group.channelIndex),
+                static_cast<int64_t>(group.minification),
+                bucket_bound(bucket.first),
+                bucket_bound(bucket.first + 1),
+                bucket.second });
+        }
+    }
+
+    this->result_gatherer_.ReportStatistics(table);
+}
+
+/*static*/std::string CCheckSubBlockSizeDistribution::GroupToString(const Group& group)
+{
+    stringstream ss;
+    if (group.channelIndex == kNoChannelIndex)
+    {
+        ss << "the document (no channel)";
+    }
+    else
+    {
+        ss << "channel " << group.channelIndex;
+    }
+
+    if (group.minification == 1)
+    {
+        ss << " on pyramid-layer 0";
+    }
+    else
+    {
+        ss << " on the pyramid-layer with minification " << group.minification;
+    }
+
+    return ss.str();
+}
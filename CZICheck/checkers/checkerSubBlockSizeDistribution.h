@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "checkerbase.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// This checker analyzes the distribution of the sizes of the subblocks, using only the subblock-directory. Millions of
+/// tiny tiles make parsing the directory and the per-tile overhead expensive, whereas giant tiles make random access
+/// impossible. For each channel and pyramid-layer, histograms (with buckets of powers of two) of the physical tile size
+/// (the larger of width and height), of the compressed size and of the compressed bytes per pixel are built. Since the
+/// directory does not give the size of a subblock, the compressed size is estimated as the distance to the next
+/// subblock in the file. A warning is reported if a large number of subblocks is smaller than the minimum tile size,
+/// or if subblocks are larger than the maximum tile size (both given on the command line). The histograms are
+/// reported as statistics.
+class CCheckSubBlockSizeDistribution : public IChecker, CCheckerBase
+{
+private:
+    /// A histogram with buckets of powers of two, the bucket k containing the values in the range [2^k, 2^(k+1)).
+    struct PowerOfTwoHistogram
+    {
+        std::map<int, std::int64_t> buckets;
+
+        void Add(double value);
+    };
+
+    /// The subblocks of a channel within a pyramid-layer.
+    struct Group
+    {
+        int channelIndex{ 0 };                  ///< The channel index (or kNoChannelIndex).
+        int minification{ 1 };                  ///< The minification factor of the pyramid-layer (1 for pyramid-layer 0).
+        std::int64_t subBlocks{ 0 };            ///< The number of subblocks.
+        std::int64_t tinySubBlocks{ 0 };        ///< The number of subblocks smaller than the minimum tile size.
+        std::pair<int, libCZI::IntSize> smallestSubBlock{ -1, {} };  ///< The index and the size of the smallest subblock.
+        std::int64_t giantSubBlocks{ 0 };       ///< The number of subblocks larger than the maximum tile size.
+        std::pair<int, libCZI::IntSize> largestSubBlock{ -1, {} };   ///< The index and the size of the largest subblock.
+        PowerOfTwoHistogram tileSize;           ///< Histogram of the tile size (the larger of width and height).
+        PowerOfTwoHistogram compressedSize;     ///< Histogram of the (estimated) compressed size.
+        PowerOfTwoHistogram bytesPerPixel;      ///< Histogram of the (estimated) compressed bytes per pixel.
+    };
+
+    /// A subblock with its file-position, its number of pixels and the index of the group it belongs to.
+    struct SubBlockLocation
+    {
+        std::uint64_t filePosition;
+        std::uint64_t pixels;
+        std::uint32_t group;
+    };
+
+    std::vector<Group> groups_;
+public:
+    static const CZIChecks kCheckType = CZIChecks::SubBlockSizeDistribution;
+    static const char* kDisplayName;
+    static const char* kShortName;
+
+    CCheckSubBlockSizeDistribution(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        IResultGathererReport& result_gatherer,
+        const CheckerCreateInfo& additional_info);
+    void RunCheck() override;
+private:
+    std::vector<SubBlockLocation> GatherSubBlocks();
+    void AddCompressedSizes(const std::vector<SubBlockLocation>& subblocks);
+    void CheckTileSizes();
+    void ReportStatistics();
+    void AddHistogramTable(const std::string& name, const std::function<const PowerOfTwoHistogram& (const Group&)>& get_histogram);
+    static std::string GroupToString(const Group& group);
+};
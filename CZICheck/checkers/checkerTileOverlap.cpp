@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "checkerTileOverlap.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <memory>
+
+using namespace libCZI;
+using namespace std;
+
+/*static*/const char* CCheckTileOverlap::kDisplayName = "check the overlap of the tiles within a scene (on pyramid-layer 0)";
+/*static*/const char* CCheckTileOverlap::kShortName = "tileoverlap";
+
+namespace
+{
+    /// The maximum overlap depth (i.e. the number of tiles covering a point) which is considered normal. In a regular
+    /// mosaic, up to four tiles overlap at the corners.
+    constexpr int kMaxOverlapDepth = 4;
+}
+
+CCheckTileOverlap::CCheckTileOverlap(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    IResultGathererReport& result_gatherer,
+    const CheckerCreateInfo& additional_info) :
+    CCheckerBase(reader, result_gatherer, additional_info)
+{
+}
+
+void CCheckTileOverlap::RunCheck()
+{
+    this->result_gatherer_.StartCheck(CCheckTileOverlap::kCheckType);
+
+    this->RunCheckDefaultExceptionHandling([this]()
+        {
+            for (const auto& plane : CLayer0Planes::Gather(this->reader_, nullptr))
+            {
+                for (const auto& scene : plane.subBlocksPerScene)
+                {
+                    this->CheckPlaneAndScene(plane, scene.first, scene.second);
+                }
+            }
+        });
+
+    if (this->additional_info_.collectStatistics)
+    {
+        this->ReportStatistics();
+    }
+
+    this->result_gatherer_.FinishCheck(CCheckTileOverlap::kCheckType);
+}
+
+void CCheckTileOverlap::CheckPlaneAndScene(const CLayer0Planes::Plane& plane, int scene_index, const std::vector<CRectangleOverlap::Rectangle>& tiles)
+{
+    const auto coverage = CRectangleOverlap::CalculateCoverage(tiles);
+
+    auto& scene_statistics = this->scene_statistics_[scene_index];
+    ++scene_statistics.planes;
+    scene_statistics.tiles += static_cast<int64_t>(tiles.size());
+    scene_statistics.totalArea += coverage.totalArea;
+    scene_statistics.coveredArea += coverage.coveredArea;
+    scene_statistics.maximumDepth = max(scene_statistics.maximumDepth, coverage.maximumDepth);
+
+    if (coverage.coveredArea == 0)
+    {
+        return;
+    }
+
+    const double decode_amplification = static_cast<double>(coverage.totalArea) / static_cast<double>(coverage.coveredArea);
+    if (decode_amplification > this->additional_info_.maxDecodeAmplification || coverage.maximumDepth > kMaxOverlapDepth)
+    {
+        IResultGatherer::Finding finding(CCheckTileOverlap::kCheckType);
+        finding.severity = IResultGatherer::Severity::Warning;
+        stringstream ss;
+        ss << "in plane " << Utils::DimCoordinateToString(&plane.coordinate) << " the tiles of " << CCheckTileOverlap::GetSceneAsString(scene_index)
+            << " overlap, expected decode amplification: " << fixed << setprecision(2) << decode_amplification;
+        finding.information = ss.str();
+        stringstream ss_details;
+        ss_details << tiles.size() << " tiles, maximum overlap depth: " << coverage.maximumDepth
+            << ", redundant pixels: " << fixed << setprecision(1) << 100.0 * static_cast<double>(coverage.totalArea - coverage.coveredArea) / static_cast<double>(coverage.totalArea) << "%"
+            << ", overlap-area ratio: " << 100.0 * static_cast<double>(coverage.multiplyCoveredArea) / static_cast<double>(coverage.coveredArea) << "%";
+        finding.details = ss_details.str();
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+    }
+}
+
+void CCheckTileOverlap::ReportStatistics()
+{
+    IResultGatherer::StatisticsTable table(CCheckTileOverlap::kCheckType);
+    table.name = "tile overlap per scene";
+    table.columns = { "scene", "planes", "tiles", "total area", "covered area", "decode amplification", "maximum overlap depth" };
+    for (const auto& scene : this->scene_statistics_)
+    {
+        const auto& statistics = scene.second;
+        table.rows.push_back({
+            scene.first == CLayer0Planes::kNoSceneIndex ? string("none") : to_string(scene.first),
+            statistics.planes,
+            statistics.tiles,
+            static_cast<int64_t>(statistics.totalArea),
+            static_cast<int64_t>(statistics.coveredArea),
+            statistics.coveredArea > 0 ? static_cast<double>(statistics.totalArea) / static_cast<double>(statistics.coveredArea) : 0.0,
+            static_cast<int64_t>(statistics.maximumDepth) });
+    }
+
+    this->result_gatherer_.ReportStatistics(table);
+}
+
+/*static*/std::string CCheckTileOverlap::GetSceneAsString(int scene_index)
+{
+    if (scene_index == CLayer0Planes::kNoSceneIndex)
+    {
+        return "the document (no scene)";
+    }
+
+    stringstream ss;
+    ss << "scene " << scene_index;
+    return ss.str();
+}
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include "checkerbase.h"
+#include "layer0planes.h"
+
+/// This checker examines how much the tiles (i.e. the subblocks on pyramid-layer 0) within a scene and a plane
+/// overlap. Large overlaps make viewers decode (and composite) far more pixels than are visible. For each plane and
+/// scene, the "decode amplification" (the sum of the tile areas divided by the area covered), the maximum overlap
+/// depth and the fraction of redundant pixels are determined, and a warning is reported if the decode
+/// amplification exceeds the threshold given on the command line, or if the overlap depth is unusually large.
+class CCheckTileOverlap : public IChecker, CCheckerBase
+{
+private:
+    /// Statistics about the tiles of a scene, accumulated over all planes.
+    struct SceneStatistics
+    {
+        std::int64_t planes{ 0 };
+        std::int64_t tiles{ 0 };
+        std::uint64_t totalArea{ 0 };
+        std::uint64_t coveredArea{ 0 };
+        int maximumDepth{ 0 };
+    };
+
+    std::map<int, SceneStatistics> scene_statistics_;
+public:
+    static const CZIChecks kCheckType = CZIChecks::TileOverlapWithinScene;
+    static const char* kDisplayName;
+    static const char* kShortName;
+
+    CCheckTileOverlap(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        IResultGathererReport& result_gatherer,
+        const CheckerCreateInfo& additional_info);
+    void RunCheck() override;
+private:
+    void CheckPlaneAndScene(const CLayer0Planes::Plane& plane, int scene_index, const std::vector<CRectangleOverlap::Rectangle>& tiles);
+    void ReportStatistics();
+    static std::string GetSceneAsString(int scene_index);
+};
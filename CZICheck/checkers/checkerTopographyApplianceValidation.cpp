@@ -6,9 +6,6 @@
 #include <algorithm>
 #include <memory>
 #include <unordered_map>
-#include <utility>
-#include <functional>
-#include <string>
 #include <vector>
 
 using namespace std;
@@ -31,19 +28,19 @@ void CCheckTopographyApplianceMetadata::RunCheck()
 
     this->RunCheckDefaultExceptionHandling([this]()
         {
-            const auto czi_metadata = this->GetCziMetadataAndReportErrors(CCheckTopographyApplianceMetadata::kCheckType);
-            if (czi_metadata)
+            const auto metadata_index = this->GetMetadataIndexAndReportErrors(CCheckTopographyApplianceMetadata::kCheckType);
+            if (metadata_index)
             {
-                this->CheckValidDimensionInTopographyDataItems(czi_metadata);
+                this->CheckValidDimensionInTopographyDataItems(*metadata_index);
             }
         });
 
     this->result_gatherer_.FinishCheck(CCheckTopographyApplianceMetadata::kCheckType);
 }
 
-void CCheckTopographyApplianceMetadata::CheckValidDimensionInTopographyDataItems(const std::shared_ptr<libCZI::ICziMetadata>& czi_metadata)
+void CCheckTopographyApplianceMetadata::CheckValidDimensionInTopographyDataItems(const CMetadataIndex& metadata_index)
 {
-    if (!this->ExtractMetaDataDimensions(czi_metadata))
+    if (!this->ExtractMetaDataDimensions(metadata_index))
     {
         // we don't have any topography items and stop here
         return;
@@ -149,18 +146,20 @@ void CCheckTopographyApplianceMetadata::CheckValidDimensionInTopographyDataItems
     }
 }
 
-bool CCheckTopographyApplianceMetadata::ExtractMetaDataDimensions(const std::shared_ptr<libCZI::ICziMetadata>& czi_metadata)
+bool CCheckTopographyApplianceMetadata::ExtractMetaDataDimensions(const CMetadataIndex& metadata_index)
 {
     // within the TopographyData we allow
     // any number of TopographyDataItem which itself can contain a set of Textures and a set of Heightmaps
     // within the heightmaps AND Textures, each item reside in its own channel.
-    string topography_path{ CCheckTopographyApplianceMetadata::kImageAppliancePath };
-    topography_path
-        .append("/Appliance[Id=")
-        .append(CCheckTopographyApplianceMetadata::kTopographyItemId)
-        .append("]");
-
-    const auto topo_metadata{ czi_metadata->GetChildNodeReadonly(topography_path.c_str()) };
+    pugi::xml_node topo_metadata;
+    for (const auto& appliance : metadata_index.GetNodes(CCheckTopographyApplianceMetadata::kImageAppliancePath))
+    {
+        if (CMetadataIndex::GetAttributeValue(appliance, PUGIXML_TEXT("Id")) == CCheckTopographyApplianceMetadata::kTopographyItemId)
+        {
+            topo_metadata = appliance;
+            break;
+        }
+    }
 
     if (!topo_metadata)
     {
@@ -168,68 +167,25 @@ bool CCheckTopographyApplianceMetadata::ExtractMetaDataDimensions(const std::sha
         return false;
     }
 
-    vector<vector<pair<wstring, wstring>>> heightmaps;
-    vector<vector<pair<wstring, wstring>>> textures;
-
-    // we need a "named" lambda here to call it recursively
-    std::function<bool(std::shared_ptr < libCZI::IXmlNodeRead>)> enumChildrenLambda =
-        [this, &heightmaps, &textures, &enumChildrenLambda](const std::shared_ptr<libCZI::IXmlNodeRead>& xmlnode) -> bool
+    // the heightmaps and textures are looked up (at any depth below the topography item) with the index, and the
+    //  dimensions are parsed directly from the attributes
+    metadata_index.EnumerateDescendants(
+        topo_metadata,
+        CCheckTopographyApplianceMetadata::kHeightMapItemKey,
+        [this](const pugi::xml_node& heightmap) -> bool
         {
-            std::vector<std::pair<std::wstring, std::wstring>> current_texture;
-            std::vector<std::pair<std::wstring, std::wstring>> current_heightmap;
-
-            auto textureLambda = [&current_texture](const std::wstring& attr, const std::wstring& val) -> bool
-                {
-                    current_texture.push_back({ attr, val });
-                    return true;
-                };
-
-            auto heighmapLambda = [&current_heightmap](const std::wstring& attr, const std::wstring& val) -> bool
-                {
-                    current_heightmap.push_back({ attr, val });
-                    return true;
-                };
-
-            auto node_name = xmlnode->Name();
-            if (node_name == CCheckTopographyApplianceMetadata::kTextureItemKey)
-            {
-                xmlnode->EnumAttributes(textureLambda);
-
-                if (!current_texture.empty())
-                {
-                    textures.push_back(current_texture);
-                }
-            }
-
-            if (node_name == CCheckTopographyApplianceMetadata::kHeightMapItemKey)
-            {
-                xmlnode->EnumAttributes(heighmapLambda);
-
-                if (!current_heightmap.empty())
-                {
-                    heightmaps.push_back(current_heightmap);
-                }
-            }
-
-            // recursively go through child items 
-            xmlnode->EnumChildren(enumChildrenLambda);
-
+            this->SetBoundsFromAttributes(heightmap, this->heightmap_views_);
             return true;
-        };
-
-    // call the enumeration lambda
-    topo_metadata->EnumChildren(enumChildrenLambda);
-
-    // parse the dimension vectors
-    for (const auto& hm : heightmaps)
-    {
-        this->SetBoundsFromVector(hm, this->heightmap_views_);
-    }
+        });
 
-    for (const auto& tx : textures)
-    {
-        this->SetBoundsFromVector(tx, this->texture_views_);
-    }
+    metadata_index.EnumerateDescendants(
+        topo_metadata,
+        CCheckTopographyApplianceMetadata::kTextureItemKey,
+        [this](const pugi::xml_node& texture) -> bool
+        {
+            this->SetBoundsFromAttributes(texture, this->texture_views_);
+            return true;
+        });
 
     if (!this->heightmap_views_.empty() || !this->texture_views_.empty())
     {
@@ -268,26 +224,34 @@ bool CCheckTopographyApplianceMetadata::CheckExistenceOfSpecifiedChannels(std::u
     return std::all_of(indices_set.cbegin(), indices_set.cend(), [](const auto& el) { return el.second; });
 }
 
-bool CCheckTopographyApplianceMetadata::SetBoundsFromVector(const std::vector<std::pair<std::wstring, std::wstring>>& vec, std::vector<std::unordered_map<char, DimensionView>>& view)
+bool CCheckTopographyApplianceMetadata::SetBoundsFromAttributes(const pugi::xml_node& node, std::vector<std::unordered_map<char, DimensionView>>& view)
 {
+    // nodes without attributes are ignored
+    if (!node.first_attribute())
+    {
+        return true;
+    }
+
     // using a set here to ensure exactly one element per dimension
     unordered_map<char, DimensionView> configurations;
 
-    const wstring kStart = L"Start";
-    const wstring kSize = L"Size";
+    const CMetadataIndex::StringView kStart = PUGIXML_TEXT("Start");
+    const CMetadataIndex::StringView kSize = PUGIXML_TEXT("Size");
 
-    for (const auto& element : vec)
+    for (const auto& attribute : node.attributes())
     {
+        const CMetadataIndex::StringView attribute_name = attribute.name();
+        if (attribute_name.empty())
+        {
+            continue;
+        }
+
         // get the dimension index
-        char dim{ static_cast<char>(element.first.back()) };
+        char dim{ static_cast<char>(attribute_name.back()) };
 
         configurations.insert({ dim, DimensionView() });
         int value{ -1 };
-        try
-        {
-            value = stoi(element.second);
-        }
-        catch (const invalid_argument&)
+        if (!CMetadataIndex::TryParseInt(attribute.value(), &value))
         {
             // this will ensure an "invalid" dimension later
             value = -1;
@@ -300,12 +264,12 @@ bool CCheckTopographyApplianceMetadata::SetBoundsFromVector(const std::vector<st
         }
 
         // -1 means not set
-        if (element.first.find(kStart) != string::npos && config.Start == -1)
+        if (attribute_name.find(kStart) != CMetadataIndex::StringView::npos && config.Start == -1)
         {
             config.Start = value;
         }
 
-        if (element.first.find(kSize) != string::npos && config.Size == -1)
+        if (attribute_name.find(kSize) != CMetadataIndex::StringView::npos && config.Size == -1)
         {
             config.Size = value;
         }
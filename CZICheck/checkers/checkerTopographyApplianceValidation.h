@@ -7,9 +7,7 @@
 #include "checkerbase.h"
 #include <memory>
 #include <vector>
-#include <string>
 #include <unordered_map>
-#include <utility>
 
 /// This checker validates the topography-XML-metadata.
 class CCheckTopographyApplianceMetadata : public IChecker, CCheckerBase
@@ -34,10 +32,10 @@ private:
         }
     };
 
-    static constexpr const char* kTopographyItemId = "Topography:1";
-    static constexpr const char* kImageAppliancePath = "ImageDocument/Metadata/Appliances";
-    static constexpr const wchar_t* kTextureItemKey = L"Texture";
-    static constexpr const wchar_t* kHeightMapItemKey = L"HeightMap";
+    static constexpr const pugi::char_t* kTopographyItemId = PUGIXML_TEXT("Topography:1");
+    static constexpr const pugi::char_t* kImageAppliancePath = PUGIXML_TEXT("ImageDocument/Metadata/Appliances/Appliance");
+    static constexpr const pugi::char_t* kTextureItemKey = PUGIXML_TEXT("Texture");
+    static constexpr const pugi::char_t* kHeightMapItemKey = PUGIXML_TEXT("HeightMap");
 
     std::vector<std::unordered_map<char, DimensionView>> texture_views_;
     std::vector<std::unordered_map<char, DimensionView>> heightmap_views_;
@@ -54,9 +52,9 @@ public:
     void RunCheck() override;
 
 private:
-    void CheckValidDimensionInTopographyDataItems(const std::shared_ptr<libCZI::ICziMetadata>& czi_metadata);
+    void CheckValidDimensionInTopographyDataItems(const CMetadataIndex& metadata_index);
 
-    bool SetBoundsFromVector(const std::vector<std::pair<std::wstring, std::wstring>>&, std::vector<std::unordered_map<char, DimensionView>>&);
+    bool SetBoundsFromAttributes(const pugi::xml_node& node, std::vector<std::unordered_map<char, DimensionView>>& view);
     bool CheckExistenceOfSpecifiedChannels(std::unordered_map<int, bool>& indices_set);
-    bool ExtractMetaDataDimensions(const std::shared_ptr<libCZI::ICziMetadata>& czi_metadata);
+    bool ExtractMetaDataDimensions(const CMetadataIndex& metadata_index);
 };
@@ -27,24 +27,28 @@ void CCheckBasicMetadataValidation::RunCheck()
 
     this->RunCheckDefaultExceptionHandling([this]()
         {
-            // note: "GetCziMetadataAndReportErrors" will report a warning in case the ICziMetadata-object cannot be constructed
-            const auto czi_metadata = this->GetCziMetadataAndReportErrors(CCheckBasicMetadataValidation::kCheckType);
-            if (czi_metadata)
+            // note: "GetMetadataIndexAndReportErrors" will report a finding in case the metadata cannot be read or parsed
+            const auto metadata_index = this->GetMetadataIndexAndReportErrors(CCheckBasicMetadataValidation::kCheckType);
+            if (metadata_index)
             {
-                const auto doc_info = czi_metadata->GetDocumentInfo();
-
-                this->CheckSizeInformation(doc_info);
-                this->CheckChannelInformation(doc_info);
-                this->CheckPixelTypeInformation(czi_metadata);
+                this->CheckSizeInformation(*metadata_index);
+                this->CheckChannelInformation(*metadata_index);
+                this->CheckPixelTypeInformation(*metadata_index);
             }
         });
 
     this->result_gatherer_.FinishCheck(CCheckBasicMetadataValidation::kCheckType);
 }
 
-void CCheckBasicMetadataValidation::CheckSizeInformation(const std::shared_ptr<libCZI::ICziMultiDimensionDocumentInfo>& doc_info) const
+void CCheckBasicMetadataValidation::CheckSizeInformation(const CMetadataIndex& metadata_index) const
 {
-    vector<DimensionIndex> valid_dimension_in_metadata = doc_info->GetDimensions();
+    const auto dimensions_in_metadata = CCheckBasicMetadataValidation::GetDimensionsFromMetadata(metadata_index);
+    vector<DimensionIndex> valid_dimension_in_metadata;
+    valid_dimension_in_metadata.reserve(dimensions_in_metadata.size());
+    for (const auto& dimension_info : dimensions_in_metadata)
+    {
+        valid_dimension_in_metadata.emplace_back(dimension_info.dimension);
+    }
 
     // first, check whether all dimension which are present in the "statistics" are also present in the XML-metadata
     auto statistics = this->reader_->GetStatistics();
@@ -84,19 +88,14 @@ void CCheckBasicMetadataValidation::CheckSizeInformation(const std::shared_ptr<l
 
     // now, check whether the start/size are the same
     vector<DimensionIndex> dimensions_where_start_or_size_differ;
-    for (auto dim : valid_dimension_in_metadata)
+    for (const auto& dimension_info : dimensions_in_metadata)
     {
         int start_index_statistics, size_statistics;
-        if (statistics.dimBounds.TryGetInterval(dim, &start_index_statistics, &size_statistics))
+        if (statistics.dimBounds.TryGetInterval(dimension_info.dimension, &start_index_statistics, &size_statistics))
         {
-            auto startEndFromMetadata = doc_info->GetDimensionInfo(dim);
-
-            int startIndexMetadata, endIndexMetadata;
-            startEndFromMetadata->GetInterval(&startIndexMetadata, &endIndexMetadata);
-
-            if (start_index_statistics != startIndexMetadata || endIndexMetadata != start_index_statistics + size_statistics)
+            if (start_index_statistics != dimension_info.start || dimension_info.size != size_statistics)
             {
-                dimensions_where_start_or_size_differ.emplace_back(dim);
+                dimensions_where_start_or_size_differ.emplace_back(dimension_info.dimension);
             }
         }
     }
@@ -124,7 +123,7 @@ void CCheckBasicMetadataValidation::CheckSizeInformation(const std::shared_ptr<l
     }
 }
 
-void CCheckBasicMetadataValidation::CheckChannelInformation(const std::shared_ptr<libCZI::ICziMultiDimensionDocumentInfo>& doc_info) const
+void CCheckBasicMetadataValidation::CheckChannelInformation(const CMetadataIndex& metadata_index) const
 {
     // compare the number of nodes in dimensions/channel to the number of channels in statistics
     int channel_count_from_statistics;
@@ -135,8 +134,8 @@ void CCheckBasicMetadataValidation::CheckChannelInformation(const std::shared_pt
         return;
     }
 
-    const auto channel_info = doc_info->GetDimensionChannelsInfo();
-    if (!channel_info)
+    vector<pugi::xml_node> channels;
+    if (!CCheckBasicMetadataValidation::TryGetChannelNodes(metadata_index, channels))
     {
         IResultGatherer::Finding finding(CCheckBasicMetadataValidation::kCheckType);
         finding.severity = IResultGatherer::Severity::Warning;
@@ -145,23 +144,21 @@ void CCheckBasicMetadataValidation::CheckChannelInformation(const std::shared_pt
         return;
     }
 
-    if (channel_info->GetChannelCount() != channel_count_from_statistics)
+    if (channels.size() != static_cast<size_t>(channel_count_from_statistics))
     {
         IResultGatherer::Finding finding(CCheckBasicMetadataValidation::kCheckType);
         finding.severity = IResultGatherer::Severity::Warning;
         stringstream ss;
-        ss << "document statistics gives " << channel_count_from_statistics << " channels, whereas in XML-metadata " << channel_info->GetChannelCount() << " channels are found.";
+        ss << "document statistics gives " << channel_count_from_statistics << " channels, whereas in XML-metadata " << channels.size() << " channels are found.";
         finding.information = ss.str();
         this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
     }
 }
 
-void CCheckBasicMetadataValidation::CheckPixelTypeInformation(const std::shared_ptr<libCZI::ICziMetadata>& metadata) const
+void CCheckBasicMetadataValidation::CheckPixelTypeInformation(const CMetadataIndex& metadata_index) const
 {
-    const auto doc_info = metadata->GetDocumentInfo();
-
-    const auto dimensions_channels_info = doc_info->GetDimensionChannelsInfo();
-    if (!dimensions_channels_info)
+    vector<pugi::xml_node> channels;
+    if (!CCheckBasicMetadataValidation::TryGetChannelNodes(metadata_index, channels))
     {
         IResultGatherer::Finding finding(CCheckBasicMetadataValidation::kCheckType);
         finding.severity = IResultGatherer::Severity::Info;
@@ -170,12 +167,12 @@ void CCheckBasicMetadataValidation::CheckPixelTypeInformation(const std::shared_
         return;
     }
 
-    for (int channelIndex = 0; channelIndex < dimensions_channels_info->GetChannelCount(); channelIndex++)
+    for (int channelIndex = 0; channelIndex < static_cast<int>(channels.size()); channelIndex++)
     {
-        const auto channel_info = dimensions_channels_info->GetChannel(channelIndex);
+        const auto& channel_node = channels[channelIndex];
         PixelType channel_info_pixel_type;
         bool channel_info_pixel_type_valid = false;
-        if (channel_info->TryGetPixelType(&channel_info_pixel_type))
+        if (CCheckBasicMetadataValidation::TryParsePixelType(channel_node.child_value(PUGIXML_TEXT("PixelType")), &channel_info_pixel_type))
         {
             SubBlockInfo subBlockInfo;
             // there's another checker for pixelType consistency for all subBlocks in a channel, but here we validate the metadata information
@@ -218,7 +215,7 @@ void CCheckBasicMetadataValidation::CheckPixelTypeInformation(const std::shared_
 
         // check for presence and basic validity of "ComponentBitCount" information
         int channel_info_component_bit_count;
-        if (!channel_info->TryGetComponentBitCount(&channel_info_component_bit_count))
+        if (!CMetadataIndex::TryParseInt(channel_node.child_value(PUGIXML_TEXT("ComponentBitCount")), &channel_info_component_bit_count))
         {
             // Report a warning if no ComponentBitCount information is found in metadata if
             // * the PixelType information is invalid (i.e. not present)
@@ -263,6 +260,108 @@ void CCheckBasicMetadataValidation::CheckPixelTypeInformation(const std::shared_
     }
 }
 
+/*static*/std::vector<CCheckBasicMetadataValidation::DimensionInfo> CCheckBasicMetadataValidation::GetDimensionsFromMetadata(const CMetadataIndex& metadata_index)
+{
+    static const struct
+    {
+        const pugi::char_t* sizeElementName;
+        const pugi::char_t* startElementName;
+        DimensionIndex dimension;
+    } kDimensionElements[] =
+    {
+        { PUGIXML_TEXT("SizeZ"), PUGIXML_TEXT("StartZ"), DimensionIndex::Z },
+        { PUGIXML_TEXT("SizeC"), PUGIXML_TEXT("StartC"), DimensionIndex::C },
+        { PUGIXML_TEXT("SizeT"), PUGIXML_TEXT("StartT"), DimensionIndex::T },
+        { PUGIXML_TEXT("SizeR"), PUGIXML_TEXT("StartR"), DimensionIndex::R },
+        { PUGIXML_TEXT("SizeS"), PUGIXML_TEXT("StartS"), DimensionIndex::S },
+        { PUGIXML_TEXT("SizeI"), PUGIXML_TEXT("StartI"), DimensionIndex::I },
+        { PUGIXML_TEXT("SizeH"), PUGIXML_TEXT("StartH"), DimensionIndex::H },
+        { PUGIXML_TEXT("SizeV"), PUGIXML_TEXT("StartV"), DimensionIndex::V },
+        { PUGIXML_TEXT("SizeB"), PUGIXML_TEXT("StartB"), DimensionIndex::B },
+    };
+
+    vector<DimensionInfo> dimensions;
+    const auto image_node = metadata_index.GetNode(CCheckBasicMetadataValidation::kImagePath);
+    if (!image_node)
+    {
+        return dimensions;
+    }
+
+    for (const auto& element : kDimensionElements)
+    {
+        DimensionInfo dimension_info{ element.dimension, 0, 0 };
+        if (CMetadataIndex::TryParseInt(image_node.child_value(element.sizeElementName), &dimension_info.size))
+        {
+            if (!CMetadataIndex::TryParseInt(image_node.child_value(element.startElementName), &dimension_info.start))
+            {
+                dimension_info.start = 0;
+            }
+
+            dimensions.emplace_back(dimension_info);
+        }
+    }
+
+    return dimensions;
+}
+
+/*static*/bool CCheckBasicMetadataValidation::TryGetChannelNodes(const CMetadataIndex& metadata_index, std::vector<pugi::xml_node>& channels)
+{
+    const auto channels_node = metadata_index.GetNode(CCheckBasicMetadataValidation::kChannelsPath);
+    if (!channels_node)
+    {
+        return false;
+    }
+
+    for (const auto& channel_node : channels_node.children(PUGIXML_TEXT("Channel")))
+    {
+        channels.emplace_back(channel_node);
+    }
+
+    return true;
+}
+
+/*static*/bool CCheckBasicMetadataValidation::TryParsePixelType(CMetadataIndex::StringView text, libCZI::PixelType* pixel_type)
+{
+    static const struct
+    {
+        const pugi::char_t* name;
+        PixelType pixelType;
+    } kPixelTypeNames[] =
+    {
+        { PUGIXML_TEXT("Gray8"), PixelType::Gray8 },
+        { PUGIXML_TEXT("Gray16"), PixelType::Gray16 },
+        { PUGIXML_TEXT("Gray32"), PixelType::Gray32 },
+        { PUGIXML_TEXT("Gray32Float"), PixelType::Gray32Float },
+        { PUGIXML_TEXT("Gray64Float"), PixelType::Gray64Float },
+        { PUGIXML_TEXT("Bgr24"), PixelType::Bgr24 },
+        { PUGIXML_TEXT("Bgr48"), PixelType::Bgr48 },
+        { PUGIXML_TEXT("Bgr96Float"), PixelType::Bgr96Float },
+        { PUGIXML_TEXT("Bgra32"), PixelType::Bgra32 },
+        { PUGIXML_TEXT("Gray64ComplexFloat"), PixelType::Gray64ComplexFloat },
+        { PUGIXML_TEXT("Bgr192ComplexFloat"), PixelType::Bgr192ComplexFloat },
+    };
+
+    // leading and trailing whitespace is ignored
+    const CMetadataIndex::StringView kWhitespace = PUGIXML_TEXT(" \t\n\r\v\f");
+    const auto first = text.find_first_not_of(kWhitespace);
+    if (first == CMetadataIndex::StringView::npos)
+    {
+        return false;
+    }
+
+    text = text.substr(first, text.find_last_not_of(kWhitespace) - first + 1);
+    for (const auto& item : kPixelTypeNames)
+    {
+        if (text == item.name)
+        {
+            *pixel_type = item.pixelType;
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /*static*/bool CCheckBasicMetadataValidation::IsComponentBitCountExpectedForPixelType(libCZI::PixelType pixel_type)
 {
     switch (pixel_type)  // NOLINT(clang-diagnostic-switch-enum)
@@ -7,6 +7,7 @@
 #include "checkerbase.h"
 #include <memory>
 #include <optional>
+#include <vector>
 
 /// This checker performs some basic checks on the XML-metadata.
 class CCheckBasicMetadataValidation : public IChecker, CCheckerBase
@@ -22,24 +23,59 @@ public:
         const CheckerCreateInfo& additional_info);
     void RunCheck() override;
 private:
+    /// The start and size of a dimension as given in the XML-metadata.
+    struct DimensionInfo
+    {
+        libCZI::DimensionIndex dimension;
+        int start;
+        int size;
+    };
+
+    static constexpr const pugi::char_t* kImagePath = PUGIXML_TEXT("ImageDocument/Metadata/Information/Image");
+    static constexpr const pugi::char_t* kChannelsPath = PUGIXML_TEXT("ImageDocument/Metadata/Information/Image/Dimensions/Channels");
+
     /// Check whether the information at "Metadata/Information/Image/SizeX or StartX" matches the
     /// subblock-statistics.
     ///
-    /// \param  doc_info The libCZI-document-info object.
-    void CheckSizeInformation(const std::shared_ptr<libCZI::ICziMultiDimensionDocumentInfo>& doc_info) const;
+    /// \param  metadata_index  The index of the XML-metadata.
+    void CheckSizeInformation(const CMetadataIndex& metadata_index) const;
 
     /// Check the channel information (Metadata/Information/Dimensions/Channels).
     ///
-    /// \param  doc_info The libCZI-document-info object.
-    void CheckChannelInformation(const std::shared_ptr<libCZI::ICziMultiDimensionDocumentInfo>& doc_info) const;
+    /// \param  metadata_index  The index of the XML-metadata.
+    void CheckChannelInformation(const CMetadataIndex& metadata_index) const;
 
     /// Check that the pixel type information in "Metadata/Information/Dimensions/Channels" agrees to
     /// the pixeltype found in the actual subblock. Currently, the pixeltype of an arbitrary subblock
     /// (of a given channel) is checked (but there is another checker which verifies that all subblocks
     /// of a given channel have the same pixeltype).
     ///
-    /// \param  metadata    The libCZI-document-info object.
-    void CheckPixelTypeInformation(const std::shared_ptr<libCZI::ICziMetadata>& metadata) const;
+    /// \param  metadata_index  The index of the XML-metadata.
+    void CheckPixelTypeInformation(const CMetadataIndex& metadata_index) const;
+
+    /// Gets the dimensions for which a size is given in "Metadata/Information/Image" (i.e. elements "SizeZ", "SizeC" and
+    /// so on). The start is taken from the respective element "StartZ", "StartC" and so on - and if it is not present, it is 0.
+    ///
+    /// \param  metadata_index  The index of the XML-metadata.
+    ///
+    /// \returns    The dimensions given in the XML-metadata.
+    static std::vector<DimensionInfo> GetDimensionsFromMetadata(const CMetadataIndex& metadata_index);
+
+    /// Gets the "Channel"-elements in "Metadata/Information/Dimensions/Channels".
+    ///
+    /// \param          metadata_index  The index of the XML-metadata.
+    /// \param [out]    channels        The "Channel"-elements are put here (in document order).
+    ///
+    /// \returns    True if the "Channels"-element is present; false otherwise.
+    static bool TryGetChannelNodes(const CMetadataIndex& metadata_index, std::vector<pugi::xml_node>& channels);
+
+    /// Attempts to parse the pixeltype from the specified text (e.g. "Gray16"), as it is given in the element "PixelType".
+    ///
+    /// \param          text        The text.
+    /// \param [out]    pixel_type  If successful, the pixeltype is put here.
+    ///
+    /// \returns    True if it succeeds; false otherwise.
+    static bool TryParsePixelType(CMetadataIndex::StringView text, libCZI::PixelType* pixel_type);
 
     static bool IsComponentBitCountExpectedForPixelType(libCZI::PixelType pixel_type);
 
@@ -6,7 +6,69 @@
 
 #if CZICHECK_XERCESC_AVAILABLE
 
+#include <exception>
+#include <memory>
+#include <mutex>
+
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/internal/XMLGrammarPoolImpl.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/util/BinMemInputStream.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/validators/common/Grammar.hpp>
+
 #include <ImageMetadataFlattened.frag>
+#if CZICHECK_PRECOMPILED_XSD_GRAMMAR_AVAILABLE
+#include <ImageMetadataGrammar.frag>
+#endif
+
+using namespace std;
+
+XERCES_CPP_NAMESPACE_USE
+
+namespace
+{
+    mutex grammar_pool_mutex;
+    unique_ptr<XMLGrammarPoolImpl> grammar_pool;
+    ZenCompleteXsdGrammarPoolInfo grammar_pool_info;
+
+#if CZICHECK_PRECOMPILED_XSD_GRAMMAR_AVAILABLE
+    /// Attempts to create a pool from the grammar serialized at build time. This fails if the serialized
+    /// grammar is not compatible with the Xerces library in use (e.g. because it was created with a different
+    /// version), in which case null is returned.
+    unique_ptr<XMLGrammarPoolImpl> TryCreatePoolFromSerializedGrammar()
+    {
+        try
+        {
+            auto pool = make_unique<XMLGrammarPoolImpl>(XMLPlatformUtils::fgMemoryManager);
+            BinMemInputStream stream(zenSerializedGrammarPool, sizeof(zenSerializedGrammarPool), BinMemInputStream::BufOpt_Reference);
+            pool->deserializeGrammars(&stream);
+            return pool;
+        }
+        catch (const XMLException&)
+        {
+        }
+        catch (const exception&)
+        {
+        }
+
+        return nullptr;
+    }
+#endif
+
+    void LoadGrammarFromXsd(XMLGrammarPoolImpl& pool)
+    {
+        XercesDOMParser parser(nullptr, XMLPlatformUtils::fgMemoryManager, &pool);
+        parser.setDoNamespaces(true);
+        parser.setDoSchema(true);
+        parser.setDisableDefaultEntityResolution(true);
+
+        size_t size_zen_complete_xsd;
+        const char* zen_complete_xsd = GetZenCompleteXsd(&size_zen_complete_xsd);
+        const MemBufInputSource xml_metadata_schema(reinterpret_cast<const XMLByte*>(zen_complete_xsd), size_zen_complete_xsd, "schema.xsd", false);
+        parser.loadGrammar(xml_metadata_schema, Grammar::SchemaGrammarType, true);
+    }
+}
 
 const char* GetZenCompleteXsd(size_t* size)
 {
@@ -18,4 +80,43 @@ const char* GetZenCompleteXsd(size_t* size)
     return reinterpret_cast<const char*>(zenFlattenedCompleteXsd);
 }
 
+XERCES_CPP_NAMESPACE::XMLGrammarPool* GetZenCompleteXsdGrammarPool(ZenCompleteXsdGrammarPoolInfo* info)
+{
+    const lock_guard<mutex> lock(grammar_pool_mutex);
+    if (!grammar_pool)
+    {
+        const auto start_time = chrono::steady_clock::now();
+        unique_ptr<XMLGrammarPoolImpl> pool;
+#if CZICHECK_PRECOMPILED_XSD_GRAMMAR_AVAILABLE
+        pool = TryCreatePoolFromSerializedGrammar();
+#endif
+        const bool from_serialized_grammar = pool != nullptr;
+        if (!from_serialized_grammar)
+        {
+            pool = make_unique<XMLGrammarPoolImpl>(XMLPlatformUtils::fgMemoryManager);
+            LoadGrammarFromXsd(*pool);
+        }
+
+        // once locked, the pool is not modified anymore (grammars encountered while parsing are not added to it), so
+        //  it can be used by multiple parsers concurrently
+        pool->lockPool();
+        grammar_pool = std::move(pool);
+        grammar_pool_info.fromSerializedGrammar = from_serialized_grammar;
+        grammar_pool_info.creationTime = chrono::steady_clock::now() - start_time;
+    }
+
+    if (info != nullptr)
+    {
+        *info = grammar_pool_info;
+    }
+
+    return grammar_pool.get();
+}
+
+void ReleaseZenCompleteXsdGrammarPool()
+{
+    const lock_guard<mutex> lock(grammar_pool_mutex);
+    grammar_pool.reset();
+}
+
 #endif
@@ -8,8 +8,11 @@
 
 #if CZICHECK_XERCESC_AVAILABLE
 
+#include <chrono>
 #include <cstddef>
 
+#include <xercesc/framework/XMLGrammarPool.hpp>
+
 /// Gets the XSD-schema for the ZEN-XML-metadata. The returned pointer is
 /// pointing to static memory and must not be freed. It is valid for the
 /// whole runtime of the application.
@@ -19,4 +22,27 @@
 /// \returns    Pointer to the XSD-schema.
 const char* GetZenCompleteXsd(size_t* size);
 
+/// Information about how the grammar pool (as returned by 'GetZenCompleteXsdGrammarPool') was created.
+struct ZenCompleteXsdGrammarPoolInfo
+{
+    /// True if the pool was created from the grammar serialized at build time, false if it was created by parsing the XSD-schema.
+    bool fromSerializedGrammar{ false };
+
+    /// The time it took to create the pool.
+    std::chrono::nanoseconds creationTime{ 0 };
+};
+
+/// Gets a grammar pool containing the grammar for the XSD-schema for the ZEN-XML-metadata. The pool is created on first
+/// use - from the grammar serialized at build time (if available and compatible with the Xerces library in use), or
+/// otherwise by parsing the XSD-schema. The pool is locked, so it can be shared read-only by multiple parsers (also
+/// concurrently). The pool must be released with 'ReleaseZenCompleteXsdGrammarPool' before Xerces is terminated.
+///
+/// \param [out] info If non-null, information about how the pool was created is put here.
+///
+/// \returns    The grammar pool (which is owned by this module).
+XERCES_CPP_NAMESPACE::XMLGrammarPool* GetZenCompleteXsdGrammarPool(ZenCompleteXsdGrammarPoolInfo* info);
+
+/// Releases the grammar pool (if it was created). This must be called before 'XMLPlatformUtils::Terminate'.
+void ReleaseZenCompleteXsdGrammarPool();
+
 #endif
@@ -6,14 +6,17 @@
 
 #if CZICHECK_XERCESC_AVAILABLE
 
+#include <chrono>
 #include <exception>
 #include <sstream>
 #include <memory>
 #include <string>
 
+#include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/util/XMLString.hpp>
-#include <xercesc/parsers/XercesDOMParser.hpp>
-#include <xercesc/framework/LocalFileInputSource.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
 #include <xercesc/sax/ErrorHandler.hpp>
 #include <xercesc/sax/SAXParseException.hpp>
 #include <xercesc/validators/common/Grammar.hpp>
@@ -101,36 +104,57 @@ void CCheckXmlMetadataXsdValidation::RunCheck()
 
             if (!xml.empty())
             {
-                XercesDOMParser dom_parser;
-                ParserErrorHandler parser_error_handler(*this);
-
-                dom_parser.setErrorHandler(&parser_error_handler);
-
-                size_t size_zen_complete_xsd;
-                const char* zen_complete_xsd = GetZenCompleteXsd(&size_zen_complete_xsd);
-
-                const MemBufInputSource xml_metadata_schema(reinterpret_cast<const XMLByte*>(zen_complete_xsd), size_zen_complete_xsd, "schema.xsd", false);
-
-                // note: the grammar object is owned by the parser (so, we must not delete it)
-                Grammar* g = dom_parser.loadGrammar(xml_metadata_schema, Grammar::SchemaGrammarType, true);
-
-                dom_parser.setValidationScheme(XercesDOMParser::Val_Always);
-                dom_parser.setDoNamespaces(true);
-                dom_parser.useCachedGrammarInParse(true);
-                dom_parser.setDoSchema(true);
-                dom_parser.setValidationConstraintFatal(true);
-                dom_parser.setExitOnFirstFatalError(false);
-                dom_parser.setExternalNoNamespaceSchemaLocation("");
-                dom_parser.setDisableDefaultEntityResolution(true); // Disable DTD processing in order to prevent XXE attacks (c.f. https://owasp.org/www-community/vulnerabilities/XML_External_Entity_(XXE)_Processing).
-
-                const MemBufInputSource czi_xml_metadata(reinterpret_cast<const XMLByte*>(xml.c_str()), xml.size(), "dummy", false);
-                dom_parser.parse(czi_xml_metadata);
+                this->ValidateXml(xml);
             }
         });
         
     this->result_gatherer_.FinishCheck(CCheckXmlMetadataXsdValidation::kCheckType);
 }
 
+void CCheckXmlMetadataXsdValidation::ValidateXml(const std::string& xml)
+{
+    // the grammar for the schema is created only once (and preferably from the grammar serialized at build time), and
+    //  the pool containing it is shared read-only by all parsers
+    ZenCompleteXsdGrammarPoolInfo grammar_pool_info;
+    XMLGrammarPool* grammar_pool = GetZenCompleteXsdGrammarPool(&grammar_pool_info);
+    if (this->additional_info_.collectStatistics)
+    {
+        this->ReportGrammarStatistics(grammar_pool_info);
+    }
+
+    // the XML is validated with a SAX-parser, so that no DOM-tree is built - the XML validated is the text as
+    //  given by the libCZI-metadata-object, so the positions reported are the same as with a DOM-parser
+    ParserErrorHandler parser_error_handler(*this);
+    static const XMLCh kEmptyString[] = { 0 };
+    const unique_ptr<SAX2XMLReader> sax_reader(XMLReaderFactory::createXMLReader(XMLPlatformUtils::fgMemoryManager, grammar_pool));
+    sax_reader->setErrorHandler(&parser_error_handler);
+    sax_reader->setFeature(XMLUni::fgSAX2CoreValidation, true);
+    sax_reader->setFeature(XMLUni::fgXercesDynamic, false);     // i.e. "validation scheme = always"
+    sax_reader->setFeature(XMLUni::fgSAX2CoreNameSpaces, true);
+    sax_reader->setFeature(XMLUni::fgXercesUseCachedGrammarInParse, true);
+    sax_reader->setFeature(XMLUni::fgXercesSchema, true);
+    sax_reader->setFeature(XMLUni::fgXercesValidationErrorAsFatal, true);
+    sax_reader->setFeature(XMLUni::fgXercesContinueAfterFatalError, true);
+    sax_reader->setProperty(XMLUni::fgXercesSchemaExternalNoNameSpaceSchemaLocation, const_cast<XMLCh*>(kEmptyString));
+    sax_reader->setFeature(XMLUni::fgXercesDisableDefaultEntityResolution, true); // Disable DTD processing in order to prevent XXE attacks (c.f. https://owasp.org/www-community/vulnerabilities/XML_External_Entity_(XXE)_Processing).
+
+    const MemBufInputSource czi_xml_metadata(reinterpret_cast<const XMLByte*>(xml.c_str()), xml.size(), "dummy", false);
+    sax_reader->parse(czi_xml_metadata);
+}
+
+void CCheckXmlMetadataXsdValidation::ReportGrammarStatistics(const ZenCompleteXsdGrammarPoolInfo& grammar_pool_info)
+{
+    IResultGatherer::StatisticsTable table(CCheckXmlMetadataXsdValidation::kCheckType);
+    table.name = "schema grammar";
+    table.columns = { "source", "creation time (ms)" };
+    table.rows.push_back(
+        {
+            string(grammar_pool_info.fromSerializedGrammar ? "serialized at build time" : "parsed from XSD-schema"),
+            chrono::duration<double, milli>(grammar_pool_info.creationTime).count()
+        });
+    this->result_gatherer_.ReportStatistics(table);
+}
+
 std::string CCheckXmlMetadataXsdValidation::GetCziMetadataXml()
 {
     const auto czi_metadata = this->GetCziMetadataAndReportErrors(CCheckXmlMetadataXsdValidation::kCheckType);
@@ -11,6 +11,7 @@
 #include <string>
 
 #include "checkerbase.h"
+#include "checkerXmlMetadataXsdSchema.h"
 
 /// This checker is validating the XML-metadata against the XSD-schema.
 class CCheckXmlMetadataXsdValidation : public IChecker, CCheckerBase
@@ -29,6 +30,11 @@ protected:
     friend class ParserErrorHandler;
 private:
     std::string GetCziMetadataXml();
+
+    /// Validates the specified XML against the schema (reporting the findings).
+    void ValidateXml(const std::string& xml);
+
+    void ReportGrammarStatistics(const ZenCompleteXsdGrammarPoolInfo& grammar_pool_info);
 };
 
 #endif
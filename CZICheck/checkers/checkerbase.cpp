@@ -3,7 +3,10 @@
 // SPDX-License-Identifier: MIT
 
 #include "checkerbase.h"
+#include <exception>
+#include <iomanip>
 #include <memory>
+#include <sstream>
 
 using namespace std;
 using namespace libCZI;
@@ -60,6 +63,44 @@ std::shared_ptr<libCZI::ICziMetadata> CCheckerBase::GetCziMetadataAndReportError
     return nullptr;
 }
 
+std::shared_ptr<const CMetadataIndex> CCheckerBase::GetMetadataIndexAndReportErrors(CZIChecks check)
+{
+    const auto metadata_index = this->additional_info_.metadataIndexCache ?
+        this->additional_info_.metadataIndexCache->Get(this->reader_) :
+        CMetadataIndex::Create(this->reader_, this->additional_info_.memoryGovernor);
+
+    IResultGatherer::Finding finding(check);
+    switch (metadata_index->GetStatus())
+    {
+    case CMetadataIndex::Status::Ok:
+        return metadata_index;
+    case CMetadataIndex::Status::NoMetadataSegment:
+        return nullptr;
+    case CMetadataIndex::Status::CouldNotReadSegment:
+        finding.severity = IResultGatherer::Severity::Warning;
+        finding.information = "Could not read metadata-segment";
+        finding.details = metadata_index->GetErrorDetails();
+        break;
+    case CMetadataIndex::Status::InvalidSegment:
+        finding.severity = IResultGatherer::Severity::Fatal;
+        finding.information = "Invalid metadata-segment";
+        finding.details = metadata_index->GetErrorDetails();
+        break;
+    case CMetadataIndex::Status::NotWellFormed:
+        finding.severity = IResultGatherer::Severity::Fatal;
+        finding.information = "The metadata is not well-formed XML";
+        break;
+    case CMetadataIndex::Status::ExceedsMemoryBudget:
+        finding.severity = IResultGatherer::Severity::Warning;
+        finding.information = "The XML-metadata was not checked because the memory required exceeds the memory budget";
+        finding.details = metadata_index->GetErrorDetails();
+        break;
+    }
+
+    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+    return nullptr;
+}
+
 void CCheckerBase::ThrowIfFindingResultIsStop(IResultGatherer::ReportFindingResult result) const
 {
     if (result == IResultGatherer::ReportFindingResult::Stop)
@@ -68,3 +109,118 @@ void CCheckerBase::ThrowIfFindingResultIsStop(IResultGatherer::ReportFindingResu
     }
 }
 
+void CCheckerBase::AddSubBlockToManifest(CZIChecks check, int index, const libCZI::DirectorySubBlockInfo& info, std::uint64_t data_size, std::uint64_t hash)
+{
+    CSubBlockManifest::Entry entry;
+    entry.index = index;
+    entry.filePosition = info.filePosition;
+    entry.dataSize = data_size;
+    entry.hash = hash;
+    CSubBlockManifest::Entry reference_entry;
+    switch (this->additional_info_.manifest->AddEntry(entry, &reference_entry))
+    {
+    case CSubBlockManifest::VerifyResult::Mismatch:
+    {
+        IResultGatherer::Finding finding(check);
+        finding.severity = IResultGatherer::Severity::Fatal;
+        stringstream ss;
+        ss << "The content of subblock #" << index << " differs from the manifest";
+        finding.information = ss.str();
+        stringstream ss_details;
+        ss_details << "hash: 0x" << hex << setw(16) << setfill('0') << hash << ", expected: 0x" << setw(16) << reference_entry.hash
+            << dec << " (size of data: " << data_size << " bytes, expected: " << reference_entry.dataSize << " bytes)";
+        finding.details = ss_details.str();
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        break;
+    }
+    case CSubBlockManifest::VerifyResult::NotInReference:
+    {
+        IResultGatherer::Finding finding(check);
+        finding.severity = IResultGatherer::Severity::Warning;
+        stringstream ss;
+        ss << "Subblock #" << index << " is not contained in the manifest";
+        finding.information = ss.str();
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void CCheckerBase::ReportManifestSubBlocksNotInFile(CZIChecks check)
+{
+    if (!this->additional_info_.manifest || !this->additional_info_.manifest->HasReference() ||
+        !this->additional_info_.manifest->TryClaimReportOfEntriesNotInFile())
+    {
+        return;
+    }
+
+    const auto entries_not_in_file = this->additional_info_.manifest->GetReferenceEntriesNotInFile(this->reader_->GetStatistics().subBlockCount);
+    if (!entries_not_in_file.empty())
+    {
+        IResultGatherer::Finding finding(check);
+        finding.severity = IResultGatherer::Severity::Fatal;
+        stringstream ss;
+        ss << entries_not_in_file.size() << " subblock(s) contained in the manifest are not present in the file";
+        finding.information = ss.str();
+        stringstream ss_details;
+        ss_details << "subblocks: ";
+        constexpr size_t kMaxNumberOfSubBlocksInDetails = 20;
+        for (size_t i = 0; i < entries_not_in_file.size() && i < kMaxNumberOfSubBlocksInDetails; ++i)
+        {
+            ss_details << (i > 0 ? ", #" : "#") << entries_not_in_file[i].index;
+        }
+
+        if (entries_not_in_file.size() > kMaxNumberOfSubBlocksInDetails)
+        {
+            ss_details << ", ... (" << entries_not_in_file.size() - kMaxNumberOfSubBlocksInDetails << " more)";
+        }
+
+        finding.details = ss_details.str();
+        this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+    }
+}
+
+bool CCheckerBase::ReserveMemoryForSubBlock(CZIChecks check, int index, const libCZI::SubBlockInfo& info, CMemoryGovernor::Reservation& reservation)
+{
+    if (!this->additional_info_.memoryGovernor)
+    {
+        return true;
+    }
+
+    const uint64_t size = CCheckerBase::EstimateMemoryForDecoding(info);
+    if (this->additional_info_.memoryGovernor->Reserve(CZIChecksToString(check), size, reservation))
+    {
+        return true;
+    }
+
+    IResultGatherer::Finding finding(check);
+    finding.severity = IResultGatherer::Severity::Warning;
+    stringstream ss;
+    ss << "Subblock #" << index << " was not checked because the memory required exceeds the memory budget";
+    finding.information = ss.str();
+    stringstream ss_details;
+    ss_details << "memory required (estimated): " << CMemoryGovernor::FormatSize(size)
+        << ", memory budget: " << CMemoryGovernor::FormatSize(this->additional_info_.memoryGovernor->GetBudget());
+    finding.details = ss_details.str();
+    this->ThrowIfFindingResultIsStop(this->result_gatherer_.ReportFinding(finding));
+    return false;
+}
+
+/*static*/std::uint64_t CCheckerBase::EstimateMemoryForDecoding(const libCZI::SubBlockInfo& info)
+{
+    uint8_t bytes_per_pixel;
+    try
+    {
+        bytes_per_pixel = Utils::GetBytesPerPixel(info.pixelType);
+    }
+    catch (exception&)
+    {
+        // for an invalid pixel type, we assume the largest pixel type (Bgr192ComplexFloat)
+        bytes_per_pixel = 24;
+    }
+
+    const uint64_t bitmap_size = static_cast<uint64_t>(info.physicalSize.w) * info.physicalSize.h * bytes_per_pixel;
+    return info.GetCompressionMode() == CompressionMode::UnCompressed ? bitmap_size : 2 * bitmap_size;
+}
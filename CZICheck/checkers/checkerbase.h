@@ -39,6 +39,15 @@ protected:
     /// \returns    If successful, the libCZI-metadata-object; nullptr otherwise.
     std::shared_ptr<libCZI::ICziMetadata> GetCziMetadataAndReportErrors(CZIChecks check);
 
+    /// Try to get the index over the XML-metadata (which is shared between all checkers, if a cache is given
+    /// with the additional info). If there is any problem with this (e.g. invalid XML or so), then the error is
+    /// reported (in the same way as with "GetCziMetadataAndReportErrors") and a nullptr is returned.
+    ///
+    /// \param  check   The checker-identifier (used for reporting errors).
+    ///
+    /// \returns    If successful, the index over the XML-metadata; nullptr otherwise.
+    std::shared_ptr<const CMetadataIndex> GetMetadataIndexAndReportErrors(CZIChecks check);
+
     /// Throws a CheckerException if the finding result indicates to stop processing.
     /// This method checks if the result_gatherer has requested to stop further processing
     /// and throws an exception accordingly. This is typically used after reporting findings
@@ -49,6 +58,45 @@ protected:
     /// \throws CheckerException with reason StopFurtherProcessing if result is Stop.
     void ThrowIfFindingResultIsStop(IResultGatherer::ReportFindingResult result) const;
 
+    /// Adds the hash of a subblock's data to the manifest (given with the additional info), and reports a finding
+    /// if it does not match the reference manifest. This method must only be called if a manifest is present.
+    /// If the subblock has already been added by another checker, nothing is reported (again).
+    ///
+    /// \param  check       The checker-identifier (used for reporting findings).
+    /// \param  index       The index of the subblock.
+    /// \param  info        Information about the subblock.
+    /// \param  data_size   The size of the subblock's data in bytes.
+    /// \param  hash        The hash of the subblock's data.
+    void AddSubBlockToManifest(CZIChecks check, int index, const libCZI::DirectorySubBlockInfo& info, std::uint64_t data_size, std::uint64_t hash);
+
+    /// Reports a finding if the reference manifest contains subblocks which are not present in the file. This
+    /// method does nothing if there is no manifest or no reference manifest, or if this has already been reported
+    /// by another checker.
+    ///
+    /// \param  check   The checker-identifier (used for reporting findings).
+    void ReportManifestSubBlocksNotInFile(CZIChecks check);
+
+    /// Reserves the memory required for reading and decoding the specified subblock with the memory governor
+    /// (given with the additional info). If this is not possible because the memory required exceeds the budget,
+    /// a finding is reported (so that it is clear that the subblock has not been checked). If other consumers
+    /// (running in other threads) currently hold memory, this method waits for them to return it.
+    ///
+    /// \param          check       The checker-identifier (used for reporting findings and as name of the consumer).
+    /// \param          index       The index of the subblock.
+    /// \param          info        Information about the subblock.
+    /// \param [out]    reservation The reservation is put here.
+    ///
+    /// \returns    True if the memory could be reserved (or if there is no memory governor); false if the subblock is to be skipped.
+    bool ReserveMemoryForSubBlock(CZIChecks check, int index, const libCZI::SubBlockInfo& info, CMemoryGovernor::Reservation& reservation);
+
+    /// Estimates the amount of memory required for reading and decoding the specified subblock, i.e. the size of the
+    /// decoded bitmap, and (for a compressed subblock) the compressed data, which is assumed to be not larger than the bitmap.
+    ///
+    /// \param  info    Information about the subblock.
+    ///
+    /// \returns    The estimated amount of memory in bytes.
+    static std::uint64_t EstimateMemoryForDecoding(const libCZI::SubBlockInfo& info);
+
     /// Executes a callable and handles CheckerException.
     /// This template accepts any callable (lambda, function pointer, functor)
     /// and provides default exception handling for CheckerException.
@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "decodestatistics.h"
+#include <cmath>
+#include <sstream>
+
+using namespace libCZI;
+using namespace std;
+
+void CDurationHistogram::Add(std::chrono::nanoseconds duration)
+{
+    const auto microseconds = chrono::duration_cast<chrono::microseconds>(duration).count();
+    ++this->buckets_[CDurationHistogram::GetBucketIndex(microseconds > 0 ? static_cast<uint64_t>(microseconds) : 0)];
+    ++this->count_;
+}
+
+double CDurationHistogram::GetPercentileInMilliseconds(double percentile) const
+{
+    if (this->count_ == 0)
+    {
+        return 0;
+    }
+
+    const auto rank = static_cast<uint64_t>(ceil(percentile * static_cast<double>(this->count_)));
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < kBucketCount; ++i)
+    {
+        accumulated += this->buckets_[i];
+        if (accumulated >= rank && accumulated > 0)
+        {
+            return static_cast<double>(CDurationHistogram::GetBucketUpperBound(i)) / 1000.0;
+        }
+    }
+
+    return static_cast<double>(CDurationHistogram::GetBucketUpperBound(kBucketCount - 1)) / 1000.0;
+}
+
+/*static*/std::size_t CDurationHistogram::GetBucketIndex(std::uint64_t microseconds)
+{
+    // values 0 to 3 get a bucket of their own, for larger values we use four buckets per power of two
+    //  (determined by the two bits following the most significant bit)
+    if (microseconds < 4)
+    {
+        return static_cast<size_t>(microseconds);
+    }
+
+    int most_significant_bit = 63;
+    while ((microseconds & (static_cast<uint64_t>(1) << most_significant_bit)) == 0)
+    {
+        --most_significant_bit;
+    }
+
+    const auto sub_bucket = static_cast<size_t>((microseconds >> (most_significant_bit - 2)) & 3);
+    const size_t index = 4 + static_cast<size_t>(most_significant_bit - 2) * 4 + sub_bucket;
+    return index < kBucketCount ? index : kBucketCount - 1;
+}
+
+/*static*/std::uint64_t CDurationHistogram::GetBucketUpperBound(std::size_t bucket_index)
+{
+    if (bucket_index < 4)
+    {
+        return bucket_index;
+    }
+
+    const auto most_significant_bit = static_cast<int>((bucket_index - 4) / 4) + 2;
+    const auto sub_bucket = static_cast<uint64_t>((bucket_index - 4) % 4);
+    return ((4 + sub_bucket + 1) << (most_significant_bit - 2)) - 1;
+}
+
+void CDecodeStatistics::AddTile(const libCZI::SubBlockInfo& info, std::uint64_t compressed_size, std::uint64_t decoded_size, std::chrono::nanoseconds read_time, std::chrono::nanoseconds decode_time)
+{
+    auto& item = this->GetItem(info);
+    ++item.tiles;
+    item.compressedBytes += static_cast<int64_t>(compressed_size);
+    item.decodedBytes += static_cast<int64_t>(decoded_size);
+    item.readTime += read_time;
+    item.decodeTime += decode_time;
+    if (decoded_size > 0)
+    {
+        item.decodeTimeHistogram.Add(decode_time);
+    }
+}
+
+void CDecodeStatistics::AddError(const libCZI::SubBlockInfo& info)
+{
+    auto& item = this->GetItem(info);
+    ++item.tiles;
+    ++item.errors;
+}
+
+IResultGathererReport::StatisticsTable CDecodeStatistics::CreateStatisticsTable(CZIChecks check, const std::string& name) const
+{
+    IResultGathererReport::StatisticsTable table(check);
+    table.name = name;
+    table.columns = {
+        "compression",
+        "tiles",
+        "compressed bytes",
+        "decoded bytes",
+        "read time [ms]",
+        "decode time [ms]",
+        "mean decode time [ms]",
+        "p99 decode time [ms]",
+        "errors" };
+
+    for (const auto& item : this->items_)
+    {
+        const auto& statistics = item.second;
+        const double decode_time_in_milliseconds = chrono::duration<double, milli>(statistics.decodeTime).count();
+        const auto decoded_tiles = statistics.decodeTimeHistogram.GetCount();
+        table.rows.push_back({
+            statistics.compressionModeText,
+            statistics.tiles,
+            statistics.compressedBytes,
+            statistics.decodedBytes,
+            chrono::duration<double, milli>(statistics.readTime).count(),
+            decode_time_in_milliseconds,
+            decoded_tiles > 0 ? decode_time_in_milliseconds / static_cast<double>(decoded_tiles) : 0.0,
+            statistics.decodeTimeHistogram.GetPercentileInMilliseconds(0.99),
+            statistics.errors });
+    }
+
+    return table;
+}
+
+CDecodeStatistics::Item& CDecodeStatistics::GetItem(const libCZI::SubBlockInfo& info)
+{
+    auto& item = this->items_[info.compressionModeRaw];
+    if (item.compressionModeText.empty())
+    {
+        const auto compression_mode = info.GetCompressionMode();
+        if (compression_mode != CompressionMode::Invalid)
+        {
+            item.compressionModeText = Utils::CompressionModeToInformalString(compression_mode);
+        }
+        else
+        {
+            stringstream ss;
+            ss << "non-standard (" << info.compressionModeRaw << ")";
+            item.compressionModeText = ss.str();
+        }
+    }
+
+    return item;
+}
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "../inc_libCZI.h"
+#include "../IResultGatherer.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+/// A histogram of durations with logarithmically spaced buckets (four buckets per power of two, with
+/// microsecond resolution). It uses a fixed amount of memory (independent of the number of samples), and allows
+/// for determining percentiles with a relative error of less than 25%.
+class CDurationHistogram
+{
+private:
+    static constexpr std::size_t kBucketCount = 256;
+    std::array<std::uint64_t, kBucketCount> buckets_{};
+    std::uint64_t count_{ 0 };
+public:
+    /// Adds a sample to the histogram.
+    ///
+    /// \param  duration    The duration to add.
+    void Add(std::chrono::nanoseconds duration);
+
+    /// Gets the number of samples added to the histogram.
+    [[nodiscard]] std::uint64_t GetCount() const { return this->count_; }
+
+    /// Gets the specified percentile of the durations in milliseconds. The value reported is the upper bound
+    /// of the bucket which contains the percentile.
+    ///
+    /// \param  percentile  The percentile (in the range 0 to 1).
+    ///
+    /// \returns    The percentile in milliseconds; 0 if there are no samples.
+    [[nodiscard]] double GetPercentileInMilliseconds(double percentile) const;
+private:
+    static std::size_t GetBucketIndex(std::uint64_t microseconds);
+    static std::uint64_t GetBucketUpperBound(std::size_t bucket_index);
+};
+
+/// This class is used for gathering statistics about reading and decoding subblocks, separately for
+/// each compression mode.
+class CDecodeStatistics
+{
+private:
+    struct Item
+    {
+        std::string compressionModeText;
+        std::int64_t tiles{ 0 };
+        std::int64_t compressedBytes{ 0 };
+        std::int64_t decodedBytes{ 0 };
+        std::int64_t errors{ 0 };
+        std::chrono::nanoseconds readTime{ 0 };
+        std::chrono::nanoseconds decodeTime{ 0 };
+        CDurationHistogram decodeTimeHistogram;
+    };
+
+    std::map<int, Item> items_;   ///< The statistics, the key is the raw compression mode.
+public:
+    /// Adds information about a subblock which was read (and decoded) successfully. Only subblocks with a decoded size
+    /// greater than zero are taken into account for the decode time percentiles.
+    ///
+    /// \param  info                The subblock-info.
+    /// \param  compressed_size     The size of the (compressed) data of the subblock in bytes.
+    /// \param  decoded_size        The size of the decoded bitmap in bytes (0 if the subblock was not decoded).
+    /// \param  read_time           The time it took to read the subblock.
+    /// \param  decode_time         The time it took to decode the subblock.
+    void AddTile(const libCZI::SubBlockInfo& info, std::uint64_t compressed_size, std::uint64_t decoded_size, std::chrono::nanoseconds read_time, std::chrono::nanoseconds decode_time);
+
+    /// Adds information about a subblock which could not be read or decoded.
+    ///
+    /// \param  info    The subblock-info.
+    void AddError(const libCZI::SubBlockInfo& info);
+
+    /// Creates a statistics table (with one row for each compression mode encountered) from the gathered information.
+    ///
+    /// \param  check   The checker-identifier (which reports the statistics).
+    /// \param  name    The caption of the table.
+    ///
+    /// \returns    The statistics table.
+    [[nodiscard]] IResultGathererReport::StatisticsTable CreateStatisticsTable(CZIChecks check, const std::string& name) const;
+private:
+    Item& GetItem(const libCZI::SubBlockInfo& info);
+};
@@ -0,0 +1,303 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <CZICheck_Config.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// The exception thrown by CExternalSorter if a temporary file cannot be created, written or read.
+class ExternalSorterException : public std::runtime_error
+{
+public:
+    explicit ExternalSorterException(const std::string& message) : std::runtime_error(message) {}
+};
+
+/// This class sorts a sequence of items with a bounded amount of memory. Items are added to an in-memory buffer,
+/// and if the buffer is full, it is sorted and written to a temporary file (a "run"). When enumerating the items,
+/// the remaining items in the buffer are written as a run as well, the buffer is freed, and the runs are merged
+/// (with a k-way merge) - so that the read buffers of the runs do not add to the memory of the buffer. If all items
+/// fit into the buffer, no temporary files are used at all. The items must be trivially copyable, since they are written to
+/// the temporary files as they are. The temporary files are created in the directory given with the constructor (or in
+/// the system's directory for temporary files, which is e.g. given by the environment variable TMPDIR), and they are
+/// removed when they are closed.
+///
+/// \tparam T       The type of the items.
+/// \tparam TLess   The comparison functor (giving a strict weak ordering).
+template <typename T, typename TLess = std::less<T>>
+class CExternalSorter
+{
+    static_assert(std::is_trivially_copyable<T>::value, "the items must be trivially copyable");
+private:
+    /// Closes a temporary file, and removes it (if a path is given).
+    struct TemporaryFileDeleter
+    {
+        std::filesystem::path path;
+
+        void operator()(std::FILE* file) const
+        {
+            std::fclose(file);
+            if (!this->path.empty())
+            {
+                std::error_code error_code;
+                std::filesystem::remove(this->path, error_code);
+            }
+        }
+    };
+
+    /// A run which was written to a temporary file, and the state for reading it back.
+    struct Run
+    {
+        std::unique_ptr<std::FILE, TemporaryFileDeleter> file;
+        std::size_t count{ 0 };             ///< The number of items in the run.
+        std::size_t read{ 0 };              ///< The number of items read from the file so far.
+        std::vector<T> buffer;              ///< Buffer for reading the items.
+        std::size_t buffer_size{ 0 };       ///< The number of items read at once.
+        std::size_t position{ 0 };          ///< The position of the current item in the buffer.
+    };
+
+    /// The maximum number of runs (i.e. temporary files) - if reached, the runs are merged into one.
+    static constexpr std::size_t kMaxNumberOfRuns = 64;
+
+    /// The number of attempts for creating a temporary file with a unique name.
+    static constexpr int kMaxNumberOfAttemptsForCreatingFile = 16;
+
+    std::size_t max_items_in_memory_;
+    std::filesystem::path temp_directory_;
+    TLess less_;
+    std::vector<T> buffer_;
+    std::vector<Run> runs_;
+public:
+    /// Constructor.
+    ///
+    /// \param  max_items_in_memory The maximum number of items kept in memory (must be at least 1). This also
+    ///                             bounds the memory used for merging the runs.
+    /// \param  temp_directory      The directory for the temporary files. If empty, the system's directory for
+    ///                             temporary files is used.
+    /// \param  less                The comparison functor.
+    explicit CExternalSorter(std::size_t max_items_in_memory, std::filesystem::path temp_directory = std::filesystem::path(), TLess less = TLess())
+        : max_items_in_memory_(std::max<std::size_t>(max_items_in_memory, 1)), temp_directory_(std::move(temp_directory)), less_(std::move(less))
+    {
+    }
+
+    /// Adds an item.
+    ///
+    /// \param  item    The item to add.
+    void Add(const T& item)
+    {
+        if (this->buffer_.size() >= this->max_items_in_memory_)
+        {
+            this->SpillRun();
+        }
+
+        // the buffer is grown explicitly, so that its capacity does not exceed the maximum number of items
+        if (this->buffer_.size() == this->buffer_.capacity())
+        {
+            this->buffer_.reserve(std::min(std::max<std::size_t>(2 * this->buffer_.capacity(), 16), this->max_items_in_memory_));
+        }
+
+        this->buffer_.push_back(item);
+    }
+
+    /// Gets the number of runs currently stored in temporary files.
+    [[nodiscard]] std::size_t GetNumberOfSpilledRuns() const { return this->runs_.size(); }
+
+    /// Enumerates all items added in sorted order. This method can only be called once (after all items have
+    /// been added).
+    ///
+    /// \param  func    Functor which is called for each item. If it returns false, the enumeration is cancelled.
+    void Enumerate(const std::function<bool(const T&)>& func)
+    {
+        if (this->runs_.empty())
+        {
+            std::sort(this->buffer_.begin(), this->buffer_.end(), this->less_);
+            for (const auto& item : this->buffer_)
+            {
+                if (!func(item))
+                {
+                    break;
+                }
+            }
+
+            return;
+        }
+
+        if (!this->buffer_.empty())
+        {
+            this->SpillRun();
+        }
+
+        this->Merge(this->runs_, func);
+    }
+private:
+    void SpillRun()
+    {
+        std::sort(this->buffer_.begin(), this->buffer_.end(), this->less_);
+        Run run = this->CreateRun();
+        Write(run, this->buffer_.data(), this->buffer_.size());
+        this->runs_.emplace_back(std::move(run));
+
+        // the memory of the buffer is freed (and not only cleared), since merging the runs uses the whole budget
+        std::vector<T>().swap(this->buffer_);
+
+        // in order to limit the number of open temporary files, the runs are merged into one when there are too many
+        if (this->runs_.size() >= kMaxNumberOfRuns)
+        {
+            Run merged_run = this->CreateRun();
+            this->Merge(
+                this->runs_,
+                [&](const T& item)->bool
+                {
+                    Write(merged_run, &item, 1);
+                    return true;
+                });
+            this->runs_.clear();
+            this->runs_.emplace_back(std::move(merged_run));
+        }
+    }
+
+    Run CreateRun() const
+    {
+        std::filesystem::path directory = this->temp_directory_;
+        if (directory.empty())
+        {
+            std::error_code error_code;
+            directory = std::filesystem::temp_directory_path(error_code);
+            if (error_code)
+            {
+                throw ExternalSorterException("could not determine the directory for temporary files: " + error_code.message());
+            }
+        }
+
+        // the file is created with a random name - in exclusive mode, so that an existing file is never used
+        std::random_device random_device;
+        for (int attempt = 1; ; ++attempt)
+        {
+            std::ostringstream file_name;
+            file_name << "czicheck-" << std::hex << std::setfill('0') << std::setw(8) << random_device() << std::setw(8) << random_device() << ".tmp";
+            const std::filesystem::path path = directory / file_name.str();
+#if CZICHECK_WIN32_ENVIRONMENT
+            std::FILE* file = _wfopen(path.c_str(), L"w+bx");
+#else
+            std::FILE* file = std::fopen(path.c_str(), "w+bx");
+#endif
+            if (file != nullptr)
+            {
+                Run run;
+#if CZICHECK_WIN32_ENVIRONMENT
+                run.file = std::unique_ptr<std::FILE, TemporaryFileDeleter>(file, TemporaryFileDeleter{ path });
+#else
+                // on POSIX-systems, the file can be removed while it is open - so it is gone even if we do not get to close it
+                run.file = std::unique_ptr<std::FILE, TemporaryFileDeleter>(file, TemporaryFileDeleter{});
+                std::error_code error_code;
+                std::filesystem::remove(path, error_code);
+#endif
+                return run;
+            }
+
+            const int error_number = errno;
+            if (error_number != EEXIST || attempt >= kMaxNumberOfAttemptsForCreatingFile)
+            {
+                throw ExternalSorterException("could not create a temporary file in \"" + directory.u8string() + "\": " + std::error_code(error_number, std::generic_category()).message());
+            }
+        }
+    }
+
+    static void Write(Run& run, const T* items, std::size_t count)
+    {
+        if (std::fwrite(items, sizeof(T), count, run.file.get()) != count)
+        {
+            throw ExternalSorterException("could not write to a temporary file");
+        }
+
+        run.count += count;
+    }
+
+    /// Merges the specified runs, and passes the items in sorted order to the specified functor.
+    void Merge(std::vector<Run>& runs, const std::function<bool(const T&)>& func)
+    {
+        // the memory available for merging is split between the runs
+        const std::size_t read_buffer_size = std::max<std::size_t>(this->max_items_in_memory_ / runs.size(), 1);
+        for (auto& run : runs)
+        {
+            std::rewind(run.file.get());
+            run.read = 0;
+            run.buffer_size = std::min(read_buffer_size, run.count);
+            run.buffer.reserve(run.buffer_size);
+            FillBuffer(run);
+        }
+
+        // the priority queue holds the current item of every run (the source is given as index into "runs"), for
+        //  equal items the order of the sources is kept
+        using QueueItem = std::pair<T, std::size_t>;
+        const auto greater = [this](const QueueItem& a, const QueueItem& b)->bool
+            {
+                if (this->less_(b.first, a.first))
+                {
+                    return true;
+                }
+
+                return !this->less_(a.first, b.first) && a.second > b.second;
+            };
+        std::priority_queue<QueueItem, std::vector<QueueItem>, decltype(greater)> queue(greater);
+        for (std::size_t i = 0; i < runs.size(); ++i)
+        {
+            if (!runs[i].buffer.empty())
+            {
+                queue.emplace(runs[i].buffer[0], i);
+            }
+        }
+
+        while (!queue.empty())
+        {
+            const QueueItem current = queue.top();
+            queue.pop();
+            if (!func(current.first))
+            {
+                break;
+            }
+
+            auto& run = runs[current.second];
+            if (++run.position >= run.buffer.size())
+            {
+                FillBuffer(run);
+            }
+
+            if (run.position < run.buffer.size())
+            {
+                queue.emplace(run.buffer[run.position], current.second);
+            }
+        }
+    }
+
+    static void FillBuffer(Run& run)
+    {
+        const std::size_t to_read = std::min(run.buffer_size, run.count - run.read);
+        run.buffer.resize(to_read);
+        if (to_read > 0 && std::fread(run.buffer.data(), sizeof(T), to_read, run.file.get()) != to_read)
+        {
+            throw ExternalSorterException("could not read from a temporary file");
+        }
+
+        run.read += to_read;
+        run.position = 0;
+    }
+};
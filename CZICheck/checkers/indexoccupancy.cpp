@@ -0,0 +1,214 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "indexoccupancy.h"
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+
+using namespace std;
+
+CIndexOccupancy::CIndexOccupancy(int origin)
+    : origin_(origin)
+{
+}
+
+bool CIndexOccupancy::Add(int index)
+{
+    if (this->count_ == 0)
+    {
+        this->minimum_ = this->maximum_ = index;
+    }
+    else
+    {
+        this->minimum_ = min(this->minimum_, index);
+        this->maximum_ = max(this->maximum_, index);
+    }
+
+    ++this->count_;
+
+    // the bitfield is used as long as its size is in proportion to the number of distinct indices - otherwise we
+    //  switch to recording intervals
+    const int64_t offset = static_cast<int64_t>(index) - this->origin_;
+    if (!this->sparse_ && (offset < 0 || static_cast<uint64_t>(offset) / 64 > this->distinct_count_))
+    {
+        this->SwitchToSparse();
+    }
+
+    bool is_new;
+    if (this->sparse_)
+    {
+        is_new = this->AddToIntervals(index);
+    }
+    else
+    {
+        const size_t word_index = static_cast<size_t>(offset) / 64;
+        if (word_index >= this->bits_.size())
+        {
+            this->bits_.resize(word_index + 1, 0);
+        }
+
+        const uint64_t mask = uint64_t{ 1 } << (offset % 64);
+        is_new = (this->bits_[word_index] & mask) == 0;
+        this->bits_[word_index] |= mask;
+    }
+
+    if (is_new)
+    {
+        ++this->distinct_count_;
+    }
+
+    return is_new;
+}
+
+std::vector<std::pair<int, int>> CIndexOccupancy::GetRanges() const
+{
+    vector<pair<int, int>> ranges;
+    if (this->sparse_)
+    {
+        ranges.assign(this->intervals_.cbegin(), this->intervals_.cend());
+        return ranges;
+    }
+
+    // scan the bitfield word by word - words with all bits set (within a range) or with no bit set (outside of a
+    //  range) are skipped at once
+    int64_t range_start = -1;
+    for (size_t word_index = 0; word_index < this->bits_.size(); ++word_index)
+    {
+        const uint64_t word = this->bits_[word_index];
+        if ((word == ~uint64_t{ 0 } && range_start >= 0) || (word == 0 && range_start < 0))
+        {
+            continue;
+        }
+
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            const int64_t offset = static_cast<int64_t>(word_index) * 64 + bit;
+            const bool is_set = (word & (uint64_t{ 1 } << bit)) != 0;
+            if (is_set && range_start < 0)
+            {
+                range_start = offset;
+            }
+            else if (!is_set && range_start >= 0)
+            {
+                ranges.emplace_back(static_cast<int>(this->origin_ + range_start), static_cast<int>(this->origin_ + offset - 1));
+                range_start = -1;
+            }
+        }
+    }
+
+    if (range_start >= 0)
+    {
+        ranges.emplace_back(static_cast<int>(this->origin_ + range_start), static_cast<int>(this->origin_ + static_cast<int64_t>(this->bits_.size()) * 64 - 1));
+    }
+
+    return ranges;
+}
+
+std::vector<std::pair<int, int>> CIndexOccupancy::GetMissingRanges(int first, int last) const
+{
+    vector<pair<int, int>> missing_ranges;
+    int64_t next_expected = first;
+    for (const auto& range : this->GetRanges())
+    {
+        if (range.second < next_expected)
+        {
+            continue;
+        }
+
+        if (range.first > last)
+        {
+            break;
+        }
+
+        if (range.first > next_expected)
+        {
+            missing_ranges.emplace_back(static_cast<int>(next_expected), range.first - 1);
+        }
+
+        next_expected = static_cast<int64_t>(range.second) + 1;
+    }
+
+    if (next_expected <= last)
+    {
+        missing_ranges.emplace_back(static_cast<int>(next_expected), last);
+    }
+
+    return missing_ranges;
+}
+
+/*static*/std::string CIndexOccupancy::FormatRanges(const std::vector<std::pair<int, int>>& ranges, std::size_t max_number_of_ranges)
+{
+    stringstream ss;
+    for (size_t i = 0; i < ranges.size() && i < max_number_of_ranges; ++i)
+    {
+        if (i > 0)
+        {
+            ss << ", ";
+        }
+
+        ss << ranges[i].first;
+        if (ranges[i].second != ranges[i].first)
+        {
+            ss << "-" << ranges[i].second;
+        }
+    }
+
+    if (ranges.size() > max_number_of_ranges)
+    {
+        ss << ", ... (" << ranges.size() - max_number_of_ranges << " more ranges)";
+    }
+
+    return ss.str();
+}
+
+bool CIndexOccupancy::AddToIntervals(int index)
+{
+    // find the interval starting after the index, and check whether the index is contained in or adjacent to
+    //  the preceding one (or adjacent to the following one)
+    auto next = this->intervals_.upper_bound(index);
+    if (next != this->intervals_.begin())
+    {
+        const auto previous = std::prev(next);
+        if (previous->second >= index)
+        {
+            return false;
+        }
+
+        if (static_cast<int64_t>(previous->second) + 1 == index)
+        {
+            previous->second = index;
+            if (next != this->intervals_.end() && static_cast<int64_t>(next->first) - 1 == index)
+            {
+                previous->second = next->second;
+                this->intervals_.erase(next);
+            }
+
+            return true;
+        }
+    }
+
+    if (next != this->intervals_.end() && static_cast<int64_t>(next->first) - 1 == index)
+    {
+        const int last = next->second;
+        next = this->intervals_.erase(next);
+        this->intervals_.emplace_hint(next, index, last);
+        return true;
+    }
+
+    this->intervals_.emplace_hint(next, index, index);
+    return true;
+}
+
+void CIndexOccupancy::SwitchToSparse()
+{
+    for (const auto& range : this->GetRanges())
+    {
+        this->intervals_.emplace_hint(this->intervals_.end(), range.first, range.second);
+    }
+
+    this->bits_.clear();
+    this->bits_.shrink_to_fit();
+    this->sparse_ = true;
+}
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// This class records which indices (e.g. plane indices or M-indices) are in use. As long as the indices are dense,
+/// they are recorded in a bitfield (packed into 64-bit words, with one bit per index starting at the "origin").
+/// If the bitfield would become large in proportion to the number of distinct indices (or an index is below the
+/// origin), the indices are recorded as a sorted set of disjoint intervals instead ("sparse" mode). So, the memory
+/// usage is proportional to the number of distinct indices (and in sparse mode, to the number of intervals) - and
+/// not to the number of indices added.
+class CIndexOccupancy
+{
+private:
+    int origin_{ 0 };
+    bool sparse_{ false };
+    std::uint64_t count_{ 0 };
+    std::uint64_t distinct_count_{ 0 };
+    int minimum_{ 0 };
+    int maximum_{ 0 };
+    std::vector<std::uint64_t> bits_;
+    std::map<int, int> intervals_;  ///< In sparse mode: the intervals of indices in use (first and last index, inclusive), not adjacent to each other.
+public:
+    CIndexOccupancy() = default;
+
+    /// Constructor.
+    ///
+    /// \param  origin  The first index of the bitfield (i.e. the index which is expected to be the smallest one).
+    explicit CIndexOccupancy(int origin);
+
+    /// Adds the specified index.
+    ///
+    /// \param  index   The index.
+    ///
+    /// \returns    True if the index was not in use before; false if it was already added.
+    bool Add(int index);
+
+    /// Gets the number of indices added (including indices added more than once).
+    [[nodiscard]] std::uint64_t GetCount() const { return this->count_; }
+
+    /// Gets the number of distinct indices added.
+    [[nodiscard]] std::uint64_t GetDistinctCount() const { return this->distinct_count_; }
+
+    /// Gets the smallest index added (only valid if at least one index was added).
+    [[nodiscard]] int GetMinimum() const { return this->minimum_; }
+
+    /// Gets the largest index added (only valid if at least one index was added).
+    [[nodiscard]] int GetMaximum() const { return this->maximum_; }
+
+    /// Gets the ranges of indices in use, as pairs of the first and the last index (inclusive), in ascending order.
+    [[nodiscard]] std::vector<std::pair<int, int>> GetRanges() const;
+
+    /// Gets the ranges of indices within the specified range which are not in use, as pairs of the first and the
+    /// last index (inclusive), in ascending order.
+    ///
+    /// \param  first   The first index of the range to examine.
+    /// \param  last    The last index of the range to examine (inclusive).
+    ///
+    /// \returns    The ranges of missing indices.
+    [[nodiscard]] std::vector<std::pair<int, int>> GetMissingRanges(int first, int last) const;
+
+    /// Formats the specified ranges for the details of a finding (e.g. "1-3, 7"). At most the specified number of
+    /// ranges is listed, and the number of ranges left out is given.
+    ///
+    /// \param  ranges              The ranges (pairs of the first and the last index, inclusive).
+    /// \param  max_number_of_ranges The maximum number of ranges to list.
+    ///
+    /// \returns    The ranges formatted as a string.
+    static std::string FormatRanges(const std::vector<std::pair<int, int>>& ranges, std::size_t max_number_of_ranges);
+private:
+    bool AddToIntervals(int index);
+    void SwitchToSparse();
+};
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "layer0planes.h"
+#include "../xxhash64.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+using namespace libCZI;
+using namespace std;
+
+CLayer0Planes::PlaneKey::PlaneKey(const libCZI::IDimCoordinate& coordinate)
+{
+    for (int i = static_cast<int>(DimensionIndex::MinDim); i <= static_cast<int>(DimensionIndex::MaxDim); ++i)
+    {
+        int value;
+        if (static_cast<DimensionIndex>(i) != DimensionIndex::S &&
+            coordinate.TryGetPosition(static_cast<DimensionIndex>(i), &value))
+        {
+            this->validDimensions |= 1u << i;
+            this->values[i - static_cast<int>(DimensionIndex::MinDim)] = value;
+        }
+    }
+}
+
+bool CLayer0Planes::PlaneKey::operator==(const PlaneKey& other) const
+{
+    return this->validDimensions == other.validDimensions && this->values == other.values;
+}
+
+bool CLayer0Planes::PlaneKey::IsBefore(const PlaneKey& other) const
+{
+    if (this->validDimensions != other.validDimensions)
+    {
+        return this->validDimensions < other.validDimensions;
+    }
+
+    for (int i = kNumberOfDimensions - 1; i >= 0; --i)
+    {
+        if (this->values[i] != other.values[i])
+        {
+            return this->values[i] < other.values[i];
+        }
+    }
+
+    return false;
+}
+
+libCZI::CDimCoordinate CLayer0Planes::PlaneKey::ToCoordinate() const
+{
+    CDimCoordinate coordinate;
+    for (int i = static_cast<int>(DimensionIndex::MinDim); i <= static_cast<int>(DimensionIndex::MaxDim); ++i)
+    {
+        if ((this->validDimensions & (1u << i)) != 0)
+        {
+            coordinate.Set(static_cast<DimensionIndex>(i), this->values[i - static_cast<int>(DimensionIndex::MinDim)]);
+        }
+    }
+
+    return coordinate;
+}
+
+size_t CLayer0Planes::PlaneKeyHash::operator()(const PlaneKey& key) const
+{
+    CXxHash64 hash;
+    hash.Update(&key.validDimensions, sizeof(key.validDimensions));
+    hash.Update(key.values.data(), key.values.size() * sizeof(int32_t));
+    return static_cast<size_t>(hash.GetDigest());
+}
+
+/*static*/std::vector<CLayer0Planes::Plane> CLayer0Planes::Gather(const std::shared_ptr<libCZI::ICZIReader>& reader, const SceneFilterFunction& scene_filter)
+{
+    vector<pair<PlaneKey, Plane>> planes;
+    unordered_map<PlaneKey, size_t, PlaneKeyHash> plane_index_for_key;
+
+    reader->EnumerateSubBlocks(
+        [&](int index, const SubBlockInfo& info)->bool
+        {
+            if (!CLayer0Planes::IsLayer0(info))
+            {
+                return true;
+            }
+
+            int scene_index;
+            if (!info.coordinate.TryGetPosition(DimensionIndex::S, &scene_index))
+            {
+                scene_index = CLayer0Planes::kNoSceneIndex;
+            }
+
+            if (scene_filter && !scene_filter(scene_index))
+            {
+                return true;
+            }
+
+            PlaneKey key(info.coordinate);
+            const auto it = plane_index_for_key.find(key);
+            size_t plane_index;
+            if (it == plane_index_for_key.end())
+            {
+                plane_index = planes.size();
+                plane_index_for_key.emplace(key, plane_index);
+                planes.emplace_back(key, Plane{ key.ToCoordinate(), {} });
+            }
+            else
+            {
+                plane_index = it->second;
+            }
+
+            planes[plane_index].second.subBlocksPerScene[scene_index].emplace_back(CRectangleOverlap::Rectangle{ index, info.logicalRect });
+            return true;
+        });
+
+    sort(planes.begin(), planes.end(), [](const pair<PlaneKey, Plane>& a, const pair<PlaneKey, Plane>& b)->bool {return a.first.IsBefore(b.first); });
+
+    vector<Plane> result;
+    result.reserve(planes.size());
+    for (auto& plane : planes)
+    {
+        result.emplace_back(std::move(plane.second));
+    }
+
+    return result;
+}
+
+/*static*/int CLayer0Planes::GetMinification(const libCZI::SubBlockInfo& info)
+{
+    if (info.physicalSize.w == 0)
+    {
+        return 1;
+    }
+
+    return max(1, static_cast<int>(lround(static_cast<double>(info.logicalRect.w) / info.physicalSize.w)));
+}
+
+/*static*/bool CLayer0Planes::IsLayer0(const libCZI::SubBlockInfo& info)
+{
+    return info.logicalRect.w == static_cast<int32_t>(info.physicalSize.w) && info.logicalRect.h == static_cast<int32_t>(info.physicalSize.h);
+}
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "../inc_libCZI.h"
+#include "rectangleoverlap.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
+
+/// This class groups the subblocks on pyramid-layer 0 by plane (i.e. their coordinate without the S-index) and
+/// by scene, with one pass over the subblock-directory. Only planes which actually contain subblocks are
+/// present in the result, so the cost is independent of the size of the "dimension bounds" of the document.
+class CLayer0Planes
+{
+public:
+    /// The scene index used for subblocks without an S-index.
+    static constexpr int kNoSceneIndex = (std::numeric_limits<int>::min)();
+
+    /// The layer-0 subblocks of a plane, grouped by scene. For each subblock, its index and its logical
+    /// rectangle are given (in the order of the subblock index).
+    struct Plane
+    {
+        libCZI::CDimCoordinate coordinate;  ///< The plane coordinate (i.e. without the S-index).
+        std::map<int, std::vector<CRectangleOverlap::Rectangle>> subBlocksPerScene; ///< The subblocks of this plane, with the scene index as key.
+    };
+
+    /// A fixed-width key identifying a plane - a bitfield of the valid dimensions and the values of all
+    /// dimensions (where the S-dimension is always left out).
+    struct PlaneKey
+    {
+        static constexpr int kNumberOfDimensions = static_cast<int>(libCZI::DimensionIndex::MaxDim) - static_cast<int>(libCZI::DimensionIndex::MinDim) + 1;
+
+        std::uint32_t validDimensions{ 0 };
+        std::array<std::int32_t, kNumberOfDimensions> values{};
+
+        /// Constructs the key for the plane of the specified coordinate (i.e. the S-index is ignored).
+        explicit PlaneKey(const libCZI::IDimCoordinate& coordinate);
+
+        bool operator==(const PlaneKey& other) const;
+
+        /// Gets a boolean indicating whether this key comes before the other one in the enumeration order of
+        /// "Utils::EnumAllCoordinates", where the lowest dimension index varies fastest.
+        [[nodiscard]] bool IsBefore(const PlaneKey& other) const;
+
+        /// Gets the plane coordinate represented by this key.
+        [[nodiscard]] libCZI::CDimCoordinate ToCoordinate() const;
+    };
+
+    /// Hash functor for PlaneKey (for use with unordered containers).
+    struct PlaneKeyHash
+    {
+        std::size_t operator()(const PlaneKey& key) const;
+    };
+
+    /// Functor for selecting the scenes of interest. If it returns false, the subblocks of the scene are not included.
+    using SceneFilterFunction = std::function<bool(int scene_index)>;
+
+    /// Gathers the layer-0 subblocks of the document, grouped by plane and scene. The planes are returned in the
+    /// same order as they are enumerated by "libCZI::Utils::EnumAllCoordinates" (i.e. with the lowest dimension
+    /// index varying fastest).
+    ///
+    /// \param  reader          The reader object.
+    /// \param  scene_filter    If non-null, only subblocks for which this functor returns true are included.
+    ///
+    /// \returns    The planes containing layer-0 subblocks (which pass the filter).
+    static std::vector<Plane> Gather(const std::shared_ptr<libCZI::ICZIReader>& reader, const SceneFilterFunction& scene_filter);
+
+    /// Gets a boolean indicating whether the specified subblock is on pyramid-layer 0 (i.e. its logical size is
+    /// equal to its physical size).
+    static bool IsLayer0(const libCZI::SubBlockInfo& info);
+
+    /// Gets the minification factor of the pyramid-layer the specified subblock is on (i.e. the ratio of its logical
+    /// width to its physical width, rounded to an integer) - 1 for pyramid-layer 0.
+    static int GetMinification(const libCZI::SubBlockInfo& info);
+};
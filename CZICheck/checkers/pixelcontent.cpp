@@ -0,0 +1,261 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "pixelcontent.h"
+#include "../segmentreader.h"
+#include <algorithm>
+#include <exception>
+
+using namespace libCZI;
+using namespace std;
+
+namespace
+{
+    template <typename T>
+    void AccumulateIntegers(const T* values, size_t count, PixelContentStatistics& statistics)
+    {
+        T minimum = (numeric_limits<T>::max)();
+        T maximum = (numeric_limits<T>::min)();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const T value = values[i];
+            minimum = value < minimum ? value : minimum;
+            maximum = value > maximum ? value : maximum;
+        }
+
+        if (count > 0)
+        {
+            statistics.minimum = min(statistics.minimum, static_cast<double>(minimum));
+            statistics.maximum = max(statistics.maximum, static_cast<double>(maximum));
+            statistics.valueCount += count;
+        }
+    }
+
+    template <typename T>
+    void AccumulateFloatingPoints(const T* values, size_t count, PixelContentStatistics& statistics)
+    {
+        T minimum = numeric_limits<T>::infinity();
+        T maximum = -numeric_limits<T>::infinity();
+        uint64_t nan_count = 0;
+        uint64_t inf_count = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const T value = values[i];
+            const bool is_nan = value != value;
+            const bool is_inf = value == numeric_limits<T>::infinity() || value == -numeric_limits<T>::infinity();
+            nan_count += is_nan ? 1 : 0;
+            inf_count += is_inf ? 1 : 0;
+
+            // NaN and infinite values are excluded from the minimum/maximum (note that comparisons with NaN are false)
+            const bool is_finite = !is_nan && !is_inf;
+            minimum = (is_finite && value < minimum) ? value : minimum;
+            maximum = (is_finite && value > maximum) ? value : maximum;
+        }
+
+        if (count > 0)
+        {
+            if (count > nan_count + inf_count)
+            {
+                statistics.minimum = min(statistics.minimum, static_cast<double>(minimum));
+                statistics.maximum = max(statistics.maximum, static_cast<double>(maximum));
+            }
+
+            statistics.nanCount += nan_count;
+            statistics.infCount += inf_count;
+            statistics.valueCount += count;
+        }
+    }
+}
+
+void PixelContentStatistics::Merge(const PixelContentStatistics& other)
+{
+    this->valueCount += other.valueCount;
+    this->nanCount += other.nanCount;
+    this->infCount += other.infCount;
+    this->minimum = min(this->minimum, other.minimum);
+    this->maximum = max(this->maximum, other.maximum);
+}
+
+/*static*/void CPixelContentAnalyzer::Accumulate(libCZI::PixelType pixel_type, const void* pixels, std::size_t pixel_count, PixelContentStatistics& statistics)
+{
+    switch (pixel_type)
+    {
+    case PixelType::Gray8:
+        AccumulateIntegers(static_cast<const uint8_t*>(pixels), pixel_count, statistics);
+        break;
+    case PixelType::Bgr24:
+        AccumulateIntegers(static_cast<const uint8_t*>(pixels), pixel_count * 3, statistics);
+        break;
+    case PixelType::Bgra32:
+        AccumulateIntegers(static_cast<const uint8_t*>(pixels), pixel_count * 4, statistics);
+        break;
+    case PixelType::Gray16:
+        AccumulateIntegers(static_cast<const uint16_t*>(pixels), pixel_count, statistics);
+        break;
+    case PixelType::Bgr48:
+        AccumulateIntegers(static_cast<const uint16_t*>(pixels), pixel_count * 3, statistics);
+        break;
+    case PixelType::Gray32:
+        AccumulateIntegers(static_cast<const uint32_t*>(pixels), pixel_count, statistics);
+        break;
+    case PixelType::Gray32Float:
+        AccumulateFloatingPoints(static_cast<const float*>(pixels), pixel_count, statistics);
+        break;
+    case PixelType::Bgr96Float:
+        AccumulateFloatingPoints(static_cast<const float*>(pixels), pixel_count * 3, statistics);
+        break;
+    case PixelType::Gray64ComplexFloat:
+        AccumulateFloatingPoints(static_cast<const float*>(pixels), pixel_count * 2, statistics);
+        break;
+    case PixelType::Bgr192ComplexFloat:
+        AccumulateFloatingPoints(static_cast<const float*>(pixels), pixel_count * 6, statistics);
+        break;
+    case PixelType::Gray64Float:
+        AccumulateFloatingPoints(static_cast<const double*>(pixels), pixel_count, statistics);
+        break;
+    default:
+        throw invalid_argument("unsupported pixeltype");
+    }
+}
+
+/*static*/bool CPixelContentAnalyzer::IsFloatingPointPixelType(libCZI::PixelType pixel_type)
+{
+    switch (pixel_type)
+    {
+    case PixelType::Gray32Float:
+    case PixelType::Bgr96Float:
+    case PixelType::Gray64ComplexFloat:
+    case PixelType::Bgr192ComplexFloat:
+    case PixelType::Gray64Float:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*static*/double CPixelContentAnalyzer::GetMaximumComponentValue(libCZI::PixelType pixel_type)
+{
+    switch (pixel_type)
+    {
+    case PixelType::Gray8:
+    case PixelType::Bgr24:
+    case PixelType::Bgra32:
+        return (numeric_limits<uint8_t>::max)();
+    case PixelType::Gray16:
+    case PixelType::Bgr48:
+        return (numeric_limits<uint16_t>::max)();
+    case PixelType::Gray32:
+        return (numeric_limits<uint32_t>::max)();
+    default:
+        return numeric_limits<double>::infinity();
+    }
+}
+
+/*static*/void CPixelContentAnalyzer::EnumerateSubBlocks(
+    const std::shared_ptr<libCZI::ICZIReader>& reader,
+    const CheckerCreateInfo& additional_info,
+    const SubBlockFilterFunction& filter,
+    const ReserveMemoryFunction& reserve_memory,
+    const SubBlockStatisticsFunction& func)
+{
+    reader->EnumerateSubBlocksEx(
+        [&](int index, const DirectorySubBlockInfo& info)->bool
+        {
+            if (filter && !filter(index, info))
+            {
+                return true;
+            }
+
+            PixelContentStatistics statistics;
+            PixelType pixel_type = info.pixelType;
+            bool success;
+            if (info.GetCompressionMode() == CompressionMode::UnCompressed && additional_info.stream)
+            {
+                success = CPixelContentAnalyzer::TryAnalyzeUncompressedSubBlock(additional_info, info, statistics);
+            }
+            else
+            {
+                // the reservation is held until the subblock and its bitmap have been released
+                CMemoryGovernor::Reservation reservation;
+                if (reserve_memory && !reserve_memory(index, info, reservation))
+                {
+                    return true;
+                }
+
+                success = CPixelContentAnalyzer::TryAnalyzeByDecoding(reader, index, pixel_type, statistics);
+            }
+
+            if (success)
+            {
+                func(index, info, pixel_type, statistics);
+            }
+
+            return true;
+        });
+}
+
+/*static*/bool CPixelContentAnalyzer::TryAnalyzeUncompressedSubBlock(const CheckerCreateInfo& additional_info, const libCZI::DirectorySubBlockInfo& info, PixelContentStatistics& statistics)
+{
+    try
+    {
+        const auto segment_info = CSegmentReader::ReadSubBlockSegmentInfo(additional_info.stream.get(), info.filePosition, additional_info.totalFileSize);
+        const uint8_t bytes_per_pixel = Utils::GetBytesPerPixel(info.pixelType);
+        const uint64_t size_of_bitmap = static_cast<uint64_t>(info.physicalSize.w) * info.physicalSize.h * bytes_per_pixel;
+        if (static_cast<uint64_t>(segment_info.dataSize) < size_of_bitmap)
+        {
+            return false;
+        }
+
+        // the stride of an uncompressed bitmap is "width x bytes-per-pixel", so the pixels are contiguous - we only need
+        //  to make sure that a chunk contains complete pixels
+        const size_t chunk_size = (CSegmentReader::kDefaultChunkSize / bytes_per_pixel) * bytes_per_pixel;
+        CSegmentReader::ReadInChunks(
+            additional_info.stream.get(),
+            segment_info.dataOffset,
+            size_of_bitmap,
+            chunk_size,
+            [&](uint64_t, const void* data, size_t size)->bool
+            {
+                CPixelContentAnalyzer::Accumulate(info.pixelType, data, size / bytes_per_pixel, statistics);
+                return true;
+            });
+    }
+    catch (exception&)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/*static*/bool CPixelContentAnalyzer::TryAnalyzeByDecoding(const std::shared_ptr<libCZI::ICZIReader>& reader, int index, libCZI::PixelType& pixel_type, PixelContentStatistics& statistics)
+{
+    try
+    {
+        const auto sub_block = reader->ReadSubBlock(index);
+        if (sub_block->GetSubBlockInfo().GetCompressionMode() == CompressionMode::Invalid)
+        {
+            return false;
+        }
+
+        const auto bitmap = sub_block->CreateBitmap();
+        const auto size = bitmap->GetSize();
+        pixel_type = bitmap->GetPixelType();
+        ScopedBitmapLockerSP locker{ bitmap };
+        for (uint32_t y = 0; y < size.h; ++y)
+        {
+            CPixelContentAnalyzer::Accumulate(
+                pixel_type,
+                static_cast<const uint8_t*>(locker.ptrDataRoi) + static_cast<size_t>(y) * locker.stride,
+                size.w,
+                statistics);
+        }
+    }
+    catch (exception&)
+    {
+        return false;
+    }
+
+    return true;
+}
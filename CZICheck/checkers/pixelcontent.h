@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "../inc_libCZI.h"
+#include "../checkerfactory.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+
+/// Statistics about the pixel values of a bitmap (or a part of it). All components of a pixel
+/// are taken into account, i.e. for a BGR-pixel the three values are examined.
+struct PixelContentStatistics
+{
+    std::uint64_t valueCount{ 0 };  ///< The number of values (i.e. pixels times components) examined.
+    std::uint64_t nanCount{ 0 };    ///< The number of NaN-values (only for floating point pixel types).
+    std::uint64_t infCount{ 0 };    ///< The number of infinite values (only for floating point pixel types).
+    double minimum{ std::numeric_limits<double>::infinity() };  ///< The minimum of all finite values.
+    double maximum{ -std::numeric_limits<double>::infinity() }; ///< The maximum of all finite values.
+
+    /// Gets a boolean indicating whether there are finite values (i.e. values which are neither NaN nor infinite).
+    [[nodiscard]] bool HasFiniteValues() const { return this->valueCount > this->nanCount + this->infCount; }
+
+    /// Gets a boolean indicating whether all values are finite and identical.
+    [[nodiscard]] bool IsConstant() const { return this->nanCount == 0 && this->infCount == 0 && this->HasFiniteValues() && this->minimum == this->maximum; }
+
+    /// Merges the specified statistics into this object.
+    void Merge(const PixelContentStatistics& other);
+};
+
+/// This class provides functionality for gathering statistics about the pixel content of subblocks.
+/// The kernels operating on the pixel data are plain loops over contiguous memory without branches
+/// in the loop body, so that they are suitable for being vectorized by the compiler.
+class CPixelContentAnalyzer
+{
+public:
+    /// Functor which is called for every subblock whose pixel content was analyzed successfully.
+    using SubBlockStatisticsFunction = std::function<void(int index, const libCZI::SubBlockInfo& info, libCZI::PixelType pixel_type, const PixelContentStatistics& statistics)>;
+
+    /// Functor for selecting the subblocks to be analyzed. If it returns false, the subblock is skipped.
+    using SubBlockFilterFunction = std::function<bool(int index, const libCZI::DirectorySubBlockInfo& info)>;
+
+    /// Functor for reserving the memory for decoding a subblock. If it returns false, the subblock is skipped.
+    using ReserveMemoryFunction = std::function<bool(int index, const libCZI::DirectorySubBlockInfo& info, CMemoryGovernor::Reservation& reservation)>;
+
+    /// Accumulates statistics for the specified pixels, which are expected to be contiguous in memory.
+    ///
+    /// \param          pixel_type  The pixel type.
+    /// \param          pixels      Pointer to the pixel data.
+    /// \param          pixel_count The number of pixels.
+    /// \param [in,out] statistics  The statistics to be updated.
+    static void Accumulate(libCZI::PixelType pixel_type, const void* pixels, std::size_t pixel_count, PixelContentStatistics& statistics);
+
+    /// Gets a boolean indicating whether the specified pixel type has floating point components.
+    static bool IsFloatingPointPixelType(libCZI::PixelType pixel_type);
+
+    /// Gets the maximum value a component of an integer pixel type can have (e.g. 255 for Gray8 or Bgr24).
+    /// For floating point pixel types, infinity is returned.
+    static double GetMaximumComponentValue(libCZI::PixelType pixel_type);
+
+    /// Reads (and decodes) all subblocks for which the filter returns true, and determines statistics about their pixel content.
+    /// Uncompressed subblocks are read in chunks directly from the stream (if available), so that they do not need to be
+    /// loaded as a whole. For all other subblocks, the memory for reading and decoding is reserved with the specified
+    /// functor before. Subblocks which cannot be read or decoded are skipped - reporting those is the business of the
+    /// checker 'subblkbitmapvalid'.
+    ///
+    /// \param  reader          The CZI-reader.
+    /// \param  additional_info Additional information (giving the stream and the file size).
+    /// \param  filter          The filter function (may be empty, in which case all subblocks are analyzed).
+    /// \param  reserve_memory  The functor for reserving the memory for decoding a subblock (may be empty, in which case no memory is reserved).
+    /// \param  func            Functor which is called with the statistics of each subblock analyzed.
+    static void EnumerateSubBlocks(
+        const std::shared_ptr<libCZI::ICZIReader>& reader,
+        const CheckerCreateInfo& additional_info,
+        const SubBlockFilterFunction& filter,
+        const ReserveMemoryFunction& reserve_memory,
+        const SubBlockStatisticsFunction& func);
+private:
+    static bool TryAnalyzeUncompressedSubBlock(const CheckerCreateInfo& additional_info, const libCZI::DirectorySubBlockInfo& info, PixelContentStatistics& statistics);
+    static bool TryAnalyzeByDecoding(const std::shared_ptr<libCZI::ICZIReader>& reader, int index, libCZI::PixelType& pixel_type, PixelContentStatistics& statistics);
+};
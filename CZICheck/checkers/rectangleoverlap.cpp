@@ -0,0 +1,383 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "rectangleoverlap.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <set>
+#include <utility>
+
+using namespace libCZI;
+using namespace std;
+
+namespace
+{
+    bool IsNonEmpty(const IntRect& rect)
+    {
+        return rect.w > 0 && rect.h > 0;
+    }
+
+    /// A segment tree over the elementary intervals between consecutive (distinct) y-coordinates. For every node
+    /// we keep the number of rectangles covering the node's range as a whole (which is not propagated to the
+    /// children), and - taking into account the node's subtree only - the length covered at least once and at
+    /// least twice, and the maximum depth.
+    class CCoverageSegmentTree
+    {
+    private:
+        struct Node
+        {
+            int count{ 0 };
+            int64_t coveredOnce{ 0 };
+            int64_t coveredTwice{ 0 };
+            int maximumDepth{ 0 };
+        };
+
+        const vector<int64_t>& coordinates_;
+        vector<Node> nodes_;
+    public:
+        explicit CCoverageSegmentTree(const vector<int64_t>& coordinates) :
+            coordinates_(coordinates),
+            nodes_(coordinates.size() > 1 ? 4 * (coordinates.size() - 1) : 1)
+        {}
+
+        /// Adds the specified value (+1 or -1) to the elementary intervals in the range [first, last).
+        void Add(size_t first, size_t last, int value)
+        {
+            if (first < last)
+            {
+                this->Add(1, 0, this->coordinates_.size() - 1, first, last, value);
+            }
+        }
+
+        [[nodiscard]] int64_t GetCoveredOnce() const { return this->nodes_[1].coveredOnce; }
+        [[nodiscard]] int64_t GetCoveredTwice() const { return this->nodes_[1].coveredTwice; }
+        [[nodiscard]] int GetMaximumDepth() const { return this->nodes_[1].maximumDepth; }
+    private:
+        void Add(size_t node, size_t node_first, size_t node_last, size_t first, size_t last, int value)
+        {
+            if (last <= node_first || node_last <= first)
+            {
+                return;
+            }
+
+            if (first <= node_first && node_last <= last)
+            {
+                this->nodes_[node].count += value;
+            }
+            else
+            {
+                const size_t middle = (node_first + node_last) / 2;
+                this->Add(2 * node, node_first, middle, first, last, value);
+                this->Add(2 * node + 1, middle, node_last, first, last, value);
+            }
+
+            this->Update(node, node_first, node_last);
+        }
+
+        void Update(size_t node, size_t node_first, size_t node_last)
+        {
+            Node& n = this->nodes_[node];
+            const bool is_leaf = node_last - node_first == 1;
+            const int64_t length = this->coordinates_[node_last] - this->coordinates_[node_first];
+            const Node* left = is_leaf ? nullptr : &this->nodes_[2 * node];
+            const Node* right = is_leaf ? nullptr : &this->nodes_[2 * node + 1];
+            n.maximumDepth = n.count + (is_leaf ? 0 : max(left->maximumDepth, right->maximumDepth));
+            if (n.count >= 2)
+            {
+                n.coveredOnce = n.coveredTwice = length;
+            }
+            else if (n.count == 1)
+            {
+                n.coveredOnce = length;
+                n.coveredTwice = is_leaf ? 0 : left->coveredOnce + right->coveredOnce;
+            }
+            else
+            {
+                n.coveredOnce = is_leaf ? 0 : left->coveredOnce + right->coveredOnce;
+                n.coveredTwice = is_leaf ? 0 : left->coveredTwice + right->coveredTwice;
+            }
+        }
+    };
+
+    /// The rectangles intersecting the sweep-line, organized for finding those overlapping a given range in
+    /// y-direction. The y-coordinates are given as indices into the (sorted) distinct y-coordinates. A rectangle
+    /// [top, bottom) overlaps the range [first, last) if either it contains "first" (which is found with a
+    /// stabbing query on a segment tree, where every rectangle is stored in the O(log n) nodes covering its range),
+    /// or if its top lies within (first, last) (which is found with a range query on the rectangles ordered by
+    /// their top). Both queries take O(log n + k) time for k rectangles found.
+    /// Rectangles are removed from the segment tree lazily - the "active"-flags are owned by the caller, and entries
+    /// of inactive rectangles are dropped when they are encountered in a query.
+    class CActiveIntervals
+    {
+    private:
+        const vector<char>& is_active_;
+        size_t coordinate_count_;
+        vector<vector<uint32_t>> nodes_;
+        set<pair<size_t, uint32_t>> by_top_;
+    public:
+        CActiveIntervals(size_t coordinate_count, const vector<char>& is_active) :
+            is_active_(is_active),
+            coordinate_count_(coordinate_count),
+            nodes_(coordinate_count > 1 ? 4 * (coordinate_count - 1) : 1)
+        {}
+
+        void Add(uint32_t id, size_t top, size_t bottom)
+        {
+            this->by_top_.emplace(top, id);
+            if (top < bottom)
+            {
+                this->Insert(1, 0, this->coordinate_count_ - 1, top, bottom, id);
+            }
+        }
+
+        void Remove(uint32_t id, size_t top)
+        {
+            this->by_top_.erase(make_pair(top, id));
+        }
+
+        /// Enumerates the rectangles overlapping the range [first, last). If the functor returns false, the enumeration
+        /// is cancelled and false is returned.
+        bool Enumerate(size_t first, size_t last, const function<bool(uint32_t)>& func)
+        {
+            if (!this->Stab(1, 0, this->coordinate_count_ - 1, first, func))
+            {
+                return false;
+            }
+
+            for (auto iterator = this->by_top_.upper_bound(make_pair(first, UINT32_MAX)); iterator != this->by_top_.end() && iterator->first < last; ++iterator)
+            {
+                if (!func(iterator->second))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    private:
+        void Insert(size_t node, size_t node_first, size_t node_last, size_t first, size_t last, uint32_t id)
+        {
+            if (last <= node_first || node_last <= first)
+            {
+                return;
+            }
+
+            if (first <= node_first && node_last <= last)
+            {
+                this->nodes_[node].push_back(id);
+                return;
+            }
+
+            const size_t middle = (node_first + node_last) / 2;
+            this->Insert(2 * node, node_first, middle, first, last, id);
+            this->Insert(2 * node + 1, middle, node_last, first, last, id);
+        }
+
+        bool Stab(size_t node, size_t node_first, size_t node_last, size_t position, const function<bool(uint32_t)>& func)
+        {
+            if (position < node_first || node_last <= position)
+            {
+                return true;
+            }
+
+            auto& ids = this->nodes_[node];
+            for (size_t i = 0; i < ids.size();)
+            {
+                if (!this->is_active_[ids[i]])
+                {
+                    ids[i] = ids.back();
+                    ids.pop_back();
+                    continue;
+                }
+
+                if (!func(ids[i]))
+                {
+                    return false;
+                }
+
+                ++i;
+            }
+
+            if (node_last - node_first == 1)
+            {
+                return true;
+            }
+
+            const size_t middle = (node_first + node_last) / 2;
+            return position < middle ?
+                this->Stab(2 * node, node_first, middle, position, func) :
+                this->Stab(2 * node + 1, middle, node_last, position, func);
+        }
+    };
+}
+
+/*static*/void CRectangleOverlap::EnumOverlappingPairs(const std::vector<Rectangle>& rectangles1, const std::vector<Rectangle>& rectangles2, const OverlappingPairFunction& func)
+{
+    vector<SweepItem> items;
+    items.reserve(rectangles1.size() + rectangles2.size());
+    for (size_t i = 0; i < rectangles1.size(); ++i)
+    {
+        if (IsNonEmpty(rectangles1[i].rect))
+        {
+            items.emplace_back(SweepItem{ rectangles1[i].rect, rectangles1[i].id, 0, static_cast<int>(i) });
+        }
+    }
+
+    for (size_t i = 0; i < rectangles2.size(); ++i)
+    {
+        if (IsNonEmpty(rectangles2[i].rect))
+        {
+            items.emplace_back(SweepItem{ rectangles2[i].rect, rectangles2[i].id, 1, static_cast<int>(i) });
+        }
+    }
+
+    CRectangleOverlap::Sweep(items, true, func);
+}
+
+/*static*/void CRectangleOverlap::EnumOverlappingPairs(const std::vector<Rectangle>& rectangles, const OverlappingPairFunction& func)
+{
+    vector<SweepItem> items;
+    items.reserve(rectangles.size());
+    for (size_t i = 0; i < rectangles.size(); ++i)
+    {
+        if (IsNonEmpty(rectangles[i].rect))
+        {
+            items.emplace_back(SweepItem{ rectangles[i].rect, rectangles[i].id, 0, static_cast<int>(i) });
+        }
+    }
+
+    CRectangleOverlap::Sweep(items, false, func);
+}
+
+/*static*/void CRectangleOverlap::Sweep(std::vector<SweepItem>& items, bool only_pairs_from_different_sets, const OverlappingPairFunction& func)
+{
+    sort(items.begin(), items.end(), [](const SweepItem& a, const SweepItem& b)->bool {return a.rect.x < b.rect.x; });
+
+    vector<int64_t> y_coordinates;
+    y_coordinates.reserve(2 * items.size());
+    for (const auto& item : items)
+    {
+        y_coordinates.emplace_back(item.rect.y);
+        y_coordinates.emplace_back(static_cast<int64_t>(item.rect.y) + item.rect.h);
+    }
+
+    sort(y_coordinates.begin(), y_coordinates.end());
+    y_coordinates.erase(unique(y_coordinates.begin(), y_coordinates.end()), y_coordinates.end());
+    const auto get_y_index = [&](int64_t y)->size_t
+        {
+            return lower_bound(y_coordinates.cbegin(), y_coordinates.cend(), y) - y_coordinates.cbegin();
+        };
+
+    // the active rectangles are those whose right edge is to the right of the current position of the sweep-line - they
+    //  are kept per set (so that only the other set needs to be queried if only pairs from different sets are requested),
+    //  and a min-heap ordered by the right edge gives the rectangles to be removed when the sweep-line advances
+    vector<char> is_active(items.size(), 0);
+    CActiveIntervals active[2] = { CActiveIntervals(y_coordinates.size(), is_active), CActiveIntervals(y_coordinates.size(), is_active) };
+    using RightEdge = pair<int64_t, uint32_t>;
+    priority_queue<RightEdge, vector<RightEdge>, greater<RightEdge>> right_edges;
+    for (uint32_t i = 0; i < items.size(); ++i)
+    {
+        const auto& item = items[i];
+        while (!right_edges.empty() && right_edges.top().first <= item.rect.x)
+        {
+            const uint32_t expired = right_edges.top().second;
+            right_edges.pop();
+            is_active[expired] = 0;
+            active[items[expired].set].Remove(expired, get_y_index(items[expired].rect.y));
+        }
+
+        const size_t top = get_y_index(item.rect.y);
+        const size_t bottom = get_y_index(static_cast<int64_t>(item.rect.y) + item.rect.h);
+        const bool continue_enumeration = active[only_pairs_from_different_sets ? 1 - item.set : 0].Enumerate(
+            top,
+            bottom,
+            [&](uint32_t other_index)->bool
+            {
+                // the other rectangle starts left of or at the left edge of this one, and ends to the right of it, and it
+                //  overlaps in y-direction
+                const SweepItem& other = items[other_index];
+                const IntRect intersection = item.rect.Intersect(other.rect);
+
+                // report the pair in the canonical order - first set before second set, and within a set by position
+                const bool item_first = item.set != other.set ? item.set < other.set : item.position < other.position;
+                return item_first ? func(item.id, other.id, intersection) : func(other.id, item.id, intersection);
+            });
+        if (!continue_enumeration)
+        {
+            return;
+        }
+
+        is_active[i] = 1;
+        active[only_pairs_from_different_sets ? item.set : 0].Add(i, top, bottom);
+        right_edges.emplace(static_cast<int64_t>(item.rect.x) + item.rect.w, i);
+    }
+}
+
+/*static*/CRectangleOverlap::CoverageStatistics CRectangleOverlap::CalculateCoverage(const std::vector<Rectangle>& rectangles)
+{
+    CoverageStatistics statistics;
+
+    // the events of the sweep-line - a rectangle is added at its left edge and removed at its right edge
+    struct Event
+    {
+        int64_t x;
+        int value;
+        size_t index;
+    };
+
+    vector<Event> events;
+    vector<int64_t> y_coordinates;
+    events.reserve(2 * rectangles.size());
+    y_coordinates.reserve(2 * rectangles.size());
+    for (size_t i = 0; i < rectangles.size(); ++i)
+    {
+        const auto& rect = rectangles[i].rect;
+        if (IsNonEmpty(rect))
+        {
+            statistics.totalArea += static_cast<uint64_t>(rect.w) * static_cast<uint64_t>(rect.h);
+            events.emplace_back(Event{ rect.x, 1, i });
+            events.emplace_back(Event{ static_cast<int64_t>(rect.x) + rect.w, -1, i });
+            y_coordinates.emplace_back(rect.y);
+            y_coordinates.emplace_back(static_cast<int64_t>(rect.y) + rect.h);
+        }
+    }
+
+    if (events.empty())
+    {
+        return statistics;
+    }
+
+    sort(y_coordinates.begin(), y_coordinates.end());
+    y_coordinates.erase(unique(y_coordinates.begin(), y_coordinates.end()), y_coordinates.end());
+    sort(events.begin(), events.end(), [](const Event& a, const Event& b)->bool {return a.x < b.x; });
+
+    const auto get_y_index = [&](int64_t y)->size_t
+        {
+            return lower_bound(y_coordinates.cbegin(), y_coordinates.cend(), y) - y_coordinates.cbegin();
+        };
+
+    CCoverageSegmentTree tree(y_coordinates);
+    for (size_t i = 0; i < events.size();)
+    {
+        // process all events at the same x-position, then account for the slab up to the next x-position
+        const int64_t x = events[i].x;
+        for (; i < events.size() && events[i].x == x; ++i)
+        {
+            const auto& rect = rectangles[events[i].index].rect;
+            tree.Add(get_y_index(rect.y), get_y_index(static_cast<int64_t>(rect.y) + rect.h), events[i].value);
+        }
+
+        if (i < events.size())
+        {
+            const int64_t width = events[i].x - x;
+            statistics.coveredArea += static_cast<uint64_t>(tree.GetCoveredOnce() * width);
+            statistics.multiplyCoveredArea += static_cast<uint64_t>(tree.GetCoveredTwice() * width);
+            statistics.maximumDepth = max(statistics.maximumDepth, tree.GetMaximumDepth());
+        }
+    }
+
+    return statistics;
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "../inc_libCZI.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/// This class provides functionality for finding overlapping rectangles (e.g. the logical rectangles of the
+/// subblocks of a plane). A sweep-line algorithm is used: the rectangles are sorted by their left edge, and
+/// while sweeping from left to right, a rectangle only needs to be tested against the rectangles intersecting
+/// the sweep-line (the "active" rectangles). The active rectangles are removed in the order of their right edge
+/// (with a min-heap), and the active rectangles overlapping in y-direction are found with a segment tree and a
+/// search tree over the y-coordinates - so the cost is O(n log n + k) for n rectangles and k overlapping pairs.
+/// Rectangles with zero (or negative) width or height are ignored.
+class CRectangleOverlap
+{
+public:
+    /// A rectangle, identified by an (arbitrary) id.
+    struct Rectangle
+    {
+        int id;                 ///< The identifier of the rectangle (e.g. the subblock index).
+        libCZI::IntRect rect;   ///< The rectangle.
+    };
+
+    /// Statistics about how a set of rectangles covers the plane.
+    struct CoverageStatistics
+    {
+        std::uint64_t totalArea{ 0 };           ///< The sum of the areas of all rectangles.
+        std::uint64_t coveredArea{ 0 };         ///< The area covered by at least one rectangle (i.e. the area of the union).
+        std::uint64_t multiplyCoveredArea{ 0 }; ///< The area covered by at least two rectangles.
+        int maximumDepth{ 0 };                  ///< The maximum number of rectangles covering a point.
+    };
+
+    /// Functor which is called for every pair of overlapping rectangles, with the ids of the two rectangles and their
+    /// intersection. If it returns false, the enumeration is cancelled.
+    using OverlappingPairFunction = std::function<bool(int id1, int id2, const libCZI::IntRect& intersection)>;
+
+    /// Enumerates all pairs of overlapping rectangles where the first rectangle is from the first set and the second
+    /// rectangle is from the second set. Pairs within the same set are not reported. The order of the pairs is not
+    /// specified.
+    ///
+    /// \param  rectangles1 The first set of rectangles.
+    /// \param  rectangles2 The second set of rectangles.
+    /// \param  func        The functor which is called for every pair of overlapping rectangles.
+    static void EnumOverlappingPairs(const std::vector<Rectangle>& rectangles1, const std::vector<Rectangle>& rectangles2, const OverlappingPairFunction& func);
+
+    /// Enumerates all pairs of overlapping rectangles within the specified set. Every pair is reported once, with the
+    /// rectangle coming first in the vector given as the first rectangle. The order of the pairs is not specified.
+    ///
+    /// \param  rectangles  The set of rectangles.
+    /// \param  func        The functor which is called for every pair of overlapping rectangles.
+    static void EnumOverlappingPairs(const std::vector<Rectangle>& rectangles, const OverlappingPairFunction& func);
+    /// Calculates statistics about how the specified rectangles cover the plane. This is done with a sweep-line (in
+    /// x-direction) and a segment tree over the (compressed) y-coordinates, so the cost is O(n log n).
+    ///
+    /// \param  rectangles  The set of rectangles.
+    ///
+    /// \returns    The coverage statistics.
+    static CoverageStatistics CalculateCoverage(const std::vector<Rectangle>& rectangles);
+private:
+    struct SweepItem
+    {
+        libCZI::IntRect rect;
+        int id;
+        int set;        ///< The set the rectangle belongs to (0 or 1).
+        int position;   ///< The position of the rectangle within its set.
+    };
+
+    static void Sweep(std::vector<SweepItem>& items, bool only_pairs_from_different_sets, const OverlappingPairFunction& func);
+};
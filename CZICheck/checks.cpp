@@ -24,6 +24,15 @@ const char* CZIChecksToString(CZIChecks czi_check)
         case CZIChecks::ConsistentMIndex: return "ConsistentMIndex";
         case CZIChecks::AttachmentDirectoryPositionsWithinRange: return "AttachmentDirectoryPositionsWithinRange";
         case CZIChecks::ApplianceMetadataTopographyItemValid: return "ApplianceMetadataTopographyItemValid";
+        case CZIChecks::SubBlockPixelContentSanity: return "SubBlockPixelContentSanity";
+        case CZIChecks::ComponentBitCountFitsPixelContent: return "ComponentBitCountFitsPixelContent";
+        case CZIChecks::DuplicateSubBlockContent: return "DuplicateSubBlockContent";
+        case CZIChecks::PyramidSubBlocksConsistentWithLayer0: return "PyramidSubBlocksConsistentWithLayer0";
+        case CZIChecks::TileOverlapWithinScene: return "TileOverlapWithinScene";
+        case CZIChecks::SegmentExtentsValid: return "SegmentExtentsValid";
+        case CZIChecks::FileLayoutLocality: return "FileLayoutLocality";
+        case CZIChecks::PyramidCompleteness: return "PyramidCompleteness";
+        case CZIChecks::SubBlockSizeDistribution: return "SubBlockSizeDistribution";
         default: throw std::invalid_argument("No known conversion from CZIChecks to char");
     }
 }
@@ -51,12 +51,45 @@ enum class CZIChecks
     /// All subblocks are read AND their content is decoded and checked for consistency.
     CheckSubBlockBitmapValid,
 
-    ConsistentMIndex,   ///< To be done, not yet implemented.
+    /// It is checked whether the M-indices of the subblocks on pyramid-layer 0 within a plane (and scene) are consecutive,
+    /// unique and start at zero.
+    ConsistentMIndex,
 
-    AttachmentDirectoryPositionsWithinRange, ///< To be done, not yet implemented.
+    /// It is checked whether the attachment-segments listed in the attachment-directory are within the file, and whether
+    /// the headers of the attachment-segments are valid.
+    AttachmentDirectoryPositionsWithinRange,
 
     /// The Appliance Metadata specified for TopographyDataItem(s) are valid
     ApplianceMetadataTopographyItemValid,
+
+    /// The pixel content of all subblocks is decoded and checked for NaN/Inf-values, saturation and constant content.
+    SubBlockPixelContentSanity,
+
+    /// The pixel values of a channel do not use more bits than given by the "ComponentBitCount" in metadata.
+    ComponentBitCountFitsPixelContent,
+
+    /// There are no subblocks with identical content (i.e. identical data).
+    DuplicateSubBlockContent,
+
+    /// Check that (a sample of) the pyramid subblocks is consistent with the content of pyramid-layer 0.
+    PyramidSubBlocksConsistentWithLayer0,
+
+    /// The tiles (on pyramid-layer 0) within a scene and a plane do not overlap excessively.
+    TileOverlapWithinScene,
+
+    /// The segments referenced from the file-header and the directories are within the file and do not overlap.
+    SegmentExtentsValid,
+
+    /// Analyze how the subblocks of a plane are laid out in the file (i.e. how contiguous their data is).
+    FileLayoutLocality,
+
+    /// The pyramid of each scene is complete (i.e. each pyramid-layer covers pyramid-layer 0), and the coarsest pyramid-layer
+    /// is small enough for an overview.
+    PyramidCompleteness,
+
+    /// The sizes of the subblocks are within reasonable bounds (i.e. there are not excessively many tiny subblocks and
+    /// there are no giant subblocks).
+    SubBlockSizeDistribution,
 };
 
 const char* CZIChecksToString(CZIChecks czi_check);
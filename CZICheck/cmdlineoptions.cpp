@@ -132,6 +132,25 @@ CCmdLineOptions::ParseResult CCmdLineOptions::Parse(int argc, char** argv)
         }
     };
 
+    // CLI11-validator for the option "--max-memory".
+    struct MemorySizeValidator : public CLI::Validator
+    {
+        MemorySizeValidator()
+        {
+            this->func_ = [](const std::string& str) -> string
+                {
+                    string error_message;
+                    const bool parsed_ok = CCmdLineOptions::ParseMemorySizeArgument(str, nullptr, &error_message);
+                    if (!parsed_ok)
+                    {
+                        throw CLI::ValidationError(error_message);
+                    }
+
+                    return {};
+                };
+        }
+    };
+
     // CLI11-validator for the option "--printdetails".
     struct PrintDetailsValidator : public BooleanArgumentValidator
     {
@@ -146,11 +165,20 @@ CCmdLineOptions::ParseResult CCmdLineOptions::Parse(int argc, char** argv)
         {}
     };
 
+    // CLI11-validator for the option "--statistics".
+    struct StatisticsValidator : public BooleanArgumentValidator
+    {
+        StatisticsValidator() : BooleanArgumentValidator("statistics")
+        {}
+    };
+
     static const ChecksValidator checks_validator;
     static const EncodingValidator encodings_validator;
     static const PrintDetailsValidator print_details_validator;
     static const LaxParsingValidator lax_parsing_validator;
     static const FailFastValidator fail_fast_validator;
+    static const StatisticsValidator statistics_validator;
+    static const MemorySizeValidator memory_size_validator;
 
     string source_filename_options;
     string checks_enable_options;
@@ -162,6 +190,14 @@ CCmdLineOptions::ParseResult CCmdLineOptions::Parse(int argc, char** argv)
     string source_stream_class_option;
     string property_bag_options;
     string fail_fast_option;
+    string statistics_option;
+    string write_manifest_option;
+    string verify_manifest_option;
+    double max_decode_amplification_option = 1.5;
+    uint32_t min_tile_size_option = 128;
+    uint32_t max_tile_size_option = 16384;
+    string max_memory_option;
+    string temp_directory_option;
     bool argument_version_flag = false;
     app.add_option("-s,--source", source_filename_options, "Specify the CZI-file to be checked.")
         ->option_text("FILENAME");
@@ -231,6 +267,68 @@ CCmdLineOptions::ParseResult CCmdLineOptions::Parse(int argc, char** argv)
         "  'all'     - abort entire operation immediately")
         ->option_text("FAIL-FAST-MODE")
         ->check(fail_fast_validator);
+    app.add_option("--statistics", statistics_option,
+        "Specifies whether checkers should report statistics (e.g.\n"
+        "counters and timings gathered while running a check).\n"
+        "Note that timings differ from run to run, so the output\n"
+        "is not reproducible with this option enabled.\n"
+        "The argument may be one of 'true', 'false', 'yes'\n"
+        "or 'no'. Default is 'no'.\n")
+        ->option_text("BOOLEAN")
+        ->check(statistics_validator);
+    app.add_option("--write-manifest", write_manifest_option,
+        "Specifies a file where a manifest of the subblocks is to be\n"
+        "written to. The manifest contains a hash of the data of every\n"
+        "subblock, it is created while running the checker\n"
+        "'subblkbitmapvalid' or 'subblksegmentsvalid' (one of them\n"
+        "must be enabled).\n")
+        ->option_text("FILENAME");
+    app.add_option("--verify-manifest", verify_manifest_option,
+        "Specifies a manifest file (created with '--write-manifest')\n"
+        "against which the subblocks are compared. Subblocks whose\n"
+        "data differs from the manifest are reported by the checker\n"
+        "'subblkbitmapvalid' or 'subblksegmentsvalid' (one of them\n"
+        "must be enabled).\n")
+        ->option_text("FILENAME");
+    app.add_option("--max-decode-amplification", max_decode_amplification_option,
+        "Specifies the maximum \"decode amplification\" of the tiles\n"
+        "within a scene and a plane (i.e. the sum of the tile areas\n"
+        "divided by the area covered by them), above which the checker\n"
+        "'tileoverlap' reports a warning. Default is 1.5.\n")
+        ->option_text("FLOAT")
+        ->default_val(1.5)
+        ->check(CLI::Range(1.0, (numeric_limits<double>::max)()));
+    app.add_option("--min-tile-size", min_tile_size_option,
+        "Specifies the minimum size of a tile (i.e. the larger of width\n"
+        "and height in pixels). The checker 'subblksizes' reports a\n"
+        "warning if the majority of (at least 1000) subblocks of a\n"
+        "channel is smaller. Default is 128.\n")
+        ->option_text("INTEGER")
+        ->default_val(128)
+        ->check(CLI::Range(1u, (numeric_limits<uint32_t>::max)()));
+    app.add_option("--max-tile-size", max_tile_size_option,
+        "Specifies the maximum size of a tile (i.e. the larger of width\n"
+        "and height in pixels). The checker 'subblksizes' reports a\n"
+        "warning if subblocks are larger. Default is 16384.\n")
+        ->option_text("INTEGER")
+        ->default_val(16384)
+        ->check(CLI::Range(1u, (numeric_limits<uint32_t>::max)()));
+    app.add_option("--max-memory", max_memory_option,
+        "Specifies the maximum amount of memory to be used for large\n"
+        "allocations (decoding subblocks, data gathered from the\n"
+        "subblock-directory and the JSON-/XML-output). If exceeded, data is\n"
+        "spilled to temporary files, output is reduced or a finding is\n"
+        "reported. The size is given in bytes, optionally with one of\n"
+        "the suffixes 'K', 'M' or 'G'. Default is '0', meaning 'no limit'.\n")
+        ->option_text("SIZE")
+        ->check(memory_size_validator);
+    app.add_option("--temp-dir", temp_directory_option,
+        "Specifies the directory where temporary files (e.g. of the\n"
+        "external sort used when the memory budget is exceeded) are\n"
+        "created. Default is the system's directory for temporary\n"
+        "files (e.g. given by the environment variable TMPDIR).\n")
+        ->option_text("DIRECTORY")
+        ->check(CLI::ExistingDirectory);
     app.add_flag("--version", argument_version_flag,
         "Print extended version-info and supported operations, then exit.");
 
@@ -341,6 +439,55 @@ CCmdLineOptions::ParseResult CCmdLineOptions::Parse(int argc, char** argv)
         this->fail_fast_mode_ = fail_fast_mode;
     }
 
+    if (!statistics_option.empty())
+    {
+        string error_message;
+        const bool parsed_ok = CCmdLineOptions::ParseBooleanArgument("statistics", statistics_option, &this->statistics_enabled_, &error_message);
+        if (!parsed_ok)
+        {
+            this->log_->WriteLineStdErr(error_message);
+            return ParseResult::Error;
+        }
+    }
+
+    if (!write_manifest_option.empty() || !verify_manifest_option.empty())
+    {
+        // the hashes for the manifest are calculated by those checkers which read the subblock data anyway
+        if (find(this->checks_enabled_.cbegin(), this->checks_enabled_.cend(), CZIChecks::CheckSubBlockBitmapValid) == this->checks_enabled_.cend() &&
+            find(this->checks_enabled_.cbegin(), this->checks_enabled_.cend(), CZIChecks::SubBlockDirectorySegmentValid) == this->checks_enabled_.cend())
+        {
+            this->log_->WriteLineStdErr("The options '--write-manifest' and '--verify-manifest' require the checker 'subblkbitmapvalid' or 'subblksegmentsvalid' to be enabled.");
+            return ParseResult::Error;
+        }
+
+        this->write_manifest_filename_ = convertUtf8ToUCS2(write_manifest_option);
+        this->verify_manifest_filename_ = convertUtf8ToUCS2(verify_manifest_option);
+    }
+
+    this->max_decode_amplification_ = max_decode_amplification_option;
+
+    if (min_tile_size_option > max_tile_size_option)
+    {
+        this->log_->WriteLineStdErr("The minimum tile size ('--min-tile-size') must not be larger than the maximum tile size ('--max-tile-size').");
+        return ParseResult::Error;
+    }
+
+    this->min_tile_size_ = min_tile_size_option;
+    this->max_tile_size_ = max_tile_size_option;
+
+    if (!max_memory_option.empty())
+    {
+        string error_message;
+        const bool parsed_ok = CCmdLineOptions::ParseMemorySizeArgument(max_memory_option, &this->max_memory_, &error_message);
+        if (!parsed_ok)
+        {
+            this->log_->WriteLineStdErr(error_message);
+            return ParseResult::Error;
+        }
+    }
+
+    this->temp_directory_ = convertUtf8ToUCS2(temp_directory_option);
+
     // Parse source stream class option
     if (!source_stream_class_option.empty())
     {
@@ -451,6 +598,58 @@ CCmdLineOptions::ParseResult CCmdLineOptions::Parse(int argc, char** argv)
     return false;
 }
 
+/*static*/bool CCmdLineOptions::ParseMemorySizeArgument(const std::string& str, std::uint64_t* size, std::string* error_message)
+{
+    const regex re(R"(^\s*(\d+)\s*([kKmMgG]?)\s*$)");
+    smatch match;
+    if (regex_match(str, match, re))
+    {
+        uint64_t value = 0;
+        bool overflow = false;
+        for (const char c : match[1].str())
+        {
+            if (value > ((numeric_limits<uint64_t>::max)() - (c - '0')) / 10)
+            {
+                overflow = true;
+                break;
+            }
+
+            value = value * 10 + (c - '0');
+        }
+
+        int shift = 0;
+        if (!match[2].str().empty())
+        {
+            switch (match[2].str()[0])
+            {
+            case 'k': case 'K': shift = 10; break;
+            case 'm': case 'M': shift = 20; break;
+            case 'g': case 'G': shift = 30; break;
+            default: break;
+            }
+        }
+
+        if (!overflow && value <= ((numeric_limits<uint64_t>::max)() >> shift))
+        {
+            if (size != nullptr)
+            {
+                *size = value << shift;
+            }
+
+            return true;
+        }
+    }
+
+    if (error_message != nullptr)
+    {
+        ostringstream ss;
+        ss << "The memory size \"" << str << "\" is invalid.";
+        *error_message = ss.str();
+    }
+
+    return false;
+}
+
 /*static*/bool CCmdLineOptions::ParseChecksArgument(const std::string& str, std::vector<CZIChecks>* checks_enabled, std::string* error_message)
 {
     if (error_message != nullptr)
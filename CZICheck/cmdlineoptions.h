@@ -67,6 +67,14 @@ private:
     std::map<std::string, std::string> property_bag_;
     std::map<int, libCZI::StreamsFactory::Property> property_bag_for_stream_class_;
     FailFastMode fail_fast_mode_{ FailFastMode::Disabled };
+    bool statistics_enabled_{ false };
+    std::wstring write_manifest_filename_;
+    std::wstring verify_manifest_filename_;
+    double max_decode_amplification_{ 1.5 };
+    std::uint32_t min_tile_size_{ 128 };
+    std::uint32_t max_tile_size_{ 16384 };
+    std::uint64_t max_memory_{ 0 };
+    std::wstring temp_directory_;
 public:
     /// Values that represent the result of the "Parse"-operation.
     enum class ParseResult
@@ -97,11 +105,20 @@ public:
     [[nodiscard]] const std::string& GetSourceStreamClass() const { return this->source_stream_class_; }
     [[nodiscard]] const std::map<int, libCZI::StreamsFactory::Property>& GetPropertyBagForStreamClass() const { return this->property_bag_for_stream_class_; }
     [[nodiscard]] FailFastMode GetFailFastMode() const { return this->fail_fast_mode_; }
+    [[nodiscard]] bool GetStatisticsEnabled() const { return this->statistics_enabled_; }
+    [[nodiscard]] const std::wstring& GetWriteManifestFilename() const { return this->write_manifest_filename_; }
+    [[nodiscard]] const std::wstring& GetVerifyManifestFilename() const { return this->verify_manifest_filename_; }
+    [[nodiscard]] double GetMaxDecodeAmplification() const { return this->max_decode_amplification_; }
+    [[nodiscard]] std::uint32_t GetMinTileSize() const { return this->min_tile_size_; }
+    [[nodiscard]] std::uint32_t GetMaxTileSize() const { return this->max_tile_size_; }
+    [[nodiscard]] std::uint64_t GetMaxMemory() const { return this->max_memory_; }
+    [[nodiscard]] const std::wstring& GetTempDirectory() const { return this->temp_directory_; }
 private:
     static bool ParseBooleanArgument(const std::string& argument_key, const std::string& argument_value, bool* boolean_value, std::string* error_message);
     static bool ParseChecksArgument(const std::string& str, std::vector<CZIChecks>* checks_enabled, std::string* error_message);
     static bool ParseEncodingArgument(const std::string& str, OutputEncodingFormat& encoding, std::string& error_message);
     static bool ParseFailFastArgument(const std::string& str, FailFastMode& fail_fast_mode, std::string& error_message);
+    static bool ParseMemorySizeArgument(const std::string& str, std::uint64_t* size, std::string* error_message);
 
     /// Information about a "checker item" and whether it is to be added or removed.
     struct CheckerToRunInfo
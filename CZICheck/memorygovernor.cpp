@@ -0,0 +1,282 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "memorygovernor.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+using namespace std;
+
+CMemoryGovernor::Reservation::Reservation(CMemoryGovernor* governor, std::string consumer, std::thread::id thread_id, std::uint64_t size)
+    : governor_(governor), consumer_(std::move(consumer)), thread_id_(thread_id), size_(size)
+{
+}
+
+CMemoryGovernor::Reservation::~Reservation()
+{
+    this->Release();
+}
+
+CMemoryGovernor::Reservation::Reservation(Reservation&& other) noexcept
+    : governor_(other.governor_), consumer_(std::move(other.consumer_)), thread_id_(other.thread_id_), size_(other.size_)
+{
+    other.governor_ = nullptr;
+    other.size_ = 0;
+}
+
+CMemoryGovernor::Reservation& CMemoryGovernor::Reservation::operator=(Reservation&& other) noexcept
+{
+    if (this != &other)
+    {
+        this->Release();
+        this->governor_ = other.governor_;
+        this->consumer_ = std::move(other.consumer_);
+        this->thread_id_ = other.thread_id_;
+        this->size_ = other.size_;
+        other.governor_ = nullptr;
+        other.size_ = 0;
+    }
+
+    return *this;
+}
+
+void CMemoryGovernor::Reservation::Release()
+{
+    if (this->governor_ != nullptr)
+    {
+        this->governor_->Return(this->consumer_, this->thread_id_, this->size_);
+        this->governor_ = nullptr;
+        this->size_ = 0;
+    }
+}
+
+CMemoryGovernor::CMemoryGovernor(std::uint64_t budget)
+    : budget_(budget)
+{
+}
+
+bool CMemoryGovernor::TryReserve(const std::string& consumer, std::uint64_t size, Reservation& reservation)
+{
+    {
+        lock_guard<mutex> lock(this->mutex_);
+        if (!this->CanGrant(size))
+        {
+            this->Deny(consumer);
+            return false;
+        }
+
+        this->Grant(consumer, this_thread::get_id(), size);
+    }
+
+    reservation = Reservation(this, consumer, this_thread::get_id(), size);
+    return true;
+}
+
+bool CMemoryGovernor::Reserve(const std::string& consumer, std::uint64_t size, Reservation& reservation)
+{
+    {
+        unique_lock<mutex> lock(this->mutex_);
+        for (;;)
+        {
+            if (this->CanGrant(size))
+            {
+                break;
+            }
+
+            // if the request cannot be granted even after all other threads (which are not blocked) have returned their
+            //  memory, waiting would not help (and would wait forever if there are no other threads)
+            uint64_t not_returned = 0;
+            for (const auto& item : this->in_use_per_thread_)
+            {
+                if (item.first == this_thread::get_id() || this->blocked_threads_.count(item.first) > 0)
+                {
+                    not_returned += item.second;
+                }
+            }
+
+            if (not_returned > this->budget_ || size > this->budget_ - not_returned ||
+                not_returned == this->total_in_use_)
+            {
+                this->Deny(consumer);
+                return false;
+            }
+
+            this->memory_released_.wait(lock);
+        }
+
+        this->Grant(consumer, this_thread::get_id(), size);
+    }
+
+    reservation = Reservation(this, consumer, this_thread::get_id(), size);
+    return true;
+}
+
+bool CMemoryGovernor::TryExtend(const std::string& consumer, std::uint64_t additional_size, Reservation& reservation)
+{
+    if (reservation.governor_ == nullptr)
+    {
+        return this->TryReserve(consumer, additional_size, reservation);
+    }
+
+    lock_guard<mutex> lock(this->mutex_);
+    if (!this->CanGrant(additional_size))
+    {
+        this->Deny(consumer);
+        return false;
+    }
+
+    this->Grant(reservation.consumer_, reservation.thread_id_, additional_size);
+    reservation.size_ += additional_size;
+    return true;
+}
+
+std::uint64_t CMemoryGovernor::ReserveUpTo(const std::string& consumer, std::uint64_t size, std::uint64_t minimum, Reservation& reservation)
+{
+    uint64_t granted_size = size;
+    {
+        lock_guard<mutex> lock(this->mutex_);
+        if (this->IsLimited())
+        {
+            const uint64_t available = this->budget_ - min(this->total_in_use_, this->budget_);
+            if (available < size)
+            {
+                // even if the minimum can be granted, the consumer has to degrade - so we count this as "denied"
+                this->Deny(consumer);
+                granted_size = available >= minimum ? available : 0;
+            }
+        }
+
+        this->Grant(consumer, this_thread::get_id(), granted_size);
+    }
+
+    reservation = Reservation(this, consumer, this_thread::get_id(), granted_size);
+    return granted_size;
+}
+
+void CMemoryGovernor::SetThreadBlocked(bool blocked)
+{
+    {
+        lock_guard<mutex> lock(this->mutex_);
+        if (blocked)
+        {
+            this->blocked_threads_.insert(this_thread::get_id());
+        }
+        else
+        {
+            this->blocked_threads_.erase(this_thread::get_id());
+        }
+    }
+
+    // threads waiting in 'Reserve' have to re-evaluate whether waiting can help
+    this->memory_released_.notify_all();
+}
+
+CMemoryGovernor::Usage CMemoryGovernor::GetUsage(const std::string& consumer) const
+{
+    lock_guard<mutex> lock(this->mutex_);
+    const auto iterator = this->usage_per_consumer_.find(consumer);
+    if (iterator != this->usage_per_consumer_.cend())
+    {
+        return iterator->second;
+    }
+
+    Usage usage;
+    usage.consumer = consumer;
+    return usage;
+}
+
+std::vector<CMemoryGovernor::Usage> CMemoryGovernor::GetUsage() const
+{
+    lock_guard<mutex> lock(this->mutex_);
+    vector<Usage> usage;
+    usage.reserve(this->usage_per_consumer_.size());
+    for (const auto& item : this->usage_per_consumer_)
+    {
+        usage.push_back(item.second);
+    }
+
+    return usage;
+}
+
+std::uint64_t CMemoryGovernor::GetTotalInUse() const
+{
+    lock_guard<mutex> lock(this->mutex_);
+    return this->total_in_use_;
+}
+
+std::uint64_t CMemoryGovernor::GetTotalHighWaterMark() const
+{
+    lock_guard<mutex> lock(this->mutex_);
+    return this->total_high_water_mark_;
+}
+
+/*static*/std::string CMemoryGovernor::FormatSize(std::uint64_t size)
+{
+    static const char* const kUnits[] = { "bytes", "KiB", "MiB", "GiB", "TiB" };
+    stringstream ss;
+    if (size < 1024)
+    {
+        ss << size << " " << kUnits[0];
+        return ss.str();
+    }
+
+    double value = static_cast<double>(size);
+    size_t unit = 0;
+    while (value >= 1024 && unit + 1 < sizeof(kUnits) / sizeof(kUnits[0]))
+    {
+        value /= 1024;
+        ++unit;
+    }
+
+    ss << fixed << setprecision(1) << value << " " << kUnits[unit];
+    return ss.str();
+}
+
+bool CMemoryGovernor::CanGrant(std::uint64_t size) const
+{
+    return !this->IsLimited() || (this->total_in_use_ <= this->budget_ && size <= this->budget_ - this->total_in_use_);
+}
+
+void CMemoryGovernor::Grant(const std::string& consumer, std::thread::id thread_id, std::uint64_t size)
+{
+    this->in_use_per_thread_[thread_id] += size;
+    auto& usage = this->usage_per_consumer_[consumer];
+    usage.consumer = consumer;
+    usage.current += size;
+    usage.highWaterMark = max(usage.highWaterMark, usage.current);
+    this->total_in_use_ += size;
+    this->total_high_water_mark_ = max(this->total_high_water_mark_, this->total_in_use_);
+}
+
+void CMemoryGovernor::Deny(const std::string& consumer)
+{
+    auto& usage = this->usage_per_consumer_[consumer];
+    usage.consumer = consumer;
+    ++usage.deniedRequests;
+}
+
+void CMemoryGovernor::Return(const std::string& consumer, std::thread::id thread_id, std::uint64_t size)
+{
+    {
+        lock_guard<mutex> lock(this->mutex_);
+        const auto iterator = this->in_use_per_thread_.find(thread_id);
+        if (iterator != this->in_use_per_thread_.end())
+        {
+            iterator->second -= min(iterator->second, size);
+            if (iterator->second == 0)
+            {
+                this->in_use_per_thread_.erase(iterator);
+            }
+        }
+
+        auto& usage = this->usage_per_consumer_[consumer];
+        usage.current -= min(usage.current, size);
+        this->total_in_use_ -= min(this->total_in_use_, size);
+    }
+
+    this->memory_released_.notify_all();
+}
@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// A process-wide budget for the memory used by the "big consumers" (i.e. decode buffers, snapshots of the
+/// subblock-directory and the document built by a result gatherer). Before allocating a large amount of memory, a
+/// consumer asks the governor for a reservation, and it returns it when the memory is freed. If the budget does not
+/// allow for the reservation, the consumer is expected to either wait (if other consumers are expected to return
+/// memory), to degrade (e.g. switch to streaming or skip optional data) or to report a finding - instead of
+/// running into an out-of-memory condition.
+/// The usage is tracked per consumer (identified by a name, for checkers the name of the check is used), and the
+/// high-water marks are recorded. The class is thread-safe.
+class CMemoryGovernor
+{
+public:
+    /// The usage of memory by a consumer.
+    struct Usage
+    {
+        std::string consumer;               ///< The name of the consumer.
+        std::uint64_t current{ 0 };         ///< The amount of memory currently reserved (in bytes).
+        std::uint64_t highWaterMark{ 0 };   ///< The maximum amount of memory reserved at any time (in bytes).
+        std::uint64_t deniedRequests{ 0 };  ///< The number of requests which could not be granted.
+    };
+
+    /// A reservation of memory - the memory is returned to the governor when the object is destroyed (or when
+    /// 'Release' is called).
+    class Reservation
+    {
+    private:
+        CMemoryGovernor* governor_{ nullptr };
+        std::string consumer_;
+        std::thread::id thread_id_;
+        std::uint64_t size_{ 0 };
+    public:
+        Reservation() = default;
+        Reservation(CMemoryGovernor* governor, std::string consumer, std::thread::id thread_id, std::uint64_t size);
+        ~Reservation();
+        Reservation(const Reservation&) = delete;
+        Reservation& operator=(const Reservation&) = delete;
+        Reservation(Reservation&& other) noexcept;
+        Reservation& operator=(Reservation&& other) noexcept;
+
+        /// Gets the size of the reservation in bytes.
+        [[nodiscard]] std::uint64_t GetSize() const { return this->size_; }
+
+        /// Returns the memory to the governor.
+        void Release();
+
+        friend class CMemoryGovernor;
+    };
+private:
+    std::uint64_t budget_;
+    mutable std::mutex mutex_;
+    std::condition_variable memory_released_;
+    std::uint64_t total_in_use_{ 0 };
+    std::uint64_t total_high_water_mark_{ 0 };
+    std::map<std::string, Usage> usage_per_consumer_;
+    std::map<std::thread::id, std::uint64_t> in_use_per_thread_;
+    std::set<std::thread::id> blocked_threads_;
+public:
+    /// Constructor.
+    ///
+    /// \param  budget  The budget in bytes, 0 meaning "no limit" (in which case all requests are granted, but the
+    ///                 usage is still tracked).
+    explicit CMemoryGovernor(std::uint64_t budget);
+
+    /// Gets the budget in bytes (0 meaning "no limit").
+    [[nodiscard]] std::uint64_t GetBudget() const { return this->budget_; }
+
+    /// Gets a boolean indicating whether there is a limit on the memory.
+    [[nodiscard]] bool IsLimited() const { return this->budget_ != 0; }
+
+    /// Attempts to reserve the specified amount of memory, without waiting.
+    ///
+    /// \param          consumer    The name of the consumer.
+    /// \param          size        The size in bytes.
+    /// \param [out]    reservation If successful, the reservation is put here.
+    ///
+    /// \returns    True if it succeeds; false if the budget does not allow for the reservation at this point.
+    bool TryReserve(const std::string& consumer, std::uint64_t size, Reservation& reservation);
+
+    /// Reserves the specified amount of memory, waiting for other threads to return memory if necessary. The method
+    /// only waits if the request can be granted once the other threads have returned their memory - i.e. memory held
+    /// by the calling thread itself (and by threads marked as blocked) is not waited for.
+    ///
+    /// \param          consumer    The name of the consumer.
+    /// \param          size        The size in bytes.
+    /// \param [out]    reservation If successful, the reservation is put here.
+    ///
+    /// \returns    True if it succeeds; false if the request cannot be granted (even if other threads return their memory).
+    bool Reserve(const std::string& consumer, std::uint64_t size, Reservation& reservation);
+
+    /// Attempts to extend an existing reservation by the specified amount of memory, without waiting. If the
+    /// reservation is empty (i.e. default-constructed), a new reservation for the consumer is made.
+    ///
+    /// \param          consumer        The name of the consumer.
+    /// \param          additional_size The additional size in bytes.
+    /// \param [in,out] reservation     The reservation to be extended.
+    ///
+    /// \returns    True if it succeeds; false if the budget does not allow for the extension at this point (in which
+    ///             case the reservation is unchanged).
+    bool TryExtend(const std::string& consumer, std::uint64_t additional_size, Reservation& reservation);
+
+    /// Reserves as much memory as is currently available, up to the specified amount - which allows a consumer to
+    /// degrade gracefully (e.g. by spilling data to disk). If less than the minimum is available, nothing is
+    /// reserved.
+    ///
+    /// \param          consumer    The name of the consumer.
+    /// \param          size        The desired size in bytes.
+    /// \param          minimum     The minimum size in bytes.
+    /// \param [out]    reservation The reservation is put here (its size may be zero).
+    ///
+    /// \returns    The size of the reservation in bytes.
+    std::uint64_t ReserveUpTo(const std::string& consumer, std::uint64_t size, std::uint64_t minimum, Reservation& reservation);
+
+    /// Marks the calling thread as blocked (i.e. waiting for another thread to make progress), or clears this mark.
+    /// While a thread is marked as blocked, other threads do not wait in 'Reserve' for the memory held by it - since
+    /// this memory is not returned before the other threads make progress, waiting for it would deadlock.
+    ///
+    /// \param  blocked True to mark the calling thread as blocked; false to clear the mark.
+    void SetThreadBlocked(bool blocked);
+
+    /// Gets the usage of the specified consumer. If the consumer is not known, a zero-initialized usage is returned.
+    ///
+    /// \param  consumer    The name of the consumer.
+    ///
+    /// \returns    The usage.
+    [[nodiscard]] Usage GetUsage(const std::string& consumer) const;
+
+    /// Gets the usage of all consumers (sorted by the name of the consumer).
+    [[nodiscard]] std::vector<Usage> GetUsage() const;
+
+    /// Gets the total amount of memory currently reserved, in bytes.
+    [[nodiscard]] std::uint64_t GetTotalInUse() const;
+
+    /// Gets the maximum amount of memory reserved in total at any time, in bytes.
+    [[nodiscard]] std::uint64_t GetTotalHighWaterMark() const;
+
+    /// Formats a size in bytes as a human-readable string (e.g. "12.5 MiB").
+    ///
+    /// \param  size    The size in bytes.
+    ///
+    /// \returns    The formatted string.
+    static std::string FormatSize(std::uint64_t size);
+private:
+    bool CanGrant(std::uint64_t size) const;
+    void Grant(const std::string& consumer, std::thread::id thread_id, std::uint64_t size);
+    void Deny(const std::string& consumer);
+    void Return(const std::string& consumer, std::thread::id thread_id, std::uint64_t size);
+};
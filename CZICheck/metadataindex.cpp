@@ -0,0 +1,291 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "metadataindex.h"
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+using namespace libCZI;
+
+namespace
+{
+    /// The name of the consumer (for the memory governor).
+    constexpr const char* kMemoryConsumerName = "metadata index";
+
+    /// The memory used by the parsed document and the index is estimated as this factor times the size of the XML (the
+    /// document keeps a copy of the text, and there are the nodes of the document, the entries of the index and the paths).
+    constexpr uint64_t kEstimatedMemoryPerByteOfXml = 4 * sizeof(CMetadataIndex::CharType);
+}
+
+/*static*/std::shared_ptr<const CMetadataIndex> CMetadataIndex::Create(const std::shared_ptr<libCZI::ICZIReader>& reader, const std::shared_ptr<CMemoryGovernor>& memory_governor)
+{
+    shared_ptr<IMetadataSegment> metadata_segment;
+    try
+    {
+        metadata_segment = reader->ReadMetadataSegment();
+    }
+    catch (exception& ex)
+    {
+        shared_ptr<CMetadataIndex> index(new CMetadataIndex());
+        index->status_ = Status::CouldNotReadSegment;
+        index->error_details_ = ex.what();
+        return index;
+    }
+
+    if (!metadata_segment)
+    {
+        shared_ptr<CMetadataIndex> index(new CMetadataIndex());
+        index->status_ = Status::NoMetadataSegment;
+        return index;
+    }
+
+    try
+    {
+        // the XML is parsed directly from the buffer of the metadata-segment (which is kept alive until the parsing is done)
+        const void* xml_data = nullptr;
+        uint64_t xml_size = 0;
+        metadata_segment->DangerousGetRawData(IMetadataSegment::MemBlkType::XmlMetadata, xml_data, xml_size);
+        if (xml_size > (numeric_limits<size_t>::max)())
+        {
+            throw runtime_error("the size of the XML-metadata is too large");
+        }
+
+        // the memory is reserved before parsing - without waiting, since the memory held by other threads may only be
+        //  returned after the metadata-checkers have finished
+        CMemoryGovernor::Reservation reservation;
+        const uint64_t memory_required = xml_size * kEstimatedMemoryPerByteOfXml;
+        if (memory_governor && !memory_governor->TryReserve(kMemoryConsumerName, memory_required, reservation))
+        {
+            shared_ptr<CMetadataIndex> index(new CMetadataIndex());
+            index->status_ = Status::ExceedsMemoryBudget;
+            index->error_details_ = "memory required (estimated): " + CMemoryGovernor::FormatSize(memory_required) +
+                ", memory budget: " + CMemoryGovernor::FormatSize(memory_governor->GetBudget());
+            return index;
+        }
+
+        auto index = CMetadataIndex::Create(xml_data, static_cast<size_t>(xml_size));
+        const_pointer_cast<CMetadataIndex>(index)->reservation_ = std::move(reservation);
+        return index;
+    }
+    catch (exception& ex)
+    {
+        shared_ptr<CMetadataIndex> index(new CMetadataIndex());
+        index->status_ = Status::InvalidSegment;
+        index->error_details_ = ex.what();
+        return index;
+    }
+}
+
+/*static*/std::shared_ptr<const CMetadataIndex> CMetadataIndex::Create(const void* xml_data, std::size_t size)
+{
+    shared_ptr<CMetadataIndex> index(new CMetadataIndex());
+    const pugi::xml_parse_result parse_result = index->document_.load_buffer(
+        xml_data != nullptr ? xml_data : "",
+        xml_data != nullptr ? size : 0,
+        pugi::parse_default,
+        pugi::encoding_utf8);
+    if (!parse_result)
+    {
+        index->status_ = Status::NotWellFormed;
+        index->error_details_ = parse_result.description();
+        return index;
+    }
+
+    index->BuildIndex();
+    return index;
+}
+
+void CMetadataIndex::BuildIndex()
+{
+    // the elements are visited in document order (i.e. depth-first, pre-order) - with an explicit stack, so that the
+    //  depth of the document is not limited by the size of the call stack
+    struct Frame
+    {
+        uint32_t entry;
+        size_t path_length;
+        pugi::xml_node next_child;
+    };
+
+    vector<Frame> stack;
+    basic_string<CharType> path;
+    const auto enter_element = [&](const pugi::xml_node& element)
+        {
+            const auto entry = static_cast<uint32_t>(this->entries_.size());
+            const size_t path_length = path.size();
+            if (!path.empty())
+            {
+                path.push_back(static_cast<CharType>('/'));
+            }
+
+            path.append(element.name());
+            this->entries_.push_back(Entry{ element, 0 });
+            this->entries_by_path_[path].push_back(entry);
+            this->entries_by_name_[element.name()].push_back(entry);
+            this->entry_index_by_node_[element.internal_object()] = entry;
+            stack.push_back(Frame{ entry, path_length, element.first_child() });
+        };
+
+    for (pugi::xml_node node = this->document_.first_child(); node; node = node.next_sibling())
+    {
+        if (node.type() != pugi::node_element)
+        {
+            continue;
+        }
+
+        enter_element(node);
+        while (!stack.empty())
+        {
+            const pugi::xml_node child = stack.back().next_child;
+            if (!child)
+            {
+                this->entries_[stack.back().entry].subtreeEnd = static_cast<uint32_t>(this->entries_.size());
+                path.resize(stack.back().path_length);
+                stack.pop_back();
+                continue;
+            }
+
+            stack.back().next_child = child.next_sibling();
+            if (child.type() == pugi::node_element)
+            {
+                enter_element(child);
+            }
+        }
+    }
+}
+
+std::vector<pugi::xml_node> CMetadataIndex::GetNodes(StringView path) const
+{
+    vector<pugi::xml_node> nodes;
+    const auto iterator = this->entries_by_path_.find(basic_string<CharType>(path));
+    if (iterator != this->entries_by_path_.cend())
+    {
+        nodes.reserve(iterator->second.size());
+        for (const auto entry : iterator->second)
+        {
+            nodes.push_back(this->entries_[entry].node);
+        }
+    }
+
+    return nodes;
+}
+
+pugi::xml_node CMetadataIndex::GetNode(StringView path) const
+{
+    const auto iterator = this->entries_by_path_.find(basic_string<CharType>(path));
+    if (iterator != this->entries_by_path_.cend() && !iterator->second.empty())
+    {
+        return this->entries_[iterator->second.front()].node;
+    }
+
+    return {};
+}
+
+void CMetadataIndex::EnumerateDescendants(const pugi::xml_node& node, StringView name, const std::function<bool(const pugi::xml_node&)>& func) const
+{
+    const uint32_t entry = this->GetEntryIndex(node);
+    const auto iterator = this->entries_by_name_.find(basic_string<CharType>(name));
+    if (iterator == this->entries_by_name_.cend())
+    {
+        return;
+    }
+
+    // the entries for a name are in document order, and the descendants of the element are in the range (entry, subtreeEnd)
+    const auto& entries_with_name = iterator->second;
+    const uint32_t subtree_end = this->entries_[entry].subtreeEnd;
+    for (auto it = upper_bound(entries_with_name.cbegin(), entries_with_name.cend(), entry); it != entries_with_name.cend() && *it < subtree_end; ++it)
+    {
+        if (!func(this->entries_[*it].node))
+        {
+            break;
+        }
+    }
+}
+
+/*static*/CMetadataIndex::StringView CMetadataIndex::GetAttributeValue(const pugi::xml_node& node, const CharType* name)
+{
+    return node.attribute(name).value();
+}
+
+/*static*/bool CMetadataIndex::TryParseInt(StringView text, int* value)
+{
+    size_t position = 0;
+    while (position < text.size() &&
+        (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r' || text[position] == '\v' || text[position] == '\f'))
+    {
+        ++position;
+    }
+
+    bool is_negative = false;
+    if (position < text.size() && (text[position] == '-' || text[position] == '+'))
+    {
+        is_negative = text[position] == '-';
+        ++position;
+    }
+
+    if (position >= text.size() || text[position] < '0' || text[position] > '9')
+    {
+        return false;
+    }
+
+    const int64_t limit = static_cast<int64_t>((numeric_limits<int>::max)()) + (is_negative ? 1 : 0);
+    int64_t number = 0;
+    for (; position < text.size() && text[position] >= '0' && text[position] <= '9'; ++position)
+    {
+        number = number * 10 + (text[position] - '0');
+        if (number > limit)
+        {
+            return false;
+        }
+    }
+
+    if (value != nullptr)
+    {
+        *value = static_cast<int>(is_negative ? -number : number);
+    }
+
+    return true;
+}
+
+std::uint32_t CMetadataIndex::GetEntryIndex(const pugi::xml_node& node) const
+{
+    const auto iterator = this->entry_index_by_node_.find(node.internal_object());
+    if (iterator == this->entry_index_by_node_.cend())
+    {
+        throw invalid_argument("the node is not an element of the indexed document");
+    }
+
+    return iterator->second;
+}
+
+CMetadataIndexCache::CMetadataIndexCache(std::shared_ptr<CMemoryGovernor> memory_governor)
+    : memory_governor_(std::move(memory_governor))
+{
+}
+
+std::shared_ptr<const CMetadataIndex> CMetadataIndexCache::Get(const std::shared_ptr<libCZI::ICZIReader>& reader)
+{
+    lock_guard<mutex> lock(this->mutex_);
+    if (this->released_)
+    {
+        return CMetadataIndex::Create(reader, this->memory_governor_);
+    }
+
+    if (!this->index_)
+    {
+        this->index_ = CMetadataIndex::Create(reader, this->memory_governor_);
+    }
+
+    return this->index_;
+}
+
+void CMetadataIndexCache::Release()
+{
+    lock_guard<mutex> lock(this->mutex_);
+    this->index_.reset();
+    this->released_ = true;
+}
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "inc_libCZI.h"
+#include "memorygovernor.h"
+#include "pugixml.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// An index over the XML-metadata of a CZI-document, built with one pass over the document. The XML is parsed
+/// (with pugixml) from the buffer of the metadata-segment, and for every element its path (i.e. the names
+/// of the elements from the root, separated by '/' - e.g. "ImageDocument/Metadata/Information") and its name are
+/// recorded, together with the position of the element in document order. So, looking up elements by path, or
+/// finding the descendants of an element with a given name, does not require traversing the document again.
+/// Strings (element names and attribute values) are given as views into the parsed document, so querying the index
+/// requires no copies and no conversions (e.g. to wide strings).
+/// An instance is immutable after creation, and can therefore be used concurrently by multiple checkers. If a
+/// memory governor is given, the (estimated) memory for the parsed document and the index is reserved with it for
+/// the lifetime of the instance.
+class CMetadataIndex
+{
+public:
+    /// The character type used by pugixml (which depends on the pugixml-configuration).
+    using CharType = pugi::char_t;
+
+    /// A view of a string within the parsed document.
+    using StringView = std::basic_string_view<CharType>;
+
+    /// The outcome of reading and parsing the metadata-segment.
+    enum class Status : std::uint8_t
+    {
+        Ok,                     ///< The metadata-segment was read and parsed successfully.
+        NoMetadataSegment,      ///< The document does not contain a metadata-segment.
+        CouldNotReadSegment,    ///< The metadata-segment could not be read.
+        InvalidSegment,         ///< The content of the metadata-segment could not be accessed.
+        NotWellFormed,          ///< The XML-metadata is not well-formed.
+        ExceedsMemoryBudget,    ///< The memory required for the index exceeds the memory budget.
+    };
+private:
+    /// An element of the document - the position of the element in document order is the index of the entry,
+    /// and all descendants of the element are in the range (index, subtreeEnd).
+    struct Entry
+    {
+        pugi::xml_node node;
+        std::uint32_t subtreeEnd{ 0 };
+    };
+
+    Status status_{ Status::Ok };
+    std::string error_details_;
+    CMemoryGovernor::Reservation reservation_;
+    pugi::xml_document document_;
+    std::vector<Entry> entries_;
+    std::unordered_map<std::basic_string<CharType>, std::vector<std::uint32_t>> entries_by_path_;
+    std::unordered_map<std::basic_string<CharType>, std::vector<std::uint32_t>> entries_by_name_;
+    std::unordered_map<const pugi::xml_node_struct*, std::uint32_t> entry_index_by_node_;
+public:
+    /// Reads the metadata-segment of the specified document and creates the index for it. This method does not
+    /// throw an exception if the metadata-segment cannot be read or parsed (or if the memory governor does not grant
+    /// the memory for it), instead the status of the returned object indicates the problem.
+    ///
+    /// \param  reader          The CZI-reader object.
+    /// \param  memory_governor The memory governor (may be null).
+    ///
+    /// \returns    The newly created index.
+    static std::shared_ptr<const CMetadataIndex> Create(const std::shared_ptr<libCZI::ICZIReader>& reader, const std::shared_ptr<CMemoryGovernor>& memory_governor = nullptr);
+
+    /// Creates the index for the specified XML-metadata (given as UTF-8).
+    ///
+    /// \param  xml_data    The XML-metadata.
+    /// \param  size        The size of the XML-metadata in bytes.
+    ///
+    /// \returns    The newly created index.
+    static std::shared_ptr<const CMetadataIndex> Create(const void* xml_data, std::size_t size);
+
+    /// Gets the outcome of reading and parsing the metadata-segment. Only if this is "Ok", the index can be queried.
+    [[nodiscard]] Status GetStatus() const { return this->status_; }
+
+    /// Gets a description of the problem if the status is not "Ok".
+    [[nodiscard]] const std::string& GetErrorDetails() const { return this->error_details_; }
+
+    /// Gets the number of elements in the document.
+    [[nodiscard]] std::size_t GetElementCount() const { return this->entries_.size(); }
+
+    /// Gets all elements with the specified path (in document order).
+    ///
+    /// \param  path    The path of the element, e.g. "ImageDocument/Metadata/Information/Image".
+    ///
+    /// \returns    The elements (the vector is empty if there is no element with this path).
+    [[nodiscard]] std::vector<pugi::xml_node> GetNodes(StringView path) const;
+
+    /// Gets the first element (in document order) with the specified path.
+    ///
+    /// \param  path    The path of the element, e.g. "ImageDocument/Metadata/Information/Image".
+    ///
+    /// \returns    The element, or an empty node if there is no element with this path.
+    [[nodiscard]] pugi::xml_node GetNode(StringView path) const;
+
+    /// Enumerates the descendants of the specified element which have the specified name (in document order).
+    ///
+    /// \param  node    The element (which must be part of this document).
+    /// \param  name    The name of the descendants to enumerate.
+    /// \param  func    Functor which is called for each descendant. If it returns false, the enumeration is cancelled.
+    void EnumerateDescendants(const pugi::xml_node& node, StringView name, const std::function<bool(const pugi::xml_node&)>& func) const;
+
+    /// Gets the value of the specified attribute of an element.
+    ///
+    /// \param  node    The element.
+    /// \param  name    The name of the attribute.
+    ///
+    /// \returns    The value of the attribute (empty if the attribute is not present).
+    static StringView GetAttributeValue(const pugi::xml_node& node, const CharType* name);
+
+    /// Attempts to parse an integer from the specified text. As with "std::stoi", leading whitespace is skipped and
+    /// characters following the number are ignored.
+    ///
+    /// \param          text    The text.
+    /// \param [out]    value   If non-null and successful, the value is put here.
+    ///
+    /// \returns    True if it succeeds; false if the text does not start with a number or the number is out of range.
+    static bool TryParseInt(StringView text, int* value);
+private:
+    CMetadataIndex() = default;
+    void BuildIndex();
+    [[nodiscard]] std::uint32_t GetEntryIndex(const pugi::xml_node& node) const;
+};
+
+/// This class creates the index for the XML-metadata of a document on first use, and then hands out the same
+/// (immutable) index to all checkers - so that the metadata-segment is read and parsed only once. Once the last
+/// checker using the index has run, the cache is to be released, so that the memory is freed. The class is
+/// thread-safe.
+class CMetadataIndexCache
+{
+private:
+    std::mutex mutex_;
+    std::shared_ptr<CMemoryGovernor> memory_governor_;
+    std::shared_ptr<const CMetadataIndex> index_;
+    bool released_{ false };
+public:
+    /// Constructor.
+    ///
+    /// \param  memory_governor The memory governor with which the memory for the index is reserved (may be null).
+    explicit CMetadataIndexCache(std::shared_ptr<CMemoryGovernor> memory_governor);
+
+    /// Gets the index for the XML-metadata of the specified document, creating it if necessary. Note that the
+    /// cache is only to be used with one document. If the cache has been released already, the index is created
+    /// again (and not kept).
+    ///
+    /// \param  reader  The CZI-reader object.
+    ///
+    /// \returns    The index.
+    std::shared_ptr<const CMetadataIndex> Get(const std::shared_ptr<libCZI::ICZIReader>& reader);
+
+    /// Releases the index kept by the cache - the memory is freed once no checker is using the index any more.
+    void Release();
+};
@@ -9,6 +9,7 @@
 #include "cmdlineoptions.h"
 #include <ostream>
 #include <sstream>
+#include <iomanip>
 #include <algorithm>
 
 using namespace std;
@@ -64,6 +65,71 @@ void CResultGatherer::FinishCheck(CZIChecks check)
         this->GetLog()->WriteStdOut(" FAIL\n");
         this->GetLog()->SetColor(ConsoleColor::DEFAULT, ConsoleColor::DEFAULT);
     }
+
+    for (const auto& statistics : this->statistics_of_current_checker_)
+    {
+        this->PrintStatisticsTable(statistics);
+    }
+
+    this->statistics_of_current_checker_.clear();
+}
+
+void CResultGatherer::ReportStatistics(const StatisticsTable& statistics)
+{
+    this->CoreReportStatistics(statistics);
+
+    // the statistics are printed after the result of the check, so we store them until "FinishCheck" is called
+    this->statistics_of_current_checker_.push_back(statistics);
+}
+
+void CResultGatherer::PrintStatisticsTable(const StatisticsTable& statistics)
+{
+    // convert all cells to strings first, so that we can determine the width of the columns
+    vector<vector<string>> cells;
+    vector<size_t> column_widths;
+    column_widths.reserve(statistics.columns.size());
+    for (const auto& column : statistics.columns)
+    {
+        column_widths.push_back(column.size());
+    }
+
+    cells.reserve(statistics.rows.size());
+    for (const auto& row : statistics.rows)
+    {
+        vector<string> row_cells;
+        row_cells.reserve(row.size());
+        for (size_t i = 0; i < row.size(); ++i)
+        {
+            row_cells.emplace_back(ResultGathererBase::StatisticsValueToString(row[i]));
+            column_widths[i] = max(column_widths[i], row_cells.back().size());
+        }
+
+        cells.emplace_back(std::move(row_cells));
+    }
+
+    ostringstream ss;
+    ss << "  statistics: " << statistics.name << "\n";
+    ss << "   ";
+    for (size_t i = 0; i < statistics.columns.size(); ++i)
+    {
+        ss << ' ' << left << setw(static_cast<int>(column_widths[i])) << statistics.columns[i];
+    }
+
+    ss << "\n";
+    for (size_t r = 0; r < cells.size(); ++r)
+    {
+        ss << "   ";
+        for (size_t i = 0; i < cells[r].size(); ++i)
+        {
+            // strings are left-aligned, numbers are right-aligned
+            const bool is_string = holds_alternative<string>(statistics.rows[r][i]);
+            ss << ' ' << (is_string ? left : right) << setw(static_cast<int>(column_widths[i])) << cells[r][i];
+        }
+
+        ss << "\n";
+    }
+
+    this->GetLog()->WriteStdOut(ss.str());
 }
 
 CResultGatherer::ReportFindingResult CResultGatherer::ReportFinding(const Finding& finding)
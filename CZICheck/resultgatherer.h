@@ -8,6 +8,7 @@
 #include "checks.h"
 #include "IResultGatherer.h"
 #include "resultgathererbase.h"
+#include <vector>
 
 /// This class is intended to receive the findings from the individual checks. It is 
 /// responsible for outputting them, and aggregating an overall result.
@@ -19,12 +20,17 @@
 /// Deviating from this semantic results in undefined behavior.
 class CResultGatherer : public IResultGatherer, ResultGathererBase
 {
+private:
+    std::vector<StatisticsTable> statistics_of_current_checker_;
 public:
     explicit CResultGatherer(const CCmdLineOptions& options);
     void StartCheck(CZIChecks check) override;
     ReportFindingResult ReportFinding(const Finding& finding) override;
+    void ReportStatistics(const StatisticsTable& statistics) override;
     void FinishCheck(CZIChecks check) override;
 
     void FinalizeChecks() override;
     CheckResult GetAggregatedCounts() const  override;
+private:
+    void PrintStatisticsTable(const StatisticsTable& statistics);
 };
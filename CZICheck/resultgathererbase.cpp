@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: MIT
 
 #include "resultgathererbase.h"
+#include <iomanip>
+#include <sstream>
 
 ResultGathererBase::ResultGathererBase(const CCmdLineOptions& options)
     : options_(options)
@@ -68,6 +70,27 @@ void ResultGathererBase::CoreReportFinding(const IResultGatherer::Finding& findi
     }
 }
 
+void ResultGathererBase::CoreReportStatistics(const IResultGatherer::StatisticsTable& statistics) const
+{
+    if (!this->current_checker_.has_value())
+    {
+        throw std::runtime_error("No currently active checker.");
+    }
+
+    if (statistics.check != this->current_checker_.value())
+    {
+        throw std::runtime_error("The statistics' check does not match the currently active checker.");
+    }
+
+    for (const auto& row : statistics.rows)
+    {
+        if (row.size() != statistics.columns.size())
+        {
+            throw std::runtime_error("The number of cells in a row of the statistics table does not match the number of columns.");
+        }
+    }
+}
+
 void ResultGathererBase::CoreFinishCheck(CZIChecks check)
 {
     this->current_checker_ = std::nullopt;
@@ -112,3 +135,23 @@ IResultGatherer::CheckResult ResultGathererBase::CoreGetAggregatedCounts() const
     default: return "UNKNOWN";
     }
 }
+
+/*static*/std::string ResultGathererBase::StatisticsValueToString(const IResultGathererReport::StatisticsValue& value)
+{
+    if (const auto string_value = std::get_if<std::string>(&value))
+    {
+        return *string_value;
+    }
+
+    std::ostringstream ss;
+    if (const auto integer_value = std::get_if<std::int64_t>(&value))
+    {
+        ss << *integer_value;
+    }
+    else
+    {
+        ss << std::fixed << std::setprecision(3) << std::get<double>(value);
+    }
+
+    return ss.str();
+}
@@ -23,6 +23,7 @@ public:
 protected:
     void CoreStartCheck(CZIChecks check);
     void CoreReportFinding(const IResultGatherer::Finding& finding);
+    void CoreReportStatistics(const IResultGatherer::StatisticsTable& statistics) const;
     void CoreFinishCheck(CZIChecks check);
 
     IResultGatherer::CheckResult CoreGetAggregatedCounts() const;
@@ -49,4 +50,13 @@ protected:
     /// \return A null-terminated string identifying the severity (e.g., "INFO", "WARNING", "FATAL");
     ///         the string has static storage duration and must not be freed.
     static const char* FindingSeverityToString(const IResultGathererReport::Finding& finding);
+
+    /// \brief Converts the value of a cell in a statistics table into a string.
+    ///
+    /// Integers are printed as is, floating point numbers are printed with fixed three decimal places.
+    ///
+    /// \param value The value to be converted.
+    ///
+    /// \return The string representation of the value.
+    static std::string StatisticsValueToString(const IResultGathererReport::StatisticsValue& value);
 };
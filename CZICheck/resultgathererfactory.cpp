@@ -9,16 +9,16 @@
 #include "resultgathererxml.h"
 
 
-std::unique_ptr<IResultGatherer> CreateResultGatherer(const CCmdLineOptions& options)
+std::unique_ptr<IResultGatherer> CreateResultGatherer(const CCmdLineOptions& options, const std::shared_ptr<CMemoryGovernor>& memory_governor)
 {
     switch (options.GetOutputEncodingFormat())
     {
         case CCmdLineOptions::OutputEncodingFormat::TEXT:
             return std::make_unique<CResultGatherer>(options);
         case CCmdLineOptions::OutputEncodingFormat::JSON:
-            return std::make_unique<CResultGathererJson>(options);
+            return std::make_unique<CResultGathererJson>(options, memory_governor);
         case CCmdLineOptions::OutputEncodingFormat::XML:
-            return std::make_unique<CResultGathererXml>(options);
+            return std::make_unique<CResultGathererXml>(options, memory_governor);
         default:
             throw std::invalid_argument("Unknown output encoding format");
     }
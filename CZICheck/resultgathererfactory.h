@@ -7,5 +7,13 @@
 #include <memory>
 #include "cmdlineoptions.h"
 #include "IResultGatherer.h"
+#include "memorygovernor.h"
 
-std::unique_ptr<IResultGatherer> CreateResultGatherer(const CCmdLineOptions& options);
+/// Creates the result gatherer for the output format given with the options.
+///
+/// \param  options         The options.
+/// \param  memory_governor The memory governor (may be null) - it is used by result gatherers which build a document
+///                         in memory.
+///
+/// \returns    The newly created result gatherer.
+std::unique_ptr<IResultGatherer> CreateResultGatherer(const CCmdLineOptions& options, const std::shared_ptr<CMemoryGovernor>& memory_governor);
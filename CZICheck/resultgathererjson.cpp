@@ -14,9 +14,11 @@
 #include <ostream>
 #include <string>
 #include <utility>
+#include <variant>
 
 using namespace std;
 
+const char* CResultGathererJson::kMemoryConsumerName = "result-gatherer";
 const char* CResultGathererJson::kTestNameId = "name";
 const char* CResultGathererJson::kTestContainerId = "tests";
 const char* CResultGathererJson::kTestDescriptionId = "description";
@@ -26,9 +28,12 @@ const char* CResultGathererJson::kTestSeverityId = "severity";
 const char* CResultGathererJson::kTestDetailsId = "details";
 const char* CResultGathererJson::kTestAggregationId = "aggregatedresult";
 const char* CResultGathererJson::kTestFailFastId = "fail_fast_stopped";
+const char* CResultGathererJson::kTestStatisticsId = "statistics";
+const char* CResultGathererJson::kTestStatisticsColumnsId = "columns";
+const char* CResultGathererJson::kTestStatisticsRowsId = "rows";
 
-CResultGathererJson::CResultGathererJson(const CCmdLineOptions& options)
-    : ResultGathererBase(options)
+CResultGathererJson::CResultGathererJson(const CCmdLineOptions& options, std::shared_ptr<CMemoryGovernor> memory_governor)
+    : ResultGathererBase(options), memory_governor_(std::move(memory_governor))
 {
     this->json_document_.SetArray();
     this->test_results_ = rapidjson::Value(rapidjson::kArrayType);
@@ -50,6 +55,8 @@ void CResultGathererJson::StartCheck(CZIChecks check)
 
     this->test_results_.PushBack(test_run, allocator);
     this->current_checker_id = std::string(CZIChecksToString(check));
+    this->findings_without_details_ = 0;
+    this->findings_omitted_ = 0;
 }
 
 void CResultGathererJson::FinishCheck(CZIChecks check)
@@ -62,6 +69,20 @@ void CResultGathererJson::FinishCheck(CZIChecks check)
     {
         if (this->test_results_[res][kTestNameId].GetString() == this->current_checker_id)
         {
+            // if findings had to be dropped because of the memory budget, this is noted with an additional finding
+            //  (which is not counted as a finding of the checker)
+            if (this->findings_without_details_ > 0 || this->findings_omitted_ > 0)
+            {
+                ostringstream ss;
+                ss << "Because the memory budget was exhausted, the details of " << this->findings_without_details_
+                    << " finding(s) were dropped and " << this->findings_omitted_ << " finding(s) were omitted.";
+                rapidjson::Value note(rapidjson::kObjectType);
+                note.AddMember(rapidjson::Value(kTestSeverityId, allocator), rapidjson::Value("INFO", allocator), allocator)
+                    .AddMember(rapidjson::Value(kTestDescriptionId, allocator), rapidjson::Value().SetString(ss.str().c_str(), allocator), allocator)
+                    .AddMember(rapidjson::Value(kTestDetailsId, allocator), rapidjson::Value(rapidjson::kStringType), allocator);
+                this->test_results_[res][kTestFindingsId].PushBack(note, allocator);
+            }
+
             ostringstream ss;
             if (current_checker_result.fatalMessagesCount == 0 && current_checker_result.warningMessagesCount == 0)
             {
@@ -90,11 +111,29 @@ IResultGatherer::ReportFindingResult CResultGathererJson::ReportFinding(const Fi
     {
         if (this->test_results_[res][kTestNameId].GetString() == this->current_checker_id)
         {
+            // the memory for the finding is reserved with the memory governor - if this is not possible, we first try
+            //  without the details, and if this is not possible either, the finding is omitted (it is counted nevertheless)
+            bool include_details = true;
+            if (this->memory_governor_)
+            {
+                if (!this->memory_governor_->TryExtend(kMemoryConsumerName, kEstimatedMemoryPerFinding + finding.information.size() + finding.details.size(), this->reservation_))
+                {
+                    if (!this->memory_governor_->TryExtend(kMemoryConsumerName, kEstimatedMemoryPerFinding + finding.information.size(), this->reservation_))
+                    {
+                        ++this->findings_omitted_;
+                        break;
+                    }
+
+                    include_details = false;
+                    ++this->findings_without_details_;
+                }
+            }
+
             rapidjson::Value current_finding(rapidjson::kObjectType);
             current_finding.SetObject()
                 .AddMember(rapidjson::Value(kTestSeverityId, allocator), rapidjson::Value().SetString(ResultGathererBase::FindingSeverityToString(finding), allocator), allocator)
                 .AddMember(rapidjson::Value(kTestDescriptionId, allocator), rapidjson::Value().SetString(finding.information.c_str(), allocator), allocator)
-                .AddMember(rapidjson::Value(kTestDetailsId, allocator), rapidjson::Value().SetString(finding.details.c_str(), allocator), allocator);
+                .AddMember(rapidjson::Value(kTestDetailsId, allocator), rapidjson::Value().SetString(include_details ? finding.details.c_str() : "", allocator), allocator);
             this->test_results_[res][kTestFindingsId].PushBack(current_finding, allocator);
         }
     }
@@ -102,6 +141,60 @@ IResultGatherer::ReportFindingResult CResultGathererJson::ReportFinding(const Fi
     return this->DetermineReportFindingResult(finding);
 }
 
+void CResultGathererJson::ReportStatistics(const StatisticsTable& statistics)
+{
+    this->CoreReportStatistics(statistics);
+
+    auto allocator = this->json_document_.GetAllocator();
+    for (int res { 0 }; res < this->test_results_.Size(); ++res)
+    {
+        if (this->test_results_[res][kTestNameId].GetString() == this->current_checker_id)
+        {
+            rapidjson::Value columns(rapidjson::kArrayType);
+            for (const auto& column : statistics.columns)
+            {
+                columns.PushBack(rapidjson::Value().SetString(column.c_str(), allocator), allocator);
+            }
+
+            rapidjson::Value rows(rapidjson::kArrayType);
+            for (const auto& row : statistics.rows)
+            {
+                rapidjson::Value cells(rapidjson::kArrayType);
+                for (const auto& cell : row)
+                {
+                    if (const auto string_value = get_if<string>(&cell))
+                    {
+                        cells.PushBack(rapidjson::Value().SetString(string_value->c_str(), allocator), allocator);
+                    }
+                    else if (const auto integer_value = get_if<int64_t>(&cell))
+                    {
+                        cells.PushBack(rapidjson::Value().SetInt64(*integer_value), allocator);
+                    }
+                    else
+                    {
+                        cells.PushBack(rapidjson::Value().SetDouble(get<double>(cell)), allocator);
+                    }
+                }
+
+                rows.PushBack(cells, allocator);
+            }
+
+            rapidjson::Value table(rapidjson::kObjectType);
+            table.AddMember(rapidjson::Value(kTestNameId, allocator), rapidjson::Value().SetString(statistics.name.c_str(), allocator), allocator)
+                .AddMember(rapidjson::Value(kTestStatisticsColumnsId, allocator), columns, allocator)
+                .AddMember(rapidjson::Value(kTestStatisticsRowsId, allocator), rows, allocator);
+
+            // the "statistics"-member is only added if there are statistics, so that the output is unchanged otherwise
+            if (!this->test_results_[res].HasMember(kTestStatisticsId))
+            {
+                this->test_results_[res].AddMember(rapidjson::Value(kTestStatisticsId, allocator), rapidjson::Value(rapidjson::kArrayType), allocator);
+            }
+
+            this->test_results_[res][kTestStatisticsId].PushBack(table, allocator);
+        }
+    }
+}
+
 void CResultGathererJson::FinalizeChecks()
 {
     this->json_document_.SetObject();
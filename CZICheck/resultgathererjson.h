@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include "IResultGatherer.h"
 #include "resultgathererbase.h"
 #include "cmdlineoptions.h"
 #include "checks.h"
+#include "memorygovernor.h"
 
 #include "rapidjson/document.h"
 
@@ -19,16 +22,34 @@ private:
     rapidjson::Value test_results_;
     std::string current_checker_id;
 
+    std::shared_ptr<CMemoryGovernor> memory_governor_;
+    CMemoryGovernor::Reservation reservation_;
+    std::uint32_t findings_without_details_{ 0 };   ///< The number of findings of the current checker stored without details.
+    std::uint32_t findings_omitted_{ 0 };           ///< The number of findings of the current checker not stored at all.
+
 public:
-    explicit CResultGathererJson(const CCmdLineOptions& options);
+    /// Constructor.
+    ///
+    /// \param  options         The options.
+    /// \param  memory_governor The memory governor, which the memory for the JSON-document is reserved with. If the
+    ///                         budget is exhausted, the details of findings are dropped first, then the findings
+    ///                         themselves (this is noted in the output). May be null.
+    CResultGathererJson(const CCmdLineOptions& options, std::shared_ptr<CMemoryGovernor> memory_governor);
     void StartCheck(CZIChecks check) override;
     ReportFindingResult ReportFinding(const Finding& finding) override;
+    void ReportStatistics(const StatisticsTable& statistics) override;
     void FinishCheck(CZIChecks check) override;
 
     void FinalizeChecks() override;
     CheckResult GetAggregatedCounts() const override;
 
 private:
+    /// The name under which the memory used for the JSON-document is tracked by the memory governor.
+    static const char* kMemoryConsumerName;
+
+    /// A rough estimate of the memory used for a finding in the JSON-document (in addition to its text).
+    static constexpr std::uint64_t kEstimatedMemoryPerFinding = 256;
+
     static const char* kTestNameId;
     static const char* kTestContainerId;
     static const char* kTestDescriptionId;
@@ -38,4 +59,7 @@ private:
     static const char* kTestDetailsId;
     static const char* kTestAggregationId;
     static const char* kTestFailFastId;
+    static const char* kTestStatisticsId;
+    static const char* kTestStatisticsColumnsId;
+    static const char* kTestStatisticsRowsId;
 };
@@ -10,9 +10,11 @@
 
 #include <sstream>
 #include <string>
+#include <utility>
 
 using namespace std;
 
+const char* CResultGathererXml::kMemoryConsumerName = "result-gatherer";
 const wchar_t* CResultGathererXml::kXmlVersionId = L"version";
 const wchar_t* CResultGathererXml::kXmlVersionNumber = L"1.0";
 const wchar_t* CResultGathererXml::kXmlEncodingId = L"encoding";
@@ -28,9 +30,14 @@ const wchar_t* CResultGathererXml::kTestFindingContainerId = L"Findings";
 const wchar_t* CResultGathererXml::kTestFindingId = L"Finding";
 const wchar_t* CResultGathererXml::kTestSeverityId = L"Severity";
 const wchar_t* CResultGathererXml::kTestDetailsId = L"Details";
-
-CResultGathererXml::CResultGathererXml(const CCmdLineOptions& options)
-    : ResultGathererBase(options)
+const wchar_t* CResultGathererXml::kTestStatisticsContainerId = L"Statistics";
+const wchar_t* CResultGathererXml::kTestStatisticsTableId = L"Table";
+const wchar_t* CResultGathererXml::kTestStatisticsRowId = L"Row";
+const wchar_t* CResultGathererXml::kTestStatisticsCellId = L"Cell";
+const wchar_t* CResultGathererXml::kTestStatisticsColumnId = L"Column";
+
+CResultGathererXml::CResultGathererXml(const CCmdLineOptions& options, std::shared_ptr<CMemoryGovernor> memory_governor)
+    : ResultGathererBase(options), memory_governor_(std::move(memory_governor))
 {
     auto decl = this->xml_document_.append_child(pugi::node_declaration);
     decl.append_attribute(kXmlVersionId) = kXmlVersionNumber;
@@ -52,6 +59,8 @@ void CResultGathererXml::StartCheck(CZIChecks check)
     finding_node.append_child(kTestFindingContainerId);
 
     this->current_checker_id_ = test_name;
+    this->findings_without_details_ = 0;
+    this->findings_omitted_ = 0;
 }
 
 void CResultGathererXml::FinishCheck(CZIChecks check)
@@ -64,6 +73,17 @@ void CResultGathererXml::FinishCheck(CZIChecks check)
         auto name_attr = current_test_node.attribute(kTestNameId);
         if (name_attr && name_attr.value() == current_checker)
         {
+            // if findings had to be dropped because of the memory budget, this is noted with an additional finding
+            //  (which is not counted as a finding of the checker)
+            if (this->findings_without_details_ > 0 || this->findings_omitted_ > 0)
+            {
+                ostringstream ss;
+                ss << "Because the memory budget was exhausted, the details of " << this->findings_without_details_
+                    << " finding(s) were dropped and " << this->findings_omitted_ << " finding(s) were omitted.";
+                auto findings_container = current_test_node.child(kTestFindingContainerId);
+                this->AddFinding(findings_container, "INFO", ss.str(), string());
+            }
+
             auto result_node = current_test_node.child(kTestResultId);
             ostringstream ss;
             if (current_checker_result.fatalMessagesCount == 0 && current_checker_result.warningMessagesCount == 0)
@@ -94,18 +114,30 @@ IResultGatherer::ReportFindingResult CResultGathererXml::ReportFinding(const Fin
         auto name_attr = current_test_node.attribute(kTestNameId);
         if (name_attr && name_attr.value() == current_checker)
         {
-            auto findings_container = current_test_node.child(kTestFindingContainerId);
+            // the memory for the finding is reserved with the memory governor - if this is not possible, we first try
+            //  without the details, and if this is not possible either, the finding is omitted (it is counted nevertheless)
+            bool include_details = true;
+            if (this->memory_governor_)
+            {
+                if (!this->memory_governor_->TryExtend(kMemoryConsumerName, kEstimatedMemoryPerFinding + (finding.information.size() + finding.details.size()) * sizeof(wchar_t), this->reservation_))
+                {
+                    if (!this->memory_governor_->TryExtend(kMemoryConsumerName, kEstimatedMemoryPerFinding + finding.information.size() * sizeof(wchar_t), this->reservation_))
+                    {
+                        ++this->findings_omitted_;
+                        break;
+                    }
+
+                    include_details = false;
+                    ++this->findings_without_details_;
+                }
+            }
 
-            auto current_finding = findings_container.append_child(kTestFindingId);
-            current_finding.append_child(kTestSeverityId)
-                .text()
-                .set(convertUtf8ToUCS2(ResultGathererBase::FindingSeverityToString(finding)).c_str());
-            current_finding.append_child(kTestDescriptionId)
-                .text()
-                .set(convertUtf8ToUCS2(finding.information).c_str());
-            current_finding.append_child(kTestDetailsId)
-                .text()
-                .set(convertUtf8ToUCS2(finding.details).c_str());
+            auto findings_container = current_test_node.child(kTestFindingContainerId);
+            this->AddFinding(
+                findings_container,
+                ResultGathererBase::FindingSeverityToString(finding),
+                finding.information,
+                include_details ? finding.details : string());
 
             break;
         }
@@ -114,6 +146,55 @@ IResultGatherer::ReportFindingResult CResultGathererXml::ReportFinding(const Fin
     return this->DetermineReportFindingResult(finding);
 }
 
+void CResultGathererXml::AddFinding(pugi::xml_node& findings_container, const char* severity, const std::string& information, const std::string& details)
+{
+    auto current_finding = findings_container.append_child(kTestFindingId);
+    current_finding.append_child(kTestSeverityId)
+        .text()
+        .set(convertUtf8ToUCS2(severity).c_str());
+    current_finding.append_child(kTestDescriptionId)
+        .text()
+        .set(convertUtf8ToUCS2(information).c_str());
+    current_finding.append_child(kTestDetailsId)
+        .text()
+        .set(convertUtf8ToUCS2(details).c_str());
+}
+
+void CResultGathererXml::ReportStatistics(const StatisticsTable& statistics)
+{
+    this->CoreReportStatistics(statistics);
+
+    const wstring current_checker = convertUtf8ToUCS2(this->current_checker_id_);
+    for (auto current_test_node : this->test_node_.children())
+    {
+        auto name_attr = current_test_node.attribute(kTestNameId);
+        if (name_attr && name_attr.value() == current_checker)
+        {
+            // the "Statistics"-node is only added if there are statistics, so that the output is unchanged otherwise
+            auto statistics_container = current_test_node.child(kTestStatisticsContainerId);
+            if (!statistics_container)
+            {
+                statistics_container = current_test_node.append_child(kTestStatisticsContainerId);
+            }
+
+            auto table_node = statistics_container.append_child(kTestStatisticsTableId);
+            table_node.append_attribute(kTestNameId) = convertUtf8ToUCS2(statistics.name).c_str();
+            for (const auto& row : statistics.rows)
+            {
+                auto row_node = table_node.append_child(kTestStatisticsRowId);
+                for (size_t i = 0; i < row.size(); ++i)
+                {
+                    auto cell_node = row_node.append_child(kTestStatisticsCellId);
+                    cell_node.append_attribute(kTestStatisticsColumnId) = convertUtf8ToUCS2(statistics.columns[i]).c_str();
+                    cell_node.text().set(convertUtf8ToUCS2(ResultGathererBase::StatisticsValueToString(row[i])).c_str());
+                }
+            }
+
+            break;
+        }
+    }
+}
+
 void CResultGathererXml::FinalizeChecks()
 {
     ostringstream result_stream;
@@ -8,8 +8,11 @@
 #include "resultgathererbase.h"
 #include "cmdlineoptions.h"
 #include "checks.h"
+#include "memorygovernor.h"
 
 #include "pugixml.hpp"
+#include <cstdint>
+#include <memory>
 #include <string>
 
 class CResultGathererXml : public IResultGatherer, ResultGathererBase
@@ -21,16 +24,37 @@ private:
     pugi::xml_node root_node_;
     pugi::xml_node test_node_;
 
+    std::shared_ptr<CMemoryGovernor> memory_governor_;
+    CMemoryGovernor::Reservation reservation_;
+    std::uint32_t findings_without_details_{ 0 };   ///< The number of findings of the current checker stored without details.
+    std::uint32_t findings_omitted_{ 0 };           ///< The number of findings of the current checker not stored at all.
+
 public:
-    explicit CResultGathererXml(const CCmdLineOptions& options);
+    /// Constructor.
+    ///
+    /// \param  options         The options.
+    /// \param  memory_governor The memory governor, which the memory for the XML-document is reserved with. If the
+    ///                         budget is exhausted, the details of findings are dropped first, then the findings
+    ///                         themselves (this is noted in the output). May be null.
+    CResultGathererXml(const CCmdLineOptions& options, std::shared_ptr<CMemoryGovernor> memory_governor);
     void StartCheck(CZIChecks check) override;
     ReportFindingResult ReportFinding(const Finding& finding) override;
+    void ReportStatistics(const StatisticsTable& statistics) override;
     void FinishCheck(CZIChecks check) override;
 
     void FinalizeChecks() override;
     CheckResult GetAggregatedCounts() const override;
 
 private:
+    void AddFinding(pugi::xml_node& findings_container, const char* severity, const std::string& information, const std::string& details);
+
+    /// The name under which the memory used for the XML-document is tracked by the memory governor.
+    static const char* kMemoryConsumerName;
+
+    /// A rough estimate of the memory used for a finding in the XML-document (in addition to its text, which is
+    /// stored as wide characters).
+    static constexpr std::uint64_t kEstimatedMemoryPerFinding = 256;
+
     static const wchar_t* kXmlVersionId;
     static const wchar_t* kXmlVersionNumber;
     static const wchar_t* kXmlEncodingId;
@@ -46,5 +70,10 @@ private:
     static const wchar_t* kTestFindingId;
     static const wchar_t* kTestSeverityId;
     static const wchar_t* kTestDetailsId;
+    static const wchar_t* kTestStatisticsContainerId;
+    static const wchar_t* kTestStatisticsTableId;
+    static const wchar_t* kTestStatisticsRowId;
+    static const wchar_t* kTestStatisticsCellId;
+    static const wchar_t* kTestStatisticsColumnId;
 };
 
@@ -7,13 +7,491 @@
 #include "utils.h"
 #include "checkerfactory.h"
 #include "resultgathererfactory.h"
+#include "memorygovernor.h"
+#include "metadataindex.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
 #include <sstream>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
+#include <variant>
+#include <vector>
 
 using namespace std;
 using namespace libCZI;
 
+namespace
+{
+    /// This class forwards all calls to a result gatherer - and when a checker finishes, it reports the memory
+    /// usage of this checker (as tracked by the memory governor) as a statistics table. The table is only reported
+    /// if the checker made use of the memory governor.
+    class CMemoryUsageReportingGatherer : public IResultGathererReport
+    {
+    private:
+        IResultGathererReport& result_gatherer_;
+        shared_ptr<CMemoryGovernor> memory_governor_;
+    public:
+        CMemoryUsageReportingGatherer(IResultGathererReport& result_gatherer, shared_ptr<CMemoryGovernor> memory_governor)
+            : result_gatherer_(result_gatherer), memory_governor_(std::move(memory_governor))
+        {
+        }
+
+        void StartCheck(CZIChecks check) override
+        {
+            this->result_gatherer_.StartCheck(check);
+        }
+
+        ReportFindingResult ReportFinding(const Finding& finding) override
+        {
+            return this->result_gatherer_.ReportFinding(finding);
+        }
+
+        void ReportStatistics(const StatisticsTable& statistics) override
+        {
+            this->result_gatherer_.ReportStatistics(statistics);
+        }
+
+        void FinishCheck(CZIChecks check) override
+        {
+            const auto usage = this->memory_governor_->GetUsage(CZIChecksToString(check));
+            if (usage.highWaterMark > 0 || usage.deniedRequests > 0)
+            {
+                StatisticsTable table(check);
+                table.name = "memory usage";
+                table.columns = { "consumer", "current", "high-water mark", "denied requests", "budget" };
+                table.rows.push_back(
+                    {
+                        usage.consumer,
+                        static_cast<int64_t>(usage.current),
+                        static_cast<int64_t>(usage.highWaterMark),
+                        static_cast<int64_t>(usage.deniedRequests),
+                        static_cast<int64_t>(this->memory_governor_->GetBudget())
+                    });
+                table.rows.push_back(
+                    {
+                        string("total"),
+                        static_cast<int64_t>(this->memory_governor_->GetTotalInUse()),
+                        static_cast<int64_t>(this->memory_governor_->GetTotalHighWaterMark()),
+                        static_cast<int64_t>(0),
+                        static_cast<int64_t>(this->memory_governor_->GetBudget())
+                    });
+                this->result_gatherer_.ReportStatistics(table);
+            }
+
+            this->result_gatherer_.FinishCheck(check);
+        }
+    };
+
+    /// This class coordinates the reporting of checkers which are run concurrently, so that the results are still
+    /// reported in the canonical order (and the actual result gatherer is only used by one thread at a time). The
+    /// checkers are identified by their position in the canonical order (the "run index"). The first checker which
+    /// has not finished yet "has the turn" - it reports directly to the actual result gatherer. The other checkers
+    /// record their calls in a buffer, which is replayed once all preceding checkers have finished. The memory for
+    /// the buffer is reserved with the memory governor, and it is capped - if the buffer is full (or the memory governor
+    /// denies the reservation), the checker is blocked until it has the turn.
+    /// Reporting a finding gives the same result as with the actual result gatherer (i.e. "Stop" for a fatal finding
+    /// if fail-fast is enabled). If fail-fast is enabled overall, no further results are reported (and no further
+    /// checkers are to be started) once a fatal error has been reported.
+    class CReportingSequencer
+    {
+    public:
+        struct StartCheckCall
+        {
+            CZIChecks check;
+        };
+
+        struct FinishCheckCall
+        {
+            CZIChecks check;
+        };
+
+        using Call = variant<StartCheckCall, IResultGathererReport::Finding, IResultGathererReport::StatisticsTable, FinishCheckCall>;
+    private:
+        /// The name of the consumer (for the memory governor).
+        static constexpr const char* kMemoryConsumerName = "result buffer";
+
+        /// The maximum size of the buffer of a checker (in bytes).
+        static constexpr uint64_t kMaxBufferSize = 16 * 1024 * 1024;
+
+        struct Run
+        {
+            vector<Call> calls;
+            uint64_t buffered_size{ 0 };
+            CMemoryGovernor::Reservation reservation;
+            bool finished{ false };
+            exception_ptr exception;
+        };
+
+        IResultGatherer& results_gatherer_;
+        shared_ptr<CMemoryGovernor> memory_governor_;
+        CCmdLineOptions::FailFastMode fail_fast_mode_;
+        mutex mutex_;
+        condition_variable turn_changed_;
+        vector<Run> runs_;
+        size_t run_with_turn_{ 0 };
+        bool stopped_{ false };
+        exception_ptr exception_;
+    public:
+        CReportingSequencer(IResultGatherer& results_gatherer, shared_ptr<CMemoryGovernor> memory_governor, CCmdLineOptions::FailFastMode fail_fast_mode, size_t number_of_runs)
+            : results_gatherer_(results_gatherer), memory_governor_(std::move(memory_governor)), fail_fast_mode_(fail_fast_mode), runs_(number_of_runs)
+        {
+        }
+
+        /// Reports the specified call of a checker - either directly to the actual result gatherer, or by recording it
+        /// in the buffer of the checker (or, if the buffer is full, by waiting for the turn of the checker).
+        ///
+        /// \param  run_index   The position of the checker in the canonical order.
+        /// \param  call        The call.
+        ///
+        /// \returns    For a finding, whether the checker is to continue or to stop.
+        IResultGathererReport::ReportFindingResult Report(size_t run_index, Call&& call)
+        {
+            unique_lock<mutex> lock(this->mutex_);
+            auto& run = this->runs_[run_index];
+            if (this->stopped_)
+            {
+                return IResultGathererReport::ReportFindingResult::Stop;
+            }
+
+            if (run_index != this->run_with_turn_)
+            {
+                const uint64_t size = EstimateSize(call);
+                if (run.buffered_size + size <= kMaxBufferSize &&
+                    (!this->memory_governor_ || this->memory_governor_->TryExtend(kMemoryConsumerName, size, run.reservation)))
+                {
+                    const auto result = this->GetResultWhenBuffered(call);
+                    run.buffered_size += size;
+                    run.calls.push_back(std::move(call));
+                    return result;
+                }
+
+                // the buffer is full, so we have to wait for our turn - while doing so, the memory held by this thread
+                //  is not returned, so other threads must not wait for it
+                if (this->memory_governor_)
+                {
+                    this->memory_governor_->SetThreadBlocked(true);
+                }
+
+                this->turn_changed_.wait(lock, [&]() { return this->stopped_ || run_index == this->run_with_turn_; });
+                if (this->memory_governor_)
+                {
+                    this->memory_governor_->SetThreadBlocked(false);
+                }
+
+                if (this->stopped_)
+                {
+                    return IResultGathererReport::ReportFindingResult::Stop;
+                }
+            }
+
+            this->ReplayBuffer(run);
+            return ReplayCall(call, this->results_gatherer_);
+        }
+
+        /// Gets a boolean indicating whether processing is to stop (i.e. no further checkers are to be started).
+        bool IsStopped()
+        {
+            lock_guard<mutex> lock(this->mutex_);
+            return this->stopped_;
+        }
+
+        /// Marks the specified checker as finished. If it has the turn, the buffers of the following checkers which have
+        /// finished are replayed, and the turn is passed on to the first checker which has not finished yet.
+        ///
+        /// \param  run_index   The position of the checker in the canonical order.
+        /// \param  exception   The exception thrown by the checker (if any), it is rethrown by "RethrowIfFailed" once
+        ///                     all preceding checkers have been reported.
+        void Finish(size_t run_index, exception_ptr exception)
+        {
+            {
+                lock_guard<mutex> lock(this->mutex_);
+                auto& run = this->runs_[run_index];
+                run.finished = true;
+                run.exception = std::move(exception);
+                try
+                {
+                    this->PassOnTurn();
+                }
+                catch (...)
+                {
+                    this->exception_ = current_exception();
+                    this->stopped_ = true;
+                }
+            }
+
+            this->turn_changed_.notify_all();
+        }
+
+        /// Marks processing as stopped - checkers waiting for their turn are released (and no further results are
+        /// reported).
+        void Stop()
+        {
+            {
+                lock_guard<mutex> lock(this->mutex_);
+                this->stopped_ = true;
+            }
+
+            this->turn_changed_.notify_all();
+        }
+
+        /// Rethrows the exception thrown by a checker (if any).
+        void RethrowIfFailed()
+        {
+            lock_guard<mutex> lock(this->mutex_);
+            if (this->exception_)
+            {
+                rethrow_exception(this->exception_);
+            }
+        }
+    private:
+        void PassOnTurn()
+        {
+            while (!this->stopped_ && this->run_with_turn_ < this->runs_.size())
+            {
+                auto& run = this->runs_[this->run_with_turn_];
+                this->ReplayBuffer(run);
+                if (!run.finished)
+                {
+                    break;
+                }
+
+                ++this->run_with_turn_;
+                if (run.exception)
+                {
+                    this->exception_ = run.exception;
+                    this->stopped_ = true;
+                }
+                else if (this->fail_fast_mode_ == CCmdLineOptions::FailFastMode::FailFastForFatalErrorsOverall &&
+                    this->results_gatherer_.GetAggregatedResult() == IResultGatherer::AggregatedResult::ErrorsDetected)
+                {
+                    // if fail-fast is enabled overall, and errors have been detected, we stop here.
+                    this->stopped_ = true;
+                }
+            }
+        }
+
+        void ReplayBuffer(Run& run)
+        {
+            for (const auto& call : run.calls)
+            {
+                // the checker already acted on the result of 'ReportFinding' when it was recorded
+                static_cast<void>(ReplayCall(call, this->results_gatherer_));
+            }
+
+            vector<Call>().swap(run.calls);
+            run.buffered_size = 0;
+            run.reservation.Release();
+        }
+
+        IResultGathererReport::ReportFindingResult GetResultWhenBuffered(const Call& call) const
+        {
+            const auto finding = get_if<IResultGathererReport::Finding>(&call);
+            if (finding != nullptr &&
+                finding->severity == IResultGathererReport::Severity::Fatal &&
+                (this->fail_fast_mode_ == CCmdLineOptions::FailFastMode::FailFastForFatalErrorsOverall ||
+                this->fail_fast_mode_ == CCmdLineOptions::FailFastMode::FailFastForFatalErrorsPerChecker))
+            {
+                return IResultGathererReport::ReportFindingResult::Stop;
+            }
+
+            return IResultGathererReport::ReportFindingResult::Continue;
+        }
+
+        static IResultGathererReport::ReportFindingResult ReplayCall(const Call& call, IResultGathererReport& result_gatherer)
+        {
+            if (const auto start_check_call = get_if<StartCheckCall>(&call))
+            {
+                result_gatherer.StartCheck(start_check_call->check);
+            }
+            else if (const auto finding = get_if<IResultGathererReport::Finding>(&call))
+            {
+                return result_gatherer.ReportFinding(*finding);
+            }
+            else if (const auto statistics = get_if<IResultGathererReport::StatisticsTable>(&call))
+            {
+                result_gatherer.ReportStatistics(*statistics);
+            }
+            else if (const auto finish_check_call = get_if<FinishCheckCall>(&call))
+            {
+                result_gatherer.FinishCheck(finish_check_call->check);
+            }
+
+            return IResultGathererReport::ReportFindingResult::Continue;
+        }
+
+        /// Estimates the memory used by a recorded call (in bytes).
+        static uint64_t EstimateSize(const Call& call)
+        {
+            uint64_t size = sizeof(Call);
+            if (const auto finding = get_if<IResultGathererReport::Finding>(&call))
+            {
+                size += finding->information.size() + finding->details.size();
+            }
+            else if (const auto statistics = get_if<IResultGathererReport::StatisticsTable>(&call))
+            {
+                size += statistics->name.size();
+                for (const auto& column : statistics->columns)
+                {
+                    size += sizeof(string) + column.size();
+                }
+
+                for (const auto& row : statistics->rows)
+                {
+                    size += sizeof(row) + row.size() * sizeof(IResultGathererReport::StatisticsValue);
+                    for (const auto& value : row)
+                    {
+                        if (const auto text = get_if<string>(&value))
+                        {
+                            size += text->size();
+                        }
+                    }
+                }
+            }
+
+            return size;
+        }
+    };
+
+    /// This class forwards all calls made by a checker to the reporting sequencer (for the position of the checker
+    /// in the canonical order).
+    class CSequencedResultGatherer : public IResultGathererReport
+    {
+    private:
+        CReportingSequencer& sequencer_;
+        size_t run_index_;
+    public:
+        CSequencedResultGatherer(CReportingSequencer& sequencer, size_t run_index)
+            : sequencer_(sequencer), run_index_(run_index)
+        {
+        }
+
+        void StartCheck(CZIChecks check) override
+        {
+            this->sequencer_.Report(this->run_index_, CReportingSequencer::StartCheckCall{ check });
+        }
+
+        ReportFindingResult ReportFinding(const Finding& finding) override
+        {
+            return this->sequencer_.Report(this->run_index_, finding);
+        }
+
+        void ReportStatistics(const StatisticsTable& statistics) override
+        {
+            this->sequencer_.Report(this->run_index_, statistics);
+        }
+
+        void FinishCheck(CZIChecks check) override
+        {
+            this->sequencer_.Report(this->run_index_, CReportingSequencer::FinishCheckCall{ check });
+        }
+    };
+
+    /// Gets a boolean indicating whether the specified checker examines only the XML-metadata (and the subblock
+    /// statistics) - those checkers can run concurrently with the checkers examining the subblocks.
+    bool IsMetadataCheck(CZIChecks check)
+    {
+        return check == CZIChecks::BasicMetadataValidation ||
+            check == CZIChecks::ApplianceMetadataTopographyItemValid ||
+            check == CZIChecks::XmlMetadataSchemaValidation;
+    }
+
+    /// Runs the specified checkers, where the checkers examining the XML-metadata are run on a dedicated thread,
+    /// concurrently with the other checkers (which are run on the calling thread). The results are reported through
+    /// a reporting sequencer, so the output is the same as when running the checkers one after the other.
+    ///
+    /// \param  checks_to_run           The checkers to run (in canonical order).
+    /// \param  reader                  The CZI-reader object.
+    /// \param  results_gatherer        The result gatherer.
+    /// \param  additional_info         The additional information for the checkers.
+    /// \param  memory_governor         The memory governor.
+    /// \param  fail_fast_mode          The fail-fast mode.
+    /// \param  statistics_enabled      Whether statistics are enabled (in which case the memory usage is reported as well).
+    void RunChecksWithConcurrentMetadataChecks(
+        const vector<CZIChecks>& checks_to_run,
+        const shared_ptr<ICZIReader>& reader,
+        IResultGatherer& results_gatherer,
+        const CheckerCreateInfo& additional_info,
+        const shared_ptr<CMemoryGovernor>& memory_governor,
+        CCmdLineOptions::FailFastMode fail_fast_mode,
+        bool statistics_enabled)
+    {
+        CReportingSequencer sequencer(results_gatherer, memory_governor, fail_fast_mode, checks_to_run.size());
+        const auto run_checker = [&](size_t run_index)->bool
+            {
+                if (sequencer.IsStopped())
+                {
+                    return false;
+                }
+
+                exception_ptr exception;
+                try
+                {
+                    CSequencedResultGatherer sequenced_result_gatherer(sequencer, run_index);
+                    CMemoryUsageReportingGatherer memory_usage_reporting_gatherer(sequenced_result_gatherer, memory_governor);
+                    IResultGathererReport& result_gatherer_for_checker = statistics_enabled ?
+                        static_cast<IResultGathererReport&>(memory_usage_reporting_gatherer) :
+                        static_cast<IResultGathererReport&>(sequenced_result_gatherer);
+                    auto checker = CCheckerFactory::CreateChecker(checks_to_run[run_index], reader, result_gatherer_for_checker, additional_info);
+                    checker->RunCheck();
+                }
+                catch (...)
+                {
+                    exception = current_exception();
+                }
+
+                sequencer.Finish(run_index, exception);
+                return true;
+            };
+
+        thread metadata_thread(
+            [&]()
+            {
+                for (size_t run_index = 0; run_index < checks_to_run.size(); ++run_index)
+                {
+                    if (IsMetadataCheck(checks_to_run[run_index]) && !run_checker(run_index))
+                    {
+                        break;
+                    }
+                }
+
+                // the index of the XML-metadata is not needed any more
+                if (additional_info.metadataIndexCache)
+                {
+                    additional_info.metadataIndexCache->Release();
+                }
+            });
+
+        try
+        {
+            for (size_t run_index = 0; run_index < checks_to_run.size(); ++run_index)
+            {
+                if (!IsMetadataCheck(checks_to_run[run_index]) && !run_checker(run_index))
+                {
+                    break;
+                }
+            }
+
+            metadata_thread.join();
+        }
+        catch (...)
+        {
+            sequencer.Stop();
+            if (metadata_thread.joinable())
+            {
+                metadata_thread.join();
+            }
+
+            throw;
+        }
+
+        sequencer.RethrowIfFailed();
+    }
+}
+
 CRunChecks::CRunChecks(const CCmdLineOptions& opts, std::shared_ptr<ILog> consoleIo)
     : opts(opts), consoleIo(std::move(consoleIo))
 {
@@ -51,7 +529,9 @@ bool CRunChecks::Run(IResultGatherer::AggregatedResult& result)
         return false;
     }
 
-    auto resultsGatherer = CreateResultGatherer(opts);
+    // the memory governor is always created (so that the usage is tracked), the budget is only enforced if given
+    const auto memoryGovernor = make_shared<CMemoryGovernor>(this->opts.GetMaxMemory());
+    auto resultsGatherer = CreateResultGatherer(opts, memoryGovernor);
 
     CheckerCreateInfo checkerAdditionalInfo;
     // Only determine the file size for local file inputs. For URL or other stream classes
@@ -61,22 +541,96 @@ bool CRunChecks::Run(IResultGatherer::AggregatedResult& result)
     checkerAdditionalInfo.totalFileSize = GetFileSize(this->opts.GetCZIFilename().c_str());
     }
 
-    const auto& checksToRun = this->opts.GetChecksEnabled();
-    for (auto checkType : checksToRun)
+    checkerAdditionalInfo.stream = stream;
+    checkerAdditionalInfo.collectStatistics = this->opts.GetStatisticsEnabled();
+    checkerAdditionalInfo.maxDecodeAmplification = this->opts.GetMaxDecodeAmplification();
+    checkerAdditionalInfo.minTileSize = this->opts.GetMinTileSize();
+    checkerAdditionalInfo.maxTileSize = this->opts.GetMaxTileSize();
+    checkerAdditionalInfo.tempDirectory = this->opts.GetTempDirectory();
+    checkerAdditionalInfo.memoryGovernor = memoryGovernor;
+    checkerAdditionalInfo.metadataIndexCache = make_shared<CMetadataIndexCache>(memoryGovernor);
+
+    if (!this->opts.GetWriteManifestFilename().empty() || !this->opts.GetVerifyManifestFilename().empty())
     {
-        auto checker = CCheckerFactory::CreateChecker(checkType, spReader, *resultsGatherer, checkerAdditionalInfo);
-        checker->RunCheck();
+        checkerAdditionalInfo.manifest = make_shared<CSubBlockManifest>();
+        if (!this->opts.GetVerifyManifestFilename().empty())
+        {
+            try
+            {
+                checkerAdditionalInfo.manifest->SetReference(CSubBlockManifest::ReadFromFile(this->opts.GetVerifyManifestFilename()));
+            }
+            catch (exception& ex)
+            {
+                stringstream ss;
+                ss << "Could not read the manifest : " << ex.what();
+                this->consoleIo->WriteLineStdErr(ss.str());
+                return false;
+            }
+        }
+    }
+
+    // if statistics are requested, the memory usage of each checker is reported as well
+    CMemoryUsageReportingGatherer memoryUsageReportingGatherer(*resultsGatherer, memoryGovernor);
+    IResultGathererReport& resultsGathererForCheckers = this->opts.GetStatisticsEnabled() ?
+        static_cast<IResultGathererReport&>(memoryUsageReportingGatherer) :
+        static_cast<IResultGathererReport&>(*resultsGatherer);
 
-        // if fail-fast is enabled overall, and errors have been detected, we stop here.
-        if (this->opts.GetFailFastMode() == CCmdLineOptions::FailFastMode::FailFastForFatalErrorsOverall &&
-            resultsGatherer->GetAggregatedResult() == IResultGatherer::AggregatedResult::ErrorsDetected)
+    // the checkers examining the XML-metadata do not depend on the subblocks, so they are run concurrently with the
+    //  other checkers (if there are any)
+    const auto& checksToRun = this->opts.GetChecksEnabled();
+    const auto numberOfMetadataChecks = count_if(checksToRun.cbegin(), checksToRun.cend(), IsMetadataCheck);
+    if (numberOfMetadataChecks > 0 && static_cast<size_t>(numberOfMetadataChecks) < checksToRun.size())
+    {
+        RunChecksWithConcurrentMetadataChecks(
+            checksToRun,
+            spReader,
+            *resultsGatherer,
+            checkerAdditionalInfo,
+            memoryGovernor,
+            this->opts.GetFailFastMode(),
+            this->opts.GetStatisticsEnabled());
+    }
+    else
+    {
+        auto remainingMetadataChecks = numberOfMetadataChecks;
+        for (auto checkType : checksToRun)
         {
-            break;
+            auto checker = CCheckerFactory::CreateChecker(checkType, spReader, resultsGathererForCheckers, checkerAdditionalInfo);
+            checker->RunCheck();
+            checker.reset();
+
+            // once the last checker examining the XML-metadata has run, the index of the XML-metadata is not needed any more
+            if (IsMetadataCheck(checkType) && --remainingMetadataChecks == 0)
+            {
+                checkerAdditionalInfo.metadataIndexCache->Release();
+            }
+
+            // if fail-fast is enabled overall, and errors have been detected, we stop here.
+            if (this->opts.GetFailFastMode() == CCmdLineOptions::FailFastMode::FailFastForFatalErrorsOverall &&
+                resultsGatherer->GetAggregatedResult() == IResultGatherer::AggregatedResult::ErrorsDetected)
+            {
+                break;
+            }
         }
     }
 
     result = resultsGatherer->GetAggregatedResult();
 
+    if (checkerAdditionalInfo.manifest && !this->opts.GetWriteManifestFilename().empty())
+    {
+        try
+        {
+            CSubBlockManifest::WriteToFile(this->opts.GetWriteManifestFilename(), checkerAdditionalInfo.manifest->GetEntries());
+        }
+        catch (exception& ex)
+        {
+            stringstream ss;
+            ss << "Could not write the manifest : " << ex.what();
+            this->consoleIo->WriteLineStdErr(ss.str());
+            return false;
+        }
+    }
+
     resultsGatherer->FinalizeChecks();
     return true;
 }
@@ -0,0 +1,386 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "segmentreader.h"
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+using namespace libCZI;
+
+namespace
+{
+    // The subblock-segment starts with "MetadataSize" (4 bytes), "AttachmentSize" (4 bytes) and "DataSize" (8 bytes),
+    //  followed by a directory-entry (of schema "DV"). The fixed part of the directory-entry is 32 bytes, followed by
+    //  a variable number of dimension-entries (20 bytes each). The header is padded to a size of at least 256 bytes.
+    constexpr size_t kSubBlockSegmentFixedPartSize = 16;
+    constexpr size_t kDirectoryEntryDvFixedPartSize = 32;
+    constexpr size_t kDimensionEntrySize = 20;
+    constexpr uint64_t kSubBlockHeaderMinimumSize = 256;
+    constexpr size_t kOffsetOfDimensionCount = kSubBlockSegmentFixedPartSize + 28;
+
+    // The file-header segment contains (after major/minor version, reserved fields, two GUIDs and the file-part) the
+    //  positions of the subblock-directory and the metadata, the "update pending"-flag and the position of the
+    //  attachment-directory.
+    constexpr uint64_t kOffsetOfSubBlockDirectoryPosition = 52;
+    constexpr uint64_t kFileHeaderPositionsSize = 28;
+
+    // The attachment-directory segment starts with "EntryCount" (4 bytes) and 252 reserved bytes, followed by the
+    //  entries (of schema "A1", 128 bytes each).
+    constexpr size_t kAttachmentDirectoryFixedPartSize = 256;
+    constexpr size_t kAttachmentEntrySize = 128;
+
+    // The attachment-segment starts with "DataSize" (4 bytes) and 12 reserved bytes, followed by the attachment-entry
+    //  and 112 reserved bytes - then the data follows.
+    constexpr size_t kAttachmentSegmentHeaderSize = CSegmentReader::kAttachmentSegmentHeaderReadSize - CSegmentReader::kSegmentHeaderSize;
+    constexpr size_t kOffsetOfAttachmentEntryInSegment = 16;
+
+    CSegmentReader::AttachmentEntry ParseAttachmentEntry(const uint8_t* ptr, uint64_t position)
+    {
+        if (ptr[0] != 'A' || ptr[1] != '1')
+        {
+            stringstream ss;
+            ss << "attachment-entry at position " << position << " has an unexpected schema";
+            throw runtime_error(ss.str());
+        }
+
+        // layout: schema-type (2 bytes), reserved (10 bytes), file-position (8 bytes), file-part (4 bytes),
+        //  content-GUID (16 bytes), content file-type (8 bytes), name (80 bytes)
+        CSegmentReader::AttachmentEntry entry;
+        entry.filePosition = CSegmentReader::GetInt64(ptr + 12);
+        entry.filePart = CSegmentReader::GetInt32(ptr + 20);
+        const uint8_t* guid = ptr + 24;
+        entry.contentGuid.Data1 = static_cast<uint32_t>(CSegmentReader::GetInt32(guid));
+        entry.contentGuid.Data2 = static_cast<uint16_t>(guid[4] | (guid[5] << 8));
+        entry.contentGuid.Data3 = static_cast<uint16_t>(guid[6] | (guid[7] << 8));
+        copy(guid + 8, guid + 16, entry.contentGuid.Data4);
+        const char* content_file_type = reinterpret_cast<const char*>(ptr + 40);
+        entry.contentFileType.assign(content_file_type, find(content_file_type, content_file_type + 8, '\0'));
+        const char* name = reinterpret_cast<const char*>(ptr + 48);
+        entry.name.assign(name, find(name, name + 80, '\0'));
+        return entry;
+    }
+}
+
+/*static*/CSegmentReader::SegmentHeader CSegmentReader::ReadSegmentHeader(libCZI::IStream* stream, std::uint64_t position)
+{
+    uint8_t buffer[kSegmentHeaderSize];
+    CSegmentReader::ReadExactly(stream, position, buffer, sizeof(buffer));
+    return CSegmentReader::ParseSegmentHeader(buffer, position);
+}
+
+/*static*/CSegmentReader::SegmentHeader CSegmentReader::ParseSegmentHeader(const std::uint8_t* buffer, std::uint64_t position)
+{
+    SegmentHeader header;
+    const char* id = reinterpret_cast<const char*>(buffer);
+    header.id.assign(id, find(id, id + 16, '\0'));
+    header.allocatedSize = CSegmentReader::GetInt64(buffer + 16);
+    header.usedSize = CSegmentReader::GetInt64(buffer + 24);
+    if (header.allocatedSize < 0 || header.usedSize < 0)
+    {
+        stringstream ss;
+        ss << "invalid segment-header at position " << position << " (allocated size=" << header.allocatedSize << ", used size=" << header.usedSize << ")";
+        throw runtime_error(ss.str());
+    }
+
+    return header;
+}
+
+/*static*/CSegmentReader::SubBlockSegmentInfo CSegmentReader::ReadSubBlockSegmentInfo(libCZI::IStream* stream, std::uint64_t position, std::uint64_t total_file_size)
+{
+    SubBlockSegmentInfo info;
+    info.segmentHeader = CSegmentReader::ReadSegmentHeader(stream, position);
+    if (info.segmentHeader.id != "ZISRAWSUBBLOCK")
+    {
+        stringstream ss;
+        ss << "segment at position " << position << " has id \"" << info.segmentHeader.id << "\", expected \"ZISRAWSUBBLOCK\"";
+        throw runtime_error(ss.str());
+    }
+
+    const uint64_t segment_data_size = static_cast<uint64_t>(info.segmentHeader.GetEffectiveUsedSize());
+    if (total_file_size > 0 && position + kSegmentHeaderSize + segment_data_size > total_file_size)
+    {
+        stringstream ss;
+        ss << "subblock-segment at position " << position << " with size " << segment_data_size << " extends beyond the end of the file (filesize=" << total_file_size << ")";
+        throw runtime_error(ss.str());
+    }
+
+    if (segment_data_size < kSubBlockSegmentFixedPartSize + kDirectoryEntryDvFixedPartSize)
+    {
+        stringstream ss;
+        ss << "subblock-segment at position " << position << " is too small (size=" << segment_data_size << ")";
+        throw runtime_error(ss.str());
+    }
+
+    uint8_t buffer[kSubBlockSegmentFixedPartSize + kDirectoryEntryDvFixedPartSize];
+    CSegmentReader::ReadExactly(stream, position + kSegmentHeaderSize, buffer, sizeof(buffer));
+    if (buffer[kSubBlockSegmentFixedPartSize] != 'D' || buffer[kSubBlockSegmentFixedPartSize + 1] != 'V')
+    {
+        stringstream ss;
+        ss << "subblock-segment at position " << position << " has an unexpected directory-entry schema";
+        throw runtime_error(ss.str());
+    }
+
+    info.metadataSize = CSegmentReader::GetInt32(buffer);
+    info.attachmentSize = CSegmentReader::GetInt32(buffer + 4);
+    info.dataSize = CSegmentReader::GetInt64(buffer + 8);
+    info.dimensionCount = CSegmentReader::GetInt32(buffer + kOffsetOfDimensionCount);
+    if (info.metadataSize < 0 || info.attachmentSize < 0 || info.dataSize < 0 || info.dimensionCount < 0)
+    {
+        stringstream ss;
+        ss << "subblock-segment at position " << position << " has invalid sizes (metadata=" << info.metadataSize
+            << ", data=" << info.dataSize << ", attachment=" << info.attachmentSize << ", dimension-count=" << info.dimensionCount << ")";
+        throw runtime_error(ss.str());
+    }
+
+    info.headerSize = max(
+        kSubBlockHeaderMinimumSize,
+        static_cast<uint64_t>(kSubBlockSegmentFixedPartSize + kDirectoryEntryDvFixedPartSize) + static_cast<uint64_t>(info.dimensionCount) * kDimensionEntrySize);
+    if (info.GetRequiredSize() > segment_data_size)
+    {
+        stringstream ss;
+        ss << "subblock-segment at position " << position << " requires " << info.GetRequiredSize()
+            << " bytes (header=" << info.headerSize << ", metadata=" << info.metadataSize << ", data=" << info.dataSize << ", attachment=" << info.attachmentSize
+            << "), but the segment's size is only " << segment_data_size << " bytes";
+        throw runtime_error(ss.str());
+    }
+
+    info.metadataOffset = position + kSegmentHeaderSize + info.headerSize;
+    info.dataOffset = info.metadataOffset + static_cast<uint64_t>(info.metadataSize);
+    info.attachmentOffset = info.dataOffset + static_cast<uint64_t>(info.dataSize);
+    return info;
+}
+
+/*static*/CSegmentReader::FileHeaderInfo CSegmentReader::ReadFileHeaderInfo(libCZI::IStream* stream)
+{
+    const auto header = CSegmentReader::ReadSegmentHeader(stream, 0);
+    if (header.id != "ZISRAWFILE")
+    {
+        stringstream ss;
+        ss << "segment at position 0 has id \"" << header.id << "\", expected \"ZISRAWFILE\"";
+        throw runtime_error(ss.str());
+    }
+
+    uint8_t buffer[kFileHeaderPositionsSize];
+    CSegmentReader::ReadExactly(stream, kSegmentHeaderSize + kOffsetOfSubBlockDirectoryPosition, buffer, sizeof(buffer));
+    FileHeaderInfo info;
+    info.segmentHeader = header;
+    info.subBlockDirectoryPosition = CSegmentReader::GetInt64(buffer);
+    info.metadataPosition = CSegmentReader::GetInt64(buffer + 8);
+    info.attachmentDirectoryPosition = CSegmentReader::GetInt64(buffer + 20);
+    if (info.subBlockDirectoryPosition < 0 || info.metadataPosition < 0 || info.attachmentDirectoryPosition < 0)
+    {
+        stringstream ss;
+        ss << "invalid positions in the file-header (subblock-directory=" << info.subBlockDirectoryPosition
+            << ", metadata=" << info.metadataPosition << ", attachment-directory=" << info.attachmentDirectoryPosition << ")";
+        throw runtime_error(ss.str());
+    }
+
+    return info;
+}
+
+/*static*/std::vector<CSegmentReader::AttachmentEntry> CSegmentReader::ReadAttachmentDirectory(libCZI::IStream* stream, std::uint64_t position, std::uint64_t total_file_size)
+{
+    const auto header = CSegmentReader::ReadSegmentHeader(stream, position);
+    if (header.id != "ZISRAWATTDIR")
+    {
+        stringstream ss;
+        ss << "segment at position " << position << " has id \"" << header.id << "\", expected \"ZISRAWATTDIR\"";
+        throw runtime_error(ss.str());
+    }
+
+    const uint64_t segment_data_size = static_cast<uint64_t>(header.GetEffectiveUsedSize());
+    if (total_file_size > 0 && position + kSegmentHeaderSize + segment_data_size > total_file_size)
+    {
+        stringstream ss;
+        ss << "attachment-directory segment at position " << position << " with size " << segment_data_size << " extends beyond the end of the file (filesize=" << total_file_size << ")";
+        throw runtime_error(ss.str());
+    }
+
+    uint8_t fixed_part[4];
+    CSegmentReader::ReadExactly(stream, position + kSegmentHeaderSize, fixed_part, sizeof(fixed_part));
+    const int32_t entry_count = CSegmentReader::GetInt32(fixed_part);
+    if (entry_count < 0 || kAttachmentDirectoryFixedPartSize + static_cast<uint64_t>(entry_count) * kAttachmentEntrySize > segment_data_size)
+    {
+        stringstream ss;
+        ss << "attachment-directory segment at position " << position << " has an invalid number of entries (=" << entry_count << ") for its size (=" << segment_data_size << ")";
+        throw runtime_error(ss.str());
+    }
+
+    // all entries are read with one read-operation
+    vector<uint8_t> buffer(static_cast<size_t>(entry_count) * kAttachmentEntrySize);
+    CSegmentReader::ReadExactly(stream, position + kSegmentHeaderSize + kAttachmentDirectoryFixedPartSize, buffer.data(), buffer.size());
+    vector<AttachmentEntry> entries;
+    entries.reserve(entry_count);
+    for (int32_t i = 0; i < entry_count; ++i)
+    {
+        const uint64_t entry_offset = static_cast<uint64_t>(i) * kAttachmentEntrySize;
+        entries.emplace_back(ParseAttachmentEntry(buffer.data() + entry_offset, position + kSegmentHeaderSize + kAttachmentDirectoryFixedPartSize + entry_offset));
+    }
+
+    return entries;
+}
+
+/*static*/CSegmentReader::AttachmentSegmentInfo CSegmentReader::ReadAttachmentSegmentInfo(libCZI::IStream* stream, std::uint64_t position, std::uint64_t total_file_size)
+{
+    // the segment-header and the attachment-segment's header are read with one read-operation
+    uint8_t buffer[kAttachmentSegmentHeaderReadSize];
+    CSegmentReader::ReadExactly(stream, position, buffer, sizeof(buffer));
+    return CSegmentReader::ParseAttachmentSegmentInfo(buffer, position, total_file_size);
+}
+
+/*static*/CSegmentReader::AttachmentSegmentInfo CSegmentReader::ParseAttachmentSegmentInfo(const std::uint8_t* buffer, std::uint64_t position, std::uint64_t total_file_size)
+{
+    AttachmentSegmentInfo info;
+    info.segmentHeader = CSegmentReader::ParseSegmentHeader(buffer, position);
+    if (info.segmentHeader.id != "ZISRAWATTACH")
+    {
+        stringstream ss;
+        ss << "segment at position " << position << " has id \"" << info.segmentHeader.id << "\", expected \"ZISRAWATTACH\"";
+        throw runtime_error(ss.str());
+    }
+
+    const uint64_t segment_data_size = static_cast<uint64_t>(info.segmentHeader.GetEffectiveUsedSize());
+    if (total_file_size > 0 && position + kSegmentHeaderSize + segment_data_size > total_file_size)
+    {
+        stringstream ss;
+        ss << "attachment-segment at position " << position << " with size " << segment_data_size << " extends beyond the end of the file (filesize=" << total_file_size << ")";
+        throw runtime_error(ss.str());
+    }
+
+    info.dataSize = CSegmentReader::GetInt32(buffer + kSegmentHeaderSize);
+    if (info.dataSize < 0 || kAttachmentSegmentHeaderSize + static_cast<uint64_t>(info.dataSize) > segment_data_size)
+    {
+        stringstream ss;
+        ss << "attachment-segment at position " << position << " requires " << kAttachmentSegmentHeaderSize + static_cast<int64_t>(info.dataSize)
+            << " bytes (header=" << kAttachmentSegmentHeaderSize << ", data=" << info.dataSize << "), but the segment's size is only " << segment_data_size << " bytes";
+        throw runtime_error(ss.str());
+    }
+
+    info.entry = ParseAttachmentEntry(buffer + kSegmentHeaderSize + kOffsetOfAttachmentEntryInSegment, position + kSegmentHeaderSize + kOffsetOfAttachmentEntryInSegment);
+    info.dataOffset = position + kSegmentHeaderSize + kAttachmentSegmentHeaderSize;
+    return info;
+}
+
+/*static*/void CSegmentReader::ReadBatched(
+    libCZI::IStream* stream,
+    const std::vector<std::uint64_t>& positions,
+    std::size_t size,
+    std::uint64_t max_batch_size,
+    const std::function<void(std::size_t, const std::uint8_t*, const char*)>& func)
+{
+    vector<uint8_t> buffer;
+    for (size_t batch_start = 0; batch_start < positions.size();)
+    {
+        // determine the ranges which can be read along with the first one
+        const uint64_t start_position = positions[batch_start];
+        size_t batch_end = batch_start + 1;
+        while (batch_end < positions.size() && positions[batch_end] + size - start_position <= max_batch_size)
+        {
+            ++batch_end;
+        }
+
+        buffer.resize(static_cast<size_t>(positions[batch_end - 1] + size - start_position));
+        bool batch_read = true;
+        try
+        {
+            CSegmentReader::ReadExactly(stream, start_position, buffer.data(), buffer.size());
+        }
+        catch (exception&)
+        {
+            // if the range could not be read as a whole, we fall back to reading the ranges one by one, so that
+            //  the erroneous range(s) can be identified
+            batch_read = false;
+        }
+
+        for (size_t i = batch_start; i < batch_end; ++i)
+        {
+            if (batch_read)
+            {
+                func(i, buffer.data() + (positions[i] - start_position), nullptr);
+                continue;
+            }
+
+            vector<uint8_t> single(size);
+            bool single_read = true;
+            string error_message;
+            try
+            {
+                CSegmentReader::ReadExactly(stream, positions[i], single.data(), single.size());
+            }
+            catch (exception& ex)
+            {
+                single_read = false;
+                error_message = ex.what();
+            }
+
+            if (single_read)
+            {
+                func(i, single.data(), nullptr);
+            }
+            else
+            {
+                func(i, nullptr, error_message.c_str());
+            }
+        }
+
+        batch_start = batch_end;
+    }
+}
+
+/*static*/bool CSegmentReader::ReadInChunks(
+    libCZI::IStream* stream,
+    std::uint64_t offset,
+    std::uint64_t size,
+    std::size_t chunk_size,
+    const std::function<bool(std::uint64_t, const void*, std::size_t)>& func)
+{
+    const size_t buffer_size = static_cast<size_t>(min(static_cast<uint64_t>(chunk_size), size));
+    unique_ptr<uint8_t[]> buffer(new uint8_t[buffer_size > 0 ? buffer_size : 1]);
+    for (uint64_t bytes_done = 0; bytes_done < size;)
+    {
+        const size_t bytes_to_read = static_cast<size_t>(min(static_cast<uint64_t>(buffer_size), size - bytes_done));
+        CSegmentReader::ReadExactly(stream, offset + bytes_done, buffer.get(), bytes_to_read);
+        if (!func(offset + bytes_done, buffer.get(), bytes_to_read))
+        {
+            return false;
+        }
+
+        bytes_done += bytes_to_read;
+    }
+
+    return true;
+}
+
+/*static*/void CSegmentReader::ReadExactly(libCZI::IStream* stream, std::uint64_t offset, void* data, std::uint64_t size)
+{
+    uint64_t bytes_read = 0;
+    stream->Read(offset, data, size, &bytes_read);
+    if (bytes_read != size)
+    {
+        stringstream ss;
+        ss << "could not read " << size << " bytes at position " << offset << " (only " << bytes_read << " bytes were read)";
+        throw runtime_error(ss.str());
+    }
+}
+
+/*static*/std::int32_t CSegmentReader::GetInt32(const std::uint8_t* ptr)
+{
+    const uint32_t value =
+        static_cast<uint32_t>(ptr[0]) |
+        (static_cast<uint32_t>(ptr[1]) << 8) |
+        (static_cast<uint32_t>(ptr[2]) << 16) |
+        (static_cast<uint32_t>(ptr[3]) << 24);
+    return static_cast<int32_t>(value);
+}
+
+/*static*/std::int64_t CSegmentReader::GetInt64(const std::uint8_t* ptr)
+{
+    const uint64_t value =
+        static_cast<uint64_t>(static_cast<uint32_t>(CSegmentReader::GetInt32(ptr))) |
+        (static_cast<uint64_t>(static_cast<uint32_t>(CSegmentReader::GetInt32(ptr + 4))) << 32);
+    return static_cast<int64_t>(value);
+}
@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "inc_libCZI.h"
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// Utilities for reading the segments of a CZI-file directly from the stream, i.e. without
+/// going through libCZI's reader-object. This allows for inspecting the on-disk structures
+/// (e.g. sizes and extents of a segment) without having to load a segment as a whole - which is
+/// prohibitive for very large subblocks. All functions in here throw an exception (derived from
+/// std::exception) in case of an error, e.g. if the data could not be read or is found to be invalid.
+class CSegmentReader
+{
+public:
+    /// The size of a segment-header in bytes.
+    static constexpr std::uint64_t kSegmentHeaderSize = 32;
+
+    /// The size of the chunks (in bytes) used by "ReadInChunks".
+    static constexpr std::size_t kDefaultChunkSize = 1024 * 1024;
+
+    /// The number of bytes which make up the header of an attachment-segment (i.e. the segment-header plus the
+    /// fixed-size part preceding the attachment's data).
+    static constexpr std::size_t kAttachmentSegmentHeaderReadSize = 288;
+
+    /// The segment-header (which is found at the start of every segment).
+    struct SegmentHeader
+    {
+        std::string id;                 ///< The segment-id (e.g. "ZISRAWSUBBLOCK"), with trailing zeros removed.
+        std::int64_t allocatedSize{ 0 };///< The allocated size of the segment (not including the segment-header).
+        std::int64_t usedSize{ 0 };     ///< The used size of the segment (not including the segment-header), 0 means "same as allocated size".
+
+        /// Gets the number of bytes which are used in the segment, i.e. the used size (if given) or the allocated size.
+        [[nodiscard]] std::int64_t GetEffectiveUsedSize() const { return this->usedSize != 0 ? this->usedSize : this->allocatedSize; }
+    };
+
+    /// Information from the file-header segment (which is found at the start of the file).
+    struct FileHeaderInfo
+    {
+        SegmentHeader segmentHeader;                    ///< The segment-header.
+        std::int64_t subBlockDirectoryPosition{ 0 };    ///< The file-position of the subblock-directory segment, 0 if not present.
+        std::int64_t metadataPosition{ 0 };             ///< The file-position of the metadata segment, 0 if not present.
+        std::int64_t attachmentDirectoryPosition{ 0 };  ///< The file-position of the attachment-directory segment, 0 if not present.
+    };
+
+    /// Information about the layout of a subblock-segment, as determined from its header.
+    struct SubBlockSegmentInfo
+    {
+        SegmentHeader segmentHeader;           ///< The segment-header.
+        std::int32_t metadataSize{ 0 };        ///< The size of the subblock-metadata in bytes.
+        std::int32_t attachmentSize{ 0 };      ///< The size of the subblock-attachment in bytes.
+        std::int64_t dataSize{ 0 };            ///< The size of the subblock-data (i.e. the pixel-data) in bytes.
+        std::int32_t dimensionCount{ 0 };      ///< The number of dimension-entries in the directory-entry.
+        std::uint64_t headerSize{ 0 };         ///< The size of the subblock-header (i.e. the fixed part including the directory-entry and padding) in bytes.
+        std::uint64_t metadataOffset{ 0 };     ///< The file-position of the subblock-metadata.
+        std::uint64_t dataOffset{ 0 };         ///< The file-position of the subblock-data.
+        std::uint64_t attachmentOffset{ 0 };   ///< The file-position of the subblock-attachment.
+
+        /// Gets the number of bytes (of the segment's data) which are required for the subblock-segment as described by its header.
+        [[nodiscard]] std::uint64_t GetRequiredSize() const
+        {
+            return this->headerSize + static_cast<std::uint64_t>(this->metadataSize) + static_cast<std::uint64_t>(this->dataSize) + static_cast<std::uint64_t>(this->attachmentSize);
+        }
+    };
+
+    /// An entry of the attachment-directory (of schema "A1"), which is also found in the header of an attachment-segment.
+    struct AttachmentEntry
+    {
+        std::int64_t filePosition{ 0 };    ///< The file-position of the attachment-segment.
+        std::int32_t filePart{ 0 };        ///< The file-part (for multi-file documents).
+        libCZI::GUID contentGuid{};         ///< The content-GUID.
+        std::string contentFileType;        ///< The content file-type (e.g. "JPG" or "CZTIMS"), with trailing zeros removed.
+        std::string name;                   ///< The name (e.g. "Thumbnail" or "EventList"), with trailing zeros removed.
+    };
+
+    /// Information about an attachment-segment, as determined from its header.
+    struct AttachmentSegmentInfo
+    {
+        SegmentHeader segmentHeader;        ///< The segment-header.
+        std::int32_t dataSize{ 0 };         ///< The size of the attachment's data in bytes.
+        AttachmentEntry entry;              ///< The attachment-entry contained in the segment.
+        std::uint64_t dataOffset{ 0 };      ///< The file-position of the attachment's data.
+    };
+
+    /// Reads the segment-header at the specified file-position.
+    ///
+    /// \param [in] stream      The stream to read from.
+    /// \param      position    The file-position of the segment.
+    ///
+    /// \returns    The segment-header.
+    static SegmentHeader ReadSegmentHeader(libCZI::IStream* stream, std::uint64_t position);
+
+    /// Parses a segment-header from the specified buffer, which must contain (at least) kSegmentHeaderSize bytes.
+    ///
+    /// \param      buffer      The buffer containing the segment-header.
+    /// \param      position    The file-position of the segment (used for error messages).
+    ///
+    /// \returns    The segment-header.
+    static SegmentHeader ParseSegmentHeader(const std::uint8_t* buffer, std::uint64_t position);
+
+    /// Reads the header of the subblock-segment at the specified file-position. The segment-id is checked,
+    /// and it is checked that the sizes given in the header are consistent with the size of the segment, and
+    /// that the segment is within the file (if the file-size is known).
+    ///
+    /// \param [in] stream          The stream to read from.
+    /// \param      position        The file-position of the subblock-segment.
+    /// \param      total_file_size The size of the file in bytes, 0 meaning "unknown".
+    ///
+    /// \returns    Information about the layout of the subblock-segment.
+    static SubBlockSegmentInfo ReadSubBlockSegmentInfo(libCZI::IStream* stream, std::uint64_t position, std::uint64_t total_file_size);
+
+    /// Reads the file-header segment (at position 0) and gets the file-positions of the directories and of the
+    /// metadata segment from it.
+    ///
+    /// \param [in] stream  The stream to read from.
+    ///
+    /// \returns    Information from the file-header segment.
+    static FileHeaderInfo ReadFileHeaderInfo(libCZI::IStream* stream);
+
+    /// Reads the attachment-directory segment at the specified file-position. The segment-id is checked, and it is
+    /// checked that the entries fit into the segment, and that the segment is within the file (if the file-size is known).
+    ///
+    /// \param [in] stream          The stream to read from.
+    /// \param      position        The file-position of the attachment-directory segment.
+    /// \param      total_file_size The size of the file in bytes, 0 meaning "unknown".
+    ///
+    /// \returns    The entries of the attachment-directory.
+    static std::vector<AttachmentEntry> ReadAttachmentDirectory(libCZI::IStream* stream, std::uint64_t position, std::uint64_t total_file_size);
+
+    /// Reads the header of the attachment-segment at the specified file-position (i.e. the attachment's data is not read).
+    /// The segment-id is checked, and it is checked that the data fits into the segment, and that the segment is within
+    /// the file (if the file-size is known).
+    ///
+    /// \param [in] stream          The stream to read from.
+    /// \param      position        The file-position of the attachment-segment.
+    /// \param      total_file_size The size of the file in bytes, 0 meaning "unknown".
+    ///
+    /// \returns    Information about the attachment-segment.
+    static AttachmentSegmentInfo ReadAttachmentSegmentInfo(libCZI::IStream* stream, std::uint64_t position, std::uint64_t total_file_size);
+
+    /// Parses the header of an attachment-segment from the specified buffer, which must contain (at least)
+    /// kAttachmentSegmentHeaderReadSize bytes read from the file-position of the segment. The same checks as
+    /// with "ReadAttachmentSegmentInfo" are done.
+    ///
+    /// \param      buffer          The buffer containing the header of the attachment-segment.
+    /// \param      position        The file-position of the attachment-segment (used for checking and for error messages).
+    /// \param      total_file_size The size of the file in bytes, 0 meaning "unknown".
+    ///
+    /// \returns    Information about the attachment-segment.
+    static AttachmentSegmentInfo ParseAttachmentSegmentInfo(const std::uint8_t* buffer, std::uint64_t position, std::uint64_t total_file_size);
+
+    /// Reads ranges of the specified size at the specified file-positions (which must be sorted in ascending order),
+    /// and passes each of them to the specified functor. Ranges which are close to each other (i.e. which fit into
+    /// a range of the specified maximal size) are read with a single read-operation. If a range could not be read,
+    /// the functor is called with a null pointer for the data and with the error message.
+    ///
+    /// \param [in] stream          The stream to read from.
+    /// \param      positions       The file-positions (sorted in ascending order).
+    /// \param      size            The number of bytes to read at each file-position.
+    /// \param      max_batch_size  The maximal number of bytes to read with one read-operation.
+    /// \param      func            Functor which is called for each file-position (with the index in "positions", a pointer to
+    ///                             the data (or null) and the error message (or null)).
+    static void ReadBatched(
+        libCZI::IStream* stream,
+        const std::vector<std::uint64_t>& positions,
+        std::size_t size,
+        std::uint64_t max_batch_size,
+        const std::function<void(std::size_t, const std::uint8_t*, const char*)>& func);
+
+    /// Reads the specified range from the stream in chunks of the specified size, and passes each chunk to
+    /// the specified functor. Only a buffer of the chunk-size is allocated, so the memory usage is independent
+    /// of the size of the range. It is an error if the stream does not deliver the requested number of bytes.
+    ///
+    /// \param [in] stream      The stream to read from.
+    /// \param      offset      The file-position where to start reading.
+    /// \param      size        The number of bytes to read.
+    /// \param      chunk_size  The size of a chunk in bytes.
+    /// \param      func        Functor which is called for each chunk (with the file-position, a pointer to the data and the size
+    ///                         of the chunk). If it returns false, the operation is cancelled.
+    ///
+    /// \returns    True if the whole range was read; false if the operation was cancelled by the functor.
+    static bool ReadInChunks(
+        libCZI::IStream* stream,
+        std::uint64_t offset,
+        std::uint64_t size,
+        std::size_t chunk_size,
+        const std::function<bool(std::uint64_t, const void*, std::size_t)>& func);
+
+    /// Reads exactly the specified number of bytes from the stream. If less bytes are delivered, an exception is thrown.
+    ///
+    /// \param [in] stream      The stream to read from.
+    /// \param      offset      The file-position where to start reading.
+    /// \param [out] data       The destination buffer.
+    /// \param      size        The number of bytes to read.
+    static void ReadExactly(libCZI::IStream* stream, std::uint64_t offset, void* data, std::uint64_t size);
+
+    /// Gets a little-endian 32-bit integer from the specified buffer.
+    static std::int32_t GetInt32(const std::uint8_t* ptr);
+
+    /// Gets a little-endian 64-bit integer from the specified buffer.
+    static std::int64_t GetInt64(const std::uint8_t* ptr);
+};
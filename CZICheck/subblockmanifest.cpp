@@ -0,0 +1,215 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include <CZICheck_Config.h>
+#include "subblockmanifest.h"
+#include "utils.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace
+{
+    constexpr char kMagic[8] = { 'C', 'Z', 'I', 'C', 'H', 'K', 'M', 'F' };
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kHashAlgorithmXxHash64 = 1;
+    constexpr size_t kHeaderSize = 32;
+    constexpr size_t kEntrySize = 32;
+
+    void PutUInt32(uint8_t* ptr, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            ptr[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    void PutUInt64(uint8_t* ptr, uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            ptr[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    uint32_t GetUInt32(const uint8_t* ptr)
+    {
+        uint32_t value = 0;
+        for (int i = 3; i >= 0; --i)
+        {
+            value = (value << 8) | ptr[i];
+        }
+
+        return value;
+    }
+
+    uint64_t GetUInt64(const uint8_t* ptr)
+    {
+        uint64_t value = 0;
+        for (int i = 7; i >= 0; --i)
+        {
+            value = (value << 8) | ptr[i];
+        }
+
+        return value;
+    }
+
+#if CZICHECK_WIN32_ENVIRONMENT
+    const std::wstring& GetFileNameForStream(const std::wstring& filename)
+    {
+        return filename;
+    }
+#else
+    std::string GetFileNameForStream(const std::wstring& filename)
+    {
+        return convertToUtf8(filename);
+    }
+#endif
+}
+
+void CSubBlockManifest::SetReference(std::map<int, Entry> reference_entries)
+{
+    this->reference_entries_ = std::move(reference_entries);
+    this->has_reference_ = true;
+}
+
+CSubBlockManifest::VerifyResult CSubBlockManifest::AddEntry(const Entry& entry, Entry* reference_entry)
+{
+    if (!this->entries_.insert(make_pair(entry.index, entry)).second)
+    {
+        return VerifyResult::AlreadyAdded;
+    }
+
+    if (!this->has_reference_)
+    {
+        return VerifyResult::NoReference;
+    }
+
+    const auto iterator = this->reference_entries_.find(entry.index);
+    if (iterator == this->reference_entries_.cend())
+    {
+        return VerifyResult::NotInReference;
+    }
+
+    if (reference_entry != nullptr)
+    {
+        *reference_entry = iterator->second;
+    }
+
+    // note that the file position is not compared - if the file was rewritten, the subblocks may have been moved
+    return iterator->second.dataSize == entry.dataSize && iterator->second.hash == entry.hash ? VerifyResult::Match : VerifyResult::Mismatch;
+}
+
+std::vector<CSubBlockManifest::Entry> CSubBlockManifest::GetReferenceEntriesNotInFile(int subblock_count) const
+{
+    vector<Entry> entries;
+    for (auto iterator = this->reference_entries_.lower_bound(subblock_count); iterator != this->reference_entries_.cend(); ++iterator)
+    {
+        entries.push_back(iterator->second);
+    }
+
+    return entries;
+}
+
+bool CSubBlockManifest::TryClaimReportOfEntriesNotInFile()
+{
+    if (this->entries_not_in_file_claimed_)
+    {
+        return false;
+    }
+
+    this->entries_not_in_file_claimed_ = true;
+    return true;
+}
+
+/*static*/void CSubBlockManifest::WriteToFile(const std::wstring& filename, const std::map<int, Entry>& entries)
+{
+    ofstream file(GetFileNameForStream(filename), ios::binary | ios::trunc);
+    if (!file)
+    {
+        stringstream ss;
+        ss << "could not create the file \"" << convertToUtf8(filename) << "\"";
+        throw runtime_error(ss.str());
+    }
+
+    uint8_t header[kHeaderSize] = {};
+    memcpy(header, kMagic, sizeof(kMagic));
+    PutUInt32(header + 8, kVersion);
+    PutUInt32(header + 12, kHashAlgorithmXxHash64);
+    PutUInt64(header + 16, entries.size());
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    for (const auto& item : entries)
+    {
+        const auto& entry = item.second;
+        uint8_t buffer[kEntrySize] = {};
+        PutUInt32(buffer, static_cast<uint32_t>(entry.index));
+        PutUInt64(buffer + 8, entry.filePosition);
+        PutUInt64(buffer + 16, entry.dataSize);
+        PutUInt64(buffer + 24, entry.hash);
+        file.write(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+    }
+
+    file.flush();
+    if (!file)
+    {
+        stringstream ss;
+        ss << "error writing the file \"" << convertToUtf8(filename) << "\"";
+        throw runtime_error(ss.str());
+    }
+}
+
+/*static*/std::map<int, CSubBlockManifest::Entry> CSubBlockManifest::ReadFromFile(const std::wstring& filename)
+{
+    ifstream file(GetFileNameForStream(filename), ios::binary);
+    if (!file)
+    {
+        stringstream ss;
+        ss << "could not open the file \"" << convertToUtf8(filename) << "\"";
+        throw runtime_error(ss.str());
+    }
+
+    uint8_t header[kHeaderSize];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) || memcmp(header, kMagic, sizeof(kMagic)) != 0)
+    {
+        stringstream ss;
+        ss << "the file \"" << convertToUtf8(filename) << "\" is not a manifest file";
+        throw runtime_error(ss.str());
+    }
+
+    const uint32_t version = GetUInt32(header + 8);
+    const uint32_t hash_algorithm = GetUInt32(header + 12);
+    if (version != kVersion || hash_algorithm != kHashAlgorithmXxHash64)
+    {
+        stringstream ss;
+        ss << "the manifest file \"" << convertToUtf8(filename) << "\" has an unsupported version (" << version << ") or hash algorithm (" << hash_algorithm << ")";
+        throw runtime_error(ss.str());
+    }
+
+    const uint64_t entry_count = GetUInt64(header + 16);
+    map<int, Entry> entries;
+    for (uint64_t i = 0; i < entry_count; ++i)
+    {
+        uint8_t buffer[kEntrySize];
+        if (!file.read(reinterpret_cast<char*>(buffer), sizeof(buffer)))
+        {
+            stringstream ss;
+            ss << "the manifest file \"" << convertToUtf8(filename) << "\" is truncated (expected " << entry_count << " entries, found " << i << ")";
+            throw runtime_error(ss.str());
+        }
+
+        Entry entry;
+        entry.index = static_cast<int32_t>(GetUInt32(buffer));
+        entry.filePosition = GetUInt64(buffer + 8);
+        entry.dataSize = GetUInt64(buffer + 16);
+        entry.hash = GetUInt64(buffer + 24);
+        entries[entry.index] = entry;
+    }
+
+    return entries;
+}
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/// A manifest of the content of the subblocks of a CZI-file - for each subblock, the hash (XXH64) of its
+/// data (i.e. the pixel data as stored in the file, without the subblock-metadata and the attachment) is
+/// recorded. This allows for detecting modifications of the file (e.g. bit rot) by comparing the manifest
+/// of a later run against a manifest created earlier.
+/// The hashes are gathered by the checkers reading the subblock data anyway, so no additional read pass is
+/// required. If a reference manifest is given, each hash is compared against it when it is added.
+///
+/// The manifest is stored in a binary file with the following layout (all integers little-endian):
+/// - a header of 32 bytes: the magic "CZICHKMF" (8 bytes), the version (uint32, currently 1), the hash
+///   algorithm (uint32, 1 = XXH64 with seed 0), the number of entries (uint64) and 8 reserved bytes
+/// - followed by the entries, each of them 32 bytes: the subblock index (int32), 4 reserved bytes, the file position
+///   of the subblock segment (uint64), the size of the data (uint64) and the hash (uint64).
+class CSubBlockManifest
+{
+public:
+    /// An entry of the manifest.
+    struct Entry
+    {
+        std::int32_t index{ 0 };            ///< The index of the subblock.
+        std::uint64_t filePosition{ 0 };    ///< The file position of the subblock segment.
+        std::uint64_t dataSize{ 0 };        ///< The size of the subblock's data in bytes.
+        std::uint64_t hash{ 0 };            ///< The hash of the subblock's data.
+    };
+
+    /// Values that represent the result of comparing an entry with the reference manifest.
+    enum class VerifyResult
+    {
+        NoReference,    ///< There is no reference manifest.
+        Match,          ///< The entry matches the reference manifest.
+        Mismatch,       ///< The data size or the hash differs from the reference manifest.
+        NotInReference, ///< The subblock is not contained in the reference manifest.
+        AlreadyAdded,   ///< An entry for the subblock has already been added (and verified) before.
+    };
+private:
+    std::map<int, Entry> entries_;
+    std::map<int, Entry> reference_entries_;
+    bool has_reference_{ false };
+    bool entries_not_in_file_claimed_{ false };
+public:
+    /// Sets the reference manifest, against which entries are compared when they are added.
+    ///
+    /// \param  reference_entries   The entries of the reference manifest.
+    void SetReference(std::map<int, Entry> reference_entries);
+
+    /// Gets a boolean indicating whether a reference manifest is set.
+    [[nodiscard]] bool HasReference() const { return this->has_reference_; }
+
+    /// Adds an entry to the manifest, and compares it with the reference manifest (if there is one). If an entry
+    /// for the same subblock has already been added (e.g. by another checker), the existing entry is kept and
+    /// "AlreadyAdded" is returned - the result of the comparison has then already been reported.
+    ///
+    /// \param          entry           The entry to add.
+    /// \param [out]    reference_entry If non-null and the subblock is contained in the reference manifest, the entry
+    ///                                 of the reference manifest is put here.
+    ///
+    /// \returns    The result of comparing the entry with the reference manifest.
+    VerifyResult AddEntry(const Entry& entry, Entry* reference_entry);
+
+    /// Gets the entries of the reference manifest with a subblock index greater or equal to the specified number
+    /// of subblocks, i.e. the entries for subblocks which are not present in the file.
+    ///
+    /// \param  subblock_count  The number of subblocks in the file.
+    ///
+    /// \returns    The entries of the reference manifest which are not present in the file.
+    [[nodiscard]] std::vector<Entry> GetReferenceEntriesNotInFile(int subblock_count) const;
+
+    /// Claims the reporting of the entries of the reference manifest which are not present in the file - this
+    /// returns true only for the first call, so that those entries are reported only once (if several checkers
+    /// gather hashes).
+    ///
+    /// \returns    True if the caller is to report the entries not present in the file; false otherwise.
+    bool TryClaimReportOfEntriesNotInFile();
+
+    /// Gets the entries added so far.
+    [[nodiscard]] const std::map<int, Entry>& GetEntries() const { return this->entries_; }
+
+    /// Writes the specified entries to a manifest file. In case of an error, an exception is thrown.
+    ///
+    /// \param  filename    The filename of the manifest file.
+    /// \param  entries     The entries.
+    static void WriteToFile(const std::wstring& filename, const std::map<int, Entry>& entries);
+
+    /// Reads a manifest file. In case of an error (including a file with invalid content), an exception is thrown.
+    ///
+    /// \param  filename    The filename of the manifest file.
+    ///
+    /// \returns    The entries of the manifest.
+    static std::map<int, Entry> ReadFromFile(const std::wstring& filename);
+};
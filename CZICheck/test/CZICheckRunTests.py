@@ -140,10 +140,23 @@ def compare_result_of_test_to_knowngood(result: str, knowngood: str):
     return True
 
 
-def check_file(cmdline_parameters: Parameters, input_stream_classname: Optional[str], input_stream_parameters: Optional[str], czi_filename: str, expected_result_file: str, expected_returncode: int):
+# Those checkers are excluded from the test-runs because there are no known-good results for them yet. Once the
+# known-good results have been re-created (with the option 'outputsavepath') and reviewed, the respective checker
+# is to be removed from this list.
+checkers_without_known_good_results = ['subblkpixelcontent', 'componentbitcountcontent', 'subblkcontentunique', 'pyramidcontent', 'tileoverlap', 'consistentmindex', 'attachmentsegmentsvalid', 'segmentextents', 'filelayout', 'pyramidcompleteness', 'subblksizes']
+
+
+def build_checks_argument(excluded_checkers: Optional[str]):
+    checkers_to_exclude = checkers_without_known_good_results[:]
+    if excluded_checkers and not excluded_checkers.isspace():
+        checkers_to_exclude.extend(excluded_checkers.split())
+    return ','.join(['all'] + ['-' + checker for checker in checkers_to_exclude])
+
+
+def check_file(cmdline_parameters: Parameters, input_stream_classname: Optional[str], input_stream_parameters: Optional[str], structured_output_excluded_checkers: Optional[str], czi_filename: str, expected_result_file: str, expected_returncode: int):
     cmdlineargs = [cmdline_parameters.get_fully_qualified_czicheck_executable(), '-s',
                    cmdline_parameters.build_fully_qualified_czi_filename(czi_filename),
-                   '-c','all', '--laxparsing', 'true']
+                   '--laxparsing', 'true']
 
     # add source stream class argument when provided
     if input_stream_classname and not input_stream_classname.isspace():
@@ -156,6 +169,9 @@ def check_file(cmdline_parameters: Parameters, input_stream_classname: Optional[
 
     for i, encoding in enumerate(testouput_encoding_list):
         current_cmd_args = cmdlineargs[:]
+        # the text output does not contain the details of the findings, so the checkers excluded for the structured
+        #  output are run for the text output
+        current_cmd_args.extend(['-c', build_checks_argument(structured_output_excluded_checkers if encoding != "text" else None)])
         current_cmd_args.append("-e")
         current_cmd_args.append(encoding)
 
@@ -199,7 +215,7 @@ with open(parameters.get_fully_qualified_testlist_filename()) as csv_file:
     for row in csv_reader:
         if row['czifilename'] and not row['czifilename'].isspace() and not row['czifilename'].startswith('#'):
             numberOfTests = numberOfTests + 1
-            testOk = check_file(parameters, row['optional_inputstreamclassname'], row['optional_inputstreamparameters'], row['czifilename'], row['known_good_output'],
+            testOk = check_file(parameters, row['optional_inputstreamclassname'], row['optional_inputstreamparameters'], row.get('optional_structuredoutput_excludedcheckers'), row['czifilename'], row['known_good_output'],
                                 int(row['expected_return_code']))
             if not testOk:
                 numberOfFailedTests = numberOfFailedTests + 1
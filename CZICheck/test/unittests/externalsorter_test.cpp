@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "unittest.h"
+#include "../../checkers/externalsorter.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    vector<uint64_t> SortWithExternalSorter(const vector<uint64_t>& items, size_t max_items_in_memory, size_t* number_of_spilled_runs)
+    {
+        CExternalSorter<uint64_t> sorter(max_items_in_memory);
+        for (const auto item : items)
+        {
+            sorter.Add(item);
+        }
+
+        *number_of_spilled_runs = sorter.GetNumberOfSpilledRuns();
+        vector<uint64_t> sorted;
+        sorter.Enumerate(
+            [&](const uint64_t& item)->bool
+            {
+                sorted.push_back(item);
+                return true;
+            });
+
+        return sorted;
+    }
+}
+
+CZICHECK_TEST(ExternalSorter_InMemory)
+{
+    const vector<uint64_t> items = { 5, 3, 9, 3, 1 };
+    size_t number_of_spilled_runs;
+    const auto sorted = SortWithExternalSorter(items, 100, &number_of_spilled_runs);
+    CZICHECK_EXPECT(number_of_spilled_runs == 0);
+    CZICHECK_EXPECT((sorted == vector<uint64_t>{ 1, 3, 3, 5, 9 }));
+}
+
+CZICHECK_TEST(ExternalSorter_WithRuns)
+{
+    mt19937_64 random_engine(1);
+    vector<uint64_t> items(100000);
+    for (auto& item : items)
+    {
+        item = random_engine() % 50000;
+    }
+
+    auto expected = items;
+    sort(expected.begin(), expected.end());
+
+    // with 1000 items in memory, there are more runs than the maximum number of runs, so runs are merged in between
+    for (const size_t max_items_in_memory : { 1000, 7777, 60000 })
+    {
+        size_t number_of_spilled_runs;
+        const auto sorted = SortWithExternalSorter(items, max_items_in_memory, &number_of_spilled_runs);
+        CZICHECK_EXPECT(number_of_spilled_runs > 0);
+        CZICHECK_EXPECT(sorted == expected);
+    }
+}
+
+CZICHECK_TEST(ExternalSorter_EnumerationCanBeCancelled)
+{
+    CExternalSorter<uint64_t> sorter(10);
+    for (uint64_t i = 100; i > 0; --i)
+    {
+        sorter.Add(i);
+    }
+
+    vector<uint64_t> enumerated;
+    sorter.Enumerate(
+        [&](const uint64_t& item)->bool
+        {
+            enumerated.push_back(item);
+            return enumerated.size() < 3;
+        });
+
+    CZICHECK_EXPECT((enumerated == vector<uint64_t>{ 1, 2, 3 }));
+}
+
+CZICHECK_TEST(ExternalSorter_UsesSpecifiedTempDirectory)
+{
+    const auto temp_directory = filesystem::temp_directory_path() / "czicheck_unittest_externalsorter";
+    filesystem::remove_all(temp_directory);
+    filesystem::create_directory(temp_directory);
+
+    {
+        CExternalSorter<uint64_t> sorter(10, temp_directory);
+        for (uint64_t i = 100; i > 0; --i)
+        {
+            sorter.Add(i);
+        }
+
+        CZICHECK_EXPECT(sorter.GetNumberOfSpilledRuns() > 0);
+        uint64_t expected = 1;
+        bool in_order = true;
+        sorter.Enumerate(
+            [&](const uint64_t& item)->bool
+            {
+                in_order = in_order && item == expected++;
+                return true;
+            });
+        CZICHECK_EXPECT(in_order && expected == 101);
+    }
+
+    // the temporary files are removed once they are closed
+    CZICHECK_EXPECT(filesystem::is_empty(temp_directory));
+    filesystem::remove_all(temp_directory);
+}
+
+CZICHECK_TEST(ExternalSorter_NonExistingTempDirectoryGivesException)
+{
+    const auto temp_directory = filesystem::temp_directory_path() / "czicheck_unittest_does_not_exist";
+    filesystem::remove_all(temp_directory);
+
+    CExternalSorter<uint64_t> sorter(10, temp_directory);
+    bool exception_thrown = false;
+    try
+    {
+        for (uint64_t i = 0; i < 100; ++i)
+        {
+            sorter.Add(i);
+        }
+    }
+    catch (ExternalSorterException&)
+    {
+        exception_thrown = true;
+    }
+
+    CZICHECK_EXPECT(exception_thrown);
+}
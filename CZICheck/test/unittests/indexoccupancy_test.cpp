@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "unittest.h"
+#include "../../checkers/indexoccupancy.h"
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    vector<pair<int, int>> GetRangesOfSet(const set<int>& values)
+    {
+        vector<pair<int, int>> ranges;
+        for (const int value : values)
+        {
+            if (!ranges.empty() && static_cast<int64_t>(ranges.back().second) + 1 == value)
+            {
+                ranges.back().second = value;
+            }
+            else
+            {
+                ranges.emplace_back(value, value);
+            }
+        }
+
+        return ranges;
+    }
+}
+
+CZICHECK_TEST(IndexOccupancy_DenseIndices)
+{
+    CIndexOccupancy occupancy(10);
+    for (const int index : { 10, 11, 12, 15, 15, 17, 18 })
+    {
+        occupancy.Add(index);
+    }
+
+    CZICHECK_EXPECT(occupancy.GetCount() == 7);
+    CZICHECK_EXPECT(occupancy.GetDistinctCount() == 6);
+    CZICHECK_EXPECT(occupancy.GetMinimum() == 10 && occupancy.GetMaximum() == 18);
+    CZICHECK_EXPECT((occupancy.GetRanges() == vector<pair<int, int>>{ { 10, 12 }, { 15, 15 }, { 17, 18 } }));
+    CZICHECK_EXPECT((occupancy.GetMissingRanges(10, 20) == vector<pair<int, int>>{ { 13, 14 }, { 16, 16 }, { 19, 20 } }));
+    CZICHECK_EXPECT((occupancy.GetMissingRanges(8, 12) == vector<pair<int, int>>{ { 8, 9 } }));
+    CZICHECK_EXPECT(occupancy.GetMissingRanges(10, 12).empty());
+}
+
+CZICHECK_TEST(IndexOccupancy_AddReportsWhetherIndexIsNew)
+{
+    CIndexOccupancy occupancy;
+    CZICHECK_EXPECT(occupancy.Add(3));
+    CZICHECK_EXPECT(!occupancy.Add(3));
+    CZICHECK_EXPECT(occupancy.Add(1000000));    // switches to sparse mode
+    CZICHECK_EXPECT(!occupancy.Add(3));
+    CZICHECK_EXPECT(!occupancy.Add(1000000));
+    CZICHECK_EXPECT(occupancy.Add(-5));
+    CZICHECK_EXPECT(occupancy.GetDistinctCount() == 3);
+}
+
+CZICHECK_TEST(IndexOccupancy_SparseIndicesAreMergedIntoIntervals)
+{
+    CIndexOccupancy occupancy;
+    for (const int index : { 1000000, 1000002, 1000001, 999999, 5, 1000002, 7, 6 })
+    {
+        occupancy.Add(index);
+    }
+
+    CZICHECK_EXPECT((occupancy.GetRanges() == vector<pair<int, int>>{ { 5, 7 }, { 999999, 1000002 } }));
+    CZICHECK_EXPECT((occupancy.GetMissingRanges(0, 1000003) == vector<pair<int, int>>{ { 0, 4 }, { 8, 999998 }, { 1000003, 1000003 } }));
+}
+
+CZICHECK_TEST(IndexOccupancy_CompareWithSet)
+{
+    mt19937 random_engine(42);
+    for (int iteration = 0; iteration < 500; ++iteration)
+    {
+        const int origin = static_cast<int>(random_engine() % 20) - 10;
+        const int spread = iteration % 2 == 0 ? 100 : 100000;
+        CIndexOccupancy occupancy(origin);
+        set<int> expected;
+        for (int i = 0; i < 300; ++i)
+        {
+            const int index = origin + static_cast<int>(random_engine() % spread) - 5;
+            CZICHECK_EXPECT(occupancy.Add(index) == expected.insert(index).second);
+        }
+
+        CZICHECK_EXPECT(occupancy.GetDistinctCount() == expected.size());
+        CZICHECK_EXPECT(occupancy.GetRanges() == GetRangesOfSet(expected));
+    }
+}
+
+CZICHECK_TEST(IndexOccupancy_FormatRanges)
+{
+    CZICHECK_EXPECT(CIndexOccupancy::FormatRanges({}, 20).empty());
+    CZICHECK_EXPECT(CIndexOccupancy::FormatRanges({ { 1, 3 }, { 7, 7 } }, 20) == "1-3, 7");
+    CZICHECK_EXPECT(CIndexOccupancy::FormatRanges({ { 1, 3 }, { 7, 7 }, { 9, 12 }, { 20, 20 } }, 2) == "1-3, 7, ... (2 more ranges)");
+}
@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "unittest.h"
+#include "../../checkers/rectangleoverlap.h"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace libCZI;
+
+namespace
+{
+    bool Overlap(const IntRect& a, const IntRect& b)
+    {
+        return a.w > 0 && a.h > 0 && b.w > 0 && b.h > 0 &&
+            a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+    }
+
+    vector<CRectangleOverlap::Rectangle> CreateRandomRectangles(mt19937& random_engine, int count, int first_id)
+    {
+        vector<CRectangleOverlap::Rectangle> rectangles;
+        for (int i = 0; i < count; ++i)
+        {
+            IntRect rect;
+            rect.x = static_cast<int>(random_engine() % 200) - 50;
+            rect.y = static_cast<int>(random_engine() % 200) - 50;
+            rect.w = static_cast<int>(random_engine() % 40);
+            rect.h = static_cast<int>(random_engine() % 40);
+            rectangles.push_back(CRectangleOverlap::Rectangle{ first_id + i, rect });
+        }
+
+        return rectangles;
+    }
+}
+
+CZICHECK_TEST(RectangleOverlap_SimpleCases)
+{
+    const vector<CRectangleOverlap::Rectangle> rectangles =
+    {
+        { 1, IntRect{ 0, 0, 10, 10 } },
+        { 2, IntRect{ 10, 0, 10, 10 } },  // touches #1, does not overlap
+        { 3, IntRect{ 5, 5, 10, 10 } },   // overlaps #1 and #2
+        { 4, IntRect{ 100, 100, 0, 10 } },  // empty
+    };
+
+    vector<tuple<int, int, int, int, int, int>> pairs;
+    CRectangleOverlap::EnumOverlappingPairs(
+        rectangles,
+        [&](int id1, int id2, const IntRect& intersection)->bool
+        {
+            pairs.emplace_back(min(id1, id2), max(id1, id2), intersection.x, intersection.y, intersection.w, intersection.h);
+            return true;
+        });
+
+    sort(pairs.begin(), pairs.end());
+    CZICHECK_EXPECT((pairs == vector<tuple<int, int, int, int, int, int>>{ { 1, 3, 5, 5, 5, 5 }, { 2, 3, 10, 5, 5, 5 } }));
+}
+
+CZICHECK_TEST(RectangleOverlap_CompareWithBruteForce)
+{
+    mt19937 random_engine(4711);
+    for (int iteration = 0; iteration < 100; ++iteration)
+    {
+        const auto rectangles1 = CreateRandomRectangles(random_engine, 60, 0);
+        const auto rectangles2 = CreateRandomRectangles(random_engine, 40, 1000);
+
+        set<pair<int, int>> expected_within;
+        for (size_t i = 0; i < rectangles1.size(); ++i)
+        {
+            for (size_t j = i + 1; j < rectangles1.size(); ++j)
+            {
+                if (Overlap(rectangles1[i].rect, rectangles1[j].rect))
+                {
+                    expected_within.emplace(rectangles1[i].id, rectangles1[j].id);
+                }
+            }
+        }
+
+        set<pair<int, int>> expected_between;
+        for (const auto& a : rectangles1)
+        {
+            for (const auto& b : rectangles2)
+            {
+                if (Overlap(a.rect, b.rect))
+                {
+                    expected_between.emplace(a.id, b.id);
+                }
+            }
+        }
+
+        set<pair<int, int>> within;
+        CRectangleOverlap::EnumOverlappingPairs(
+            rectangles1,
+            [&](int id1, int id2, const IntRect&)->bool
+            {
+                CZICHECK_EXPECT(within.emplace(min(id1, id2), max(id1, id2)).second);
+                return true;
+            });
+
+        set<pair<int, int>> between;
+        CRectangleOverlap::EnumOverlappingPairs(
+            rectangles1,
+            rectangles2,
+            [&](int id1, int id2, const IntRect&)->bool
+            {
+                CZICHECK_EXPECT(between.emplace(id1, id2).second);
+                return true;
+            });
+
+        CZICHECK_EXPECT(within == expected_within);
+        CZICHECK_EXPECT(between == expected_between);
+    }
+}
+
+CZICHECK_TEST(RectangleOverlap_Coverage)
+{
+    const vector<CRectangleOverlap::Rectangle> rectangles =
+    {
+        { 1, IntRect{ 0, 0, 10, 10 } },
+        { 2, IntRect{ 5, 5, 10, 10 } },
+        { 3, IntRect{ 6, 6, 2, 2 } },
+    };
+
+    const auto statistics = CRectangleOverlap::CalculateCoverage(rectangles);
+    CZICHECK_EXPECT(statistics.totalArea == 204);
+    CZICHECK_EXPECT(statistics.coveredArea == 175);
+    CZICHECK_EXPECT(statistics.multiplyCoveredArea == 25);
+    CZICHECK_EXPECT(statistics.maximumDepth == 3);
+}
@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "unittest.h"
+#include "../../subblockmanifest.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+    /// A temporary file, which is deleted when the object is destroyed.
+    class CTemporaryFile
+    {
+    private:
+        filesystem::path path_;
+    public:
+        explicit CTemporaryFile(const char* name)
+            : path_(filesystem::temp_directory_path() / name)
+        {
+        }
+
+        ~CTemporaryFile()
+        {
+            error_code error_code;
+            filesystem::remove(this->path_, error_code);
+        }
+
+        [[nodiscard]] wstring GetFilename() const { return this->path_.wstring(); }
+        [[nodiscard]] const filesystem::path& GetPath() const { return this->path_; }
+    };
+
+    CSubBlockManifest::Entry CreateEntry(int32_t index, uint64_t hash)
+    {
+        CSubBlockManifest::Entry entry;
+        entry.index = index;
+        entry.filePosition = 1024 * static_cast<uint64_t>(index);
+        entry.dataSize = 512 + static_cast<uint64_t>(index);
+        entry.hash = hash;
+        return entry;
+    }
+}
+
+CZICHECK_TEST(SubBlockManifest_RoundTrip)
+{
+    map<int, CSubBlockManifest::Entry> entries;
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        entries[i] = CreateEntry(i, UINT64_C(0x0123456789abcdef) * static_cast<uint64_t>(i + 1));
+    }
+
+    const CTemporaryFile file("czicheck_unittest_manifest.bin");
+    CSubBlockManifest::WriteToFile(file.GetFilename(), entries);
+    const auto entries_read = CSubBlockManifest::ReadFromFile(file.GetFilename());
+
+    CZICHECK_EXPECT(entries_read.size() == entries.size());
+    for (const auto& item : entries)
+    {
+        const auto iterator = entries_read.find(item.first);
+        CZICHECK_EXPECT(iterator != entries_read.cend());
+        CZICHECK_EXPECT(iterator->second.index == item.second.index);
+        CZICHECK_EXPECT(iterator->second.filePosition == item.second.filePosition);
+        CZICHECK_EXPECT(iterator->second.dataSize == item.second.dataSize);
+        CZICHECK_EXPECT(iterator->second.hash == item.second.hash);
+    }
+}
+
+CZICHECK_TEST(SubBlockManifest_InvalidFileIsRejected)
+{
+    const CTemporaryFile file("czicheck_unittest_not_a_manifest.bin");
+    {
+        ofstream stream(file.GetPath(), ios::binary | ios::trunc);
+        stream << "this is not a manifest file, but it is long enough for the header";
+    }
+
+    bool exception_thrown = false;
+    try
+    {
+        CSubBlockManifest::ReadFromFile(file.GetFilename());
+    }
+    catch (runtime_error&)
+    {
+        exception_thrown = true;
+    }
+
+    CZICHECK_EXPECT(exception_thrown);
+}
+
+CZICHECK_TEST(SubBlockManifest_VerifyAgainstReference)
+{
+    map<int, CSubBlockManifest::Entry> reference;
+    reference[0] = CreateEntry(0, 10);
+    reference[1] = CreateEntry(1, 11);
+    reference[5] = CreateEntry(5, 15);
+
+    CSubBlockManifest manifest;
+    CZICHECK_EXPECT(manifest.AddEntry(CreateEntry(0, 10), nullptr) == CSubBlockManifest::VerifyResult::NoReference);
+
+    CSubBlockManifest verifying_manifest;
+    verifying_manifest.SetReference(reference);
+    CSubBlockManifest::Entry reference_entry;
+    CZICHECK_EXPECT(verifying_manifest.AddEntry(CreateEntry(0, 10), &reference_entry) == CSubBlockManifest::VerifyResult::Match);
+    CZICHECK_EXPECT(verifying_manifest.AddEntry(CreateEntry(1, 99), &reference_entry) == CSubBlockManifest::VerifyResult::Mismatch);
+    CZICHECK_EXPECT(reference_entry.hash == 11);
+    CZICHECK_EXPECT(verifying_manifest.AddEntry(CreateEntry(2, 12), &reference_entry) == CSubBlockManifest::VerifyResult::NotInReference);
+    CZICHECK_EXPECT(verifying_manifest.AddEntry(CreateEntry(1, 11), &reference_entry) == CSubBlockManifest::VerifyResult::AlreadyAdded);
+
+    const auto not_in_file = verifying_manifest.GetReferenceEntriesNotInFile(3);
+    CZICHECK_EXPECT(not_in_file.size() == 1 && not_in_file[0].index == 5);
+    CZICHECK_EXPECT(verifying_manifest.TryClaimReportOfEntriesNotInFile());
+    CZICHECK_EXPECT(!verifying_manifest.TryClaimReportOfEntriesNotInFile());
+}
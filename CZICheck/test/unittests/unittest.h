@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// A minimal framework for the unit tests of CZICheck's building blocks (so that no additional dependency is
+/// required). A test is a function defined with "CZICHECK_TEST", which registers it with the test runner. Within a
+/// test, the conditions are checked with "CZICHECK_EXPECT" - if a condition is not met, an exception is thrown,
+/// the test is reported as failed and the runner continues with the next test.
+namespace UnitTest
+{
+    /// A registered test.
+    struct TestCase
+    {
+        const char* name;
+        void (*function)();
+    };
+
+    /// Gets the list of all registered tests.
+    std::vector<TestCase>& GetTestCases();
+
+    /// Helper for registering a test (at static initialization).
+    struct TestRegistration
+    {
+        TestRegistration(const char* name, void (*function)())
+        {
+            GetTestCases().push_back(TestCase{ name, function });
+        }
+    };
+
+    /// The exception thrown if a condition is not met.
+    class TestFailure : public std::runtime_error
+    {
+    public:
+        explicit TestFailure(const std::string& message) : std::runtime_error(message) {}
+    };
+
+    [[noreturn]] inline void Fail(const char* condition, const char* file, int line)
+    {
+        std::stringstream ss;
+        ss << file << "(" << line << "): condition not met: " << condition;
+        throw TestFailure(ss.str());
+    }
+}
+
+#define CZICHECK_TEST(test_name) \
+    static void test_name(); \
+    static const UnitTest::TestRegistration test_name##_registration(#test_name, &test_name); \
+    static void test_name()
+
+#define CZICHECK_EXPECT(condition) \
+    do { if (!(condition)) { UnitTest::Fail(#condition, __FILE__, __LINE__); } } while (false)
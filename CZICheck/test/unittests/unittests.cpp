@@ -0,0 +1,36 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "unittest.h"
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+std::vector<UnitTest::TestCase>& UnitTest::GetTestCases()
+{
+    static vector<TestCase> test_cases;
+    return test_cases;
+}
+
+int main()
+{
+    int number_of_failed_tests = 0;
+    for (const auto& test_case : UnitTest::GetTestCases())
+    {
+        try
+        {
+            test_case.function();
+            cout << "[  OK  ] " << test_case.name << endl;
+        }
+        catch (exception& ex)
+        {
+            cout << "[FAILED] " << test_case.name << " : " << ex.what() << endl;
+            ++number_of_failed_tests;
+        }
+    }
+
+    cout << endl << UnitTest::GetTestCases().size() << " tests, " << number_of_failed_tests << " failed" << endl;
+    return number_of_failed_tests == 0 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "unittest.h"
+#include "../../xxhash64.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    vector<uint8_t> CreateTestData(size_t size)
+    {
+        vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            data[i] = static_cast<uint8_t>(i * 31 + 7);
+        }
+
+        return data;
+    }
+}
+
+CZICHECK_TEST(XxHash64_ReferenceVectors)
+{
+    // the reference values are from the reference implementation of XXH64
+    CZICHECK_EXPECT(CXxHash64::Calculate("", 0) == UINT64_C(0xef46db3751d8e999));
+    CZICHECK_EXPECT(CXxHash64::Calculate("a", 1) == UINT64_C(0xd24ec4f1a98c6e5b));
+    CZICHECK_EXPECT(CXxHash64::Calculate("abc", 3) == UINT64_C(0x44bc2cf5ad770999));
+
+    const char* text = "Nobody inspects the spammish repetition";
+    CZICHECK_EXPECT(CXxHash64::Calculate(text, strlen(text)) == UINT64_C(0xfbcea83c8a378bf1));
+    CZICHECK_EXPECT(CXxHash64::Calculate(text, strlen(text), 20141025) == UINT64_C(0xce06936136852706));
+
+    const auto data = CreateTestData(1000);
+    CZICHECK_EXPECT(CXxHash64::Calculate(data.data(), data.size()) == UINT64_C(0x99594f4828043d35));
+    CZICHECK_EXPECT(CXxHash64::Calculate(data.data(), data.size(), UINT64_C(0x123456789abcdef0)) == UINT64_C(0x14b8890631358a20));
+}
+
+CZICHECK_TEST(XxHash64_IncrementalUpdateGivesSameResult)
+{
+    const auto data = CreateTestData(1000);
+    const uint64_t expected = CXxHash64::Calculate(data.data(), data.size());
+    for (const size_t piece_size : { 1, 3, 7, 31, 32, 33, 100, 999 })
+    {
+        CXxHash64 hash;
+        for (size_t offset = 0; offset < data.size(); offset += piece_size)
+        {
+            hash.Update(data.data() + offset, min(piece_size, data.size() - offset));
+        }
+
+        CZICHECK_EXPECT(hash.GetDigest() == expected);
+    }
+
+    CXxHash64 hash;
+    hash.Update(data.data(), 500);
+    hash.Reset();
+    hash.Update(data.data(), data.size());
+    CZICHECK_EXPECT(hash.GetDigest() == expected);
+}
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+// This is a build-time tool: it parses an XSD-schema into a Xerces grammar pool and writes the pool
+//  in Xerces' binary serialization format to a file. CZICheck embeds this file, so that the grammar
+//  does not have to be created from the XSD-schema at runtime.
+// Usage: CZICheckXsdGrammarSerializer <xsd-file> <output-file>
+
+#include <iostream>
+#include <memory>
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLException.hpp>
+#include <xercesc/internal/BinFileOutputStream.hpp>
+#include <xercesc/internal/XMLGrammarPoolImpl.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/framework/LocalFileInputSource.hpp>
+#include <xercesc/validators/common/Grammar.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+namespace
+{
+    int SerializeGrammar(const char* xsd_filename, const char* output_filename)
+    {
+        XMLGrammarPoolImpl grammar_pool(XMLPlatformUtils::fgMemoryManager);
+        {
+            XercesDOMParser parser(nullptr, XMLPlatformUtils::fgMemoryManager, &grammar_pool);
+            parser.setDoNamespaces(true);
+            parser.setDoSchema(true);
+            parser.setDisableDefaultEntityResolution(true);
+
+            const std::unique_ptr<XMLCh, void(*)(XMLCh*)> xsd_filename_xmlch(XMLString::transcode(xsd_filename), [](XMLCh* p)->void {XMLString::release(&p); });
+            const LocalFileInputSource xsd_source(xsd_filename_xmlch.get());
+            if (parser.loadGrammar(xsd_source, Grammar::SchemaGrammarType, true) == nullptr || parser.getErrorCount() != 0)
+            {
+                std::cerr << "Could not load the XSD-schema \"" << xsd_filename << "\"" << std::endl;
+                return 1;
+            }
+        }
+
+        // the pool must be locked for serialization
+        grammar_pool.lockPool();
+        BinFileOutputStream output_stream(output_filename);
+        if (!output_stream.getIsOpen())
+        {
+            std::cerr << "Could not open the output file \"" << output_filename << "\"" << std::endl;
+            return 1;
+        }
+
+        grammar_pool.serializeGrammars(&output_stream);
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <xsd-file> <output-file>" << std::endl;
+        return 1;
+    }
+
+    XMLPlatformUtils::Initialize();
+    int return_code;
+    try
+    {
+        return_code = SerializeGrammar(argv[1], argv[2]);
+    }
+    catch (const XMLException& exception)
+    {
+        const std::unique_ptr<char, void(*)(char*)> message(XMLString::transcode(exception.getMessage()), [](char* p)->void {XMLString::release(&p); });
+        std::cerr << "Error: " << message.get() << std::endl;
+        return_code = 1;
+    }
+
+    XMLPlatformUtils::Terminate();
+    return return_code;
+}
@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#include "xxhash64.h"
+#include <cstring>
+
+using namespace std;
+
+namespace
+{
+    constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+    constexpr size_t kStripeSize = 32;
+
+    inline uint64_t RotateLeft(uint64_t value, int count)
+    {
+        return (value << count) | (value >> (64 - count));
+    }
+
+    // the input is interpreted as little-endian (irrespective of the host's byte order), and compilers
+    //  turn this into a simple load on little-endian hosts
+    inline uint64_t ReadUInt64(const uint8_t* ptr)
+    {
+        return static_cast<uint64_t>(ptr[0]) | (static_cast<uint64_t>(ptr[1]) << 8) |
+            (static_cast<uint64_t>(ptr[2]) << 16) | (static_cast<uint64_t>(ptr[3]) << 24) |
+            (static_cast<uint64_t>(ptr[4]) << 32) | (static_cast<uint64_t>(ptr[5]) << 40) |
+            (static_cast<uint64_t>(ptr[6]) << 48) | (static_cast<uint64_t>(ptr[7]) << 56);
+    }
+
+    inline uint32_t ReadUInt32(const uint8_t* ptr)
+    {
+        return static_cast<uint32_t>(ptr[0]) | (static_cast<uint32_t>(ptr[1]) << 8) |
+            (static_cast<uint32_t>(ptr[2]) << 16) | (static_cast<uint32_t>(ptr[3]) << 24);
+    }
+
+    inline uint64_t Round(uint64_t accumulator, uint64_t input)
+    {
+        accumulator += input * kPrime2;
+        accumulator = RotateLeft(accumulator, 31);
+        return accumulator * kPrime1;
+    }
+
+    inline uint64_t MergeAccumulator(uint64_t hash, uint64_t accumulator)
+    {
+        hash ^= Round(0, accumulator);
+        return hash * kPrime1 + kPrime4;
+    }
+}
+
+CXxHash64::CXxHash64(std::uint64_t seed) : seed_(seed)
+{
+    this->Reset();
+}
+
+void CXxHash64::Reset()
+{
+    this->accumulators_[0] = this->seed_ + kPrime1 + kPrime2;
+    this->accumulators_[1] = this->seed_ + kPrime2;
+    this->accumulators_[2] = this->seed_;
+    this->accumulators_[3] = this->seed_ - kPrime1;
+    this->total_length_ = 0;
+    this->buffer_size_ = 0;
+}
+
+void CXxHash64::ProcessStripe(const std::uint8_t* stripe)
+{
+    this->accumulators_[0] = Round(this->accumulators_[0], ReadUInt64(stripe));
+    this->accumulators_[1] = Round(this->accumulators_[1], ReadUInt64(stripe + 8));
+    this->accumulators_[2] = Round(this->accumulators_[2], ReadUInt64(stripe + 16));
+    this->accumulators_[3] = Round(this->accumulators_[3], ReadUInt64(stripe + 24));
+}
+
+void CXxHash64::Update(const void* data, std::size_t size)
+{
+    const uint8_t* ptr = static_cast<const uint8_t*>(data);
+    this->total_length_ += size;
+
+    // first, complete a partially filled stripe from a previous call
+    if (this->buffer_size_ > 0)
+    {
+        const size_t bytes_to_copy = (size < kStripeSize - this->buffer_size_) ? size : kStripeSize - this->buffer_size_;
+        memcpy(this->buffer_ + this->buffer_size_, ptr, bytes_to_copy);
+        this->buffer_size_ += bytes_to_copy;
+        ptr += bytes_to_copy;
+        size -= bytes_to_copy;
+        if (this->buffer_size_ < kStripeSize)
+        {
+            return;
+        }
+
+        this->ProcessStripe(this->buffer_);
+        this->buffer_size_ = 0;
+    }
+
+    // the bulk of the data is processed directly from the caller's buffer - the four accumulators are
+    //  independent of each other, which allows the CPU to process them in parallel
+    while (size >= kStripeSize)
+    {
+        this->ProcessStripe(ptr);
+        ptr += kStripeSize;
+        size -= kStripeSize;
+    }
+
+    if (size > 0)
+    {
+        memcpy(this->buffer_, ptr, size);
+        this->buffer_size_ = size;
+    }
+}
+
+std::uint64_t CXxHash64::GetDigest() const
+{
+    uint64_t hash;
+    if (this->total_length_ >= kStripeSize)
+    {
+        hash = RotateLeft(this->accumulators_[0], 1) + RotateLeft(this->accumulators_[1], 7) +
+            RotateLeft(this->accumulators_[2], 12) + RotateLeft(this->accumulators_[3], 18);
+        hash = MergeAccumulator(hash, this->accumulators_[0]);
+        hash = MergeAccumulator(hash, this->accumulators_[1]);
+        hash = MergeAccumulator(hash, this->accumulators_[2]);
+        hash = MergeAccumulator(hash, this->accumulators_[3]);
+    }
+    else
+    {
+        hash = this->seed_ + kPrime5;
+    }
+
+    hash += this->total_length_;
+
+    // process the remaining bytes (less than a stripe)
+    const uint8_t* ptr = this->buffer_;
+    const uint8_t* const end = this->buffer_ + this->buffer_size_;
+    while (ptr + 8 <= end)
+    {
+        hash ^= Round(0, ReadUInt64(ptr));
+        hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+        ptr += 8;
+    }
+
+    if (ptr + 4 <= end)
+    {
+        hash ^= static_cast<uint64_t>(ReadUInt32(ptr)) * kPrime1;
+        hash = RotateLeft(hash, 23) * kPrime2 + kPrime3;
+        ptr += 4;
+    }
+
+    while (ptr < end)
+    {
+        hash ^= static_cast<uint64_t>(*ptr) * kPrime5;
+        hash = RotateLeft(hash, 11) * kPrime1;
+        ++ptr;
+    }
+
+    // final avalanche
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+/*static*/std::uint64_t CXxHash64::Calculate(const void* data, std::size_t size, std::uint64_t seed)
+{
+    CXxHash64 hash(seed);
+    hash.Update(data, size);
+    return hash.GetDigest();
+}
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/// An implementation of the 64-bit hash function "XXH64" (as specified at https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md).
+/// It is a fast non-cryptographic hash, suitable for detecting accidental modifications of data (like bit rot). The hash
+/// can be computed incrementally, i.e. the data may be passed in in arbitrary pieces, and the result is the same as if
+/// the data was passed in as a whole.
+class CXxHash64
+{
+private:
+    std::uint64_t accumulators_[4];
+    std::uint64_t total_length_;
+    std::uint8_t buffer_[32];
+    std::size_t buffer_size_;
+    std::uint64_t seed_;
+public:
+    /// Constructor.
+    ///
+    /// \param  seed    The seed of the hash.
+    explicit CXxHash64(std::uint64_t seed = 0);
+
+    /// Resets the state, so that a new hash can be computed.
+    void Reset();
+
+    /// Adds the specified data to the hash.
+    ///
+    /// \param  data    Pointer to the data.
+    /// \param  size    The size of the data in bytes.
+    void Update(const void* data, std::size_t size);
+
+    /// Gets the hash of the data added so far. The state is not modified, so more data can be added afterwards.
+    ///
+    /// \returns    The hash.
+    [[nodiscard]] std::uint64_t GetDigest() const;
+
+    /// Calculates the hash of the specified data.
+    ///
+    /// \param  data    Pointer to the data.
+    /// \param  size    The size of the data in bytes.
+    /// \param  seed    The seed of the hash.
+    ///
+    /// \returns    The hash.
+    static std::uint64_t Calculate(const void* data, std::size_t size, std::uint64_t seed = 0);
+private:
+    void ProcessStripe(const std::uint8_t* stripe);
+};
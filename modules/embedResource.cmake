@@ -0,0 +1,23 @@
+# SPDX-FileCopyrightText: 2023 Carl Zeiss Microscopy GmbH
+#
+# SPDX-License-Identifier: MIT
+
+# Writes the content of the file "resource_file_name" as a C-array named "variable_name" into the
+#  file "source_file_name" (which can then be included in a source file).
+function(embed_resource resource_file_name source_file_name variable_name)
+    file(SIZE ${resource_file_name} file_size)
+    file(READ ${resource_file_name} hex_content HEX)
+    string(REPEAT "[0-9a-f]" 32 column_pattern)
+    string(REGEX REPLACE "(${column_pattern})" "\\1\n" content "${hex_content}")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1, " content "${content}")
+    string(REGEX REPLACE ", $" "" content "${content}")
+    set(array_definition "static const unsigned char ${variable_name}[${file_size}] =\n{\n${content}\n};")
+    set(source "// Auto generated file.\n${array_definition}\n")
+    file(WRITE "${source_file_name}" "${source}")
+endfunction()
+
+# When run in script mode (i.e. "cmake -DRESOURCE_FILE=... -DSOURCE_FILE=... -DVARIABLE_NAME=... -P embedResource.cmake"),
+#  the resource is embedded right away - this allows for embedding files which are generated at build time.
+if (CMAKE_SCRIPT_MODE_FILE AND CMAKE_SCRIPT_MODE_FILE STREQUAL CMAKE_CURRENT_LIST_FILE)
+    embed_resource("${RESOURCE_FILE}" "${SOURCE_FILE}" "${VARIABLE_NAME}")
+endif()